@@ -0,0 +1,238 @@
+/**
+ * \file arc_length.h
+ * \brief Arc length parametrization of a curve.
+ *
+ * The arc length \f$ s(t) = \int_{t_{min}}^t \| c'(u) \| du \f$ is integrated with an adaptive Gauss-Legendre
+ * quadrature, and stored as a piecewise cubic Hermite interpolation of s(t) on the knots of the quadrature, made
+ * monotone with the Fritsch-Carlson conditions so that it can be inverted.
+ */
+
+#ifndef _CLASS_ARC_LENGTH
+#define _CLASS_ARC_LENGTH
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \class arc_length_table.
+/// \brief Table of the arc length of a curve, giving s(t) and its inverse t(s).
+///
+template <typename Time = double, typename Numeric = Time>
+struct arc_length_table {
+  typedef Time time_t;
+  typedef Numeric num_t;
+  typedef Eigen::Matrix<Time, Eigen::Dynamic, 1> vector_time_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+
+  /* Constructors - destructors */
+ public:
+  arc_length_table() {}
+
+  /// \brief Constructor, integrates the norm of the first derivative of curve.
+  /// \param curve : any curve_abc.
+  /// \param prec : precision of the arc length. An interval is split in two while the quadrature of the interval and
+  /// of its halves, or the interpolation of s(t) at its middle, differ by more than prec times its relative length.
+  /// \param max_depth : maximal number of splits of the initial intervals.
+  template <typename Curve>
+  explicit arc_length_table(const Curve& curve, const Numeric prec = 1e-8, const std::size_t max_depth = 20) {
+    if (!(prec > 0)) throw std::invalid_argument("arc_length_table : the precision must be positive");
+    const time_t t_min = curve.min(), t_max = curve.max();
+    if (!(t_max > t_min)) throw std::invalid_argument("arc_length_table : the curve must have a positive duration");
+    const std::size_t initial_intervals = 8;
+    times_.push_back(t_min);
+    lengths_.push_back(0.);
+    slopes_.push_back(curve.derivate(t_min, 1).norm());
+    for (std::size_t i = 0; i < initial_intervals; ++i) {
+      const time_t a = t_min + (t_max - t_min) * (time_t)i / (time_t)initial_intervals;
+      const time_t b =
+          i + 1 == initial_intervals ? t_max : t_min + (t_max - t_min) * (time_t)(i + 1) / (time_t)initial_intervals;
+      integrate(curve, a, b, gauss_legendre(curve, a, b), prec / (t_max - t_min), max_depth);
+    }
+    make_monotone();
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Total length of the curve.
+  num_t length() const {
+    check_if_not_empty();
+    return lengths_.back();
+  }
+
+  /// \brief Arc length at time t, in O(log n) for n knots. t is clamped to the definition interval of the curve.
+  num_t s_of_t(const time_t t) const {
+    check_if_not_empty();
+    return eval(interval_of_time(t), clamp(t, times_.front(), times_.back()));
+  }
+
+  /// \brief Time at which the arc length is s, in O(log n) for n knots. s is clamped to [0, length()].
+  time_t t_of_s(const num_t s) const {
+    check_if_not_empty();
+    return invert(interval_of_length(s), clamp(s, num_t(0), lengths_.back()));
+  }
+
+  /// \brief Arc lengths at the given times. The interval of each time is searched from the interval of the previous
+  /// one, which is O(1) per time when the times are sorted.
+  void s_of_t(const vector_time_t& times, vector_x_t& res) const {
+    check_if_not_empty();
+    res.resize(times.size());
+    std::size_t i = 0;
+    for (long k = 0; k < times.size(); ++k) {
+      const time_t t = clamp(times[k], times_.front(), times_.back());
+      i = walk(times_, i, t);
+      res[k] = eval(i, t);
+    }
+  }
+
+  /// \brief Times of the given arc lengths, see s_of_t(const vector_time_t&, vector_x_t&).
+  void t_of_s(const vector_x_t& lengths, vector_time_t& res) const {
+    check_if_not_empty();
+    res.resize(lengths.size());
+    std::size_t i = 0;
+    for (long k = 0; k < lengths.size(); ++k) {
+      const num_t s = clamp(lengths[k], num_t(0), lengths_.back());
+      i = walk(lengths_, i, s);
+      res[k] = invert(i, s);
+    }
+  }
+
+  /// \brief Times of num_samples points equally spaced along the curve, including its ends.
+  vector_time_t equidistant_times(const std::size_t num_samples) const {
+    if (num_samples < 2) throw std::invalid_argument("arc_length_table : at least two samples are needed");
+    vector_time_t res;
+    t_of_s(vector_x_t::LinSpaced((long)num_samples, 0., length()), res);
+    return res;
+  }
+
+  /// \brief Number of knots of the table.
+  std::size_t size() const { return times_.size(); }
+  const std::vector<time_t>& times() const { return times_; }
+  const std::vector<num_t>& lengths() const { return lengths_; }
+  /*Operations*/
+
+ private:
+  template <typename Curve>
+  static num_t gauss_legendre(const Curve& curve, const time_t a, const time_t b) {
+    static const num_t nodes[5] = {0., -0.5384693101056831, 0.5384693101056831, -0.9061798459386640,
+                                   0.9061798459386640};
+    static const num_t weights[5] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891,
+                                     0.2369268850561891};
+    const time_t half = (b - a) / 2, middle = (a + b) / 2;
+    num_t res = 0.;
+    for (int i = 0; i < 5; ++i) res += weights[i] * curve.derivate(middle + half * nodes[i], 1).norm();
+    return res * half;
+  }
+
+  /// \brief Integrate [a, b], of arc length estimated to whole, and append b to the knots.
+  template <typename Curve>
+  void integrate(const Curve& curve, const time_t a, const time_t b, const num_t whole, const num_t prec,
+                 const std::size_t depth) {
+    const time_t middle = (a + b) / 2;
+    const num_t left = gauss_legendre(curve, a, middle), right = gauss_legendre(curve, middle, b);
+    const num_t s_a = lengths_.back(), slope_a = slopes_.back();
+    const num_t slope_b = curve.derivate(b, 1).norm();
+    // value at the middle of the cubic Hermite interpolation of the interval
+    const num_t interpolated = (2 * s_a + left + right) / 2 + (b - a) * (slope_a - slope_b) / 8;
+    const num_t tol = prec * (b - a);
+    if (depth > 0 && (std::fabs(whole - left - right) > tol || std::fabs(interpolated - s_a - left) > tol)) {
+      integrate(curve, a, middle, left, prec, depth - 1);
+      integrate(curve, middle, b, right, prec, depth - 1);
+      return;
+    }
+    times_.push_back(b);
+    lengths_.push_back(s_a + left + right);
+    slopes_.push_back(slope_b);
+  }
+
+  /// \brief Fritsch-Carlson conditions : the slopes are reduced so that the interpolation is monotone.
+  void make_monotone() {
+    for (std::size_t i = 0; i + 1 < times_.size(); ++i) {
+      const num_t delta = (lengths_[i + 1] - lengths_[i]) / (times_[i + 1] - times_[i]);
+      if (delta <= 0) {
+        slopes_[i] = slopes_[i + 1] = 0.;
+        continue;
+      }
+      const num_t alpha = slopes_[i] / delta, beta = slopes_[i + 1] / delta;
+      const num_t norm = alpha * alpha + beta * beta;
+      if (norm > 9) {
+        const num_t tau = 3 / std::sqrt(norm);
+        slopes_[i] = tau * alpha * delta;
+        slopes_[i + 1] = tau * beta * delta;
+      }
+    }
+  }
+
+  num_t eval(const std::size_t i, const time_t t) const {
+    const time_t h = times_[i + 1] - times_[i];
+    const num_t u = (t - times_[i]) / h, u2 = u * u, u3 = u2 * u;
+    return (2 * u3 - 3 * u2 + 1) * lengths_[i] + (u3 - 2 * u2 + u) * h * slopes_[i] +
+           (3 * u2 - 2 * u3) * lengths_[i + 1] + (u3 - u2) * h * slopes_[i + 1];
+  }
+
+  /// \brief Solve eval(i, t) = s with Newton iterations, safeguarded by bisection.
+  time_t invert(const std::size_t i, const num_t s) const {
+    const num_t s_a = lengths_[i], s_b = lengths_[i + 1];
+    if (s_b <= s_a) return times_[i];
+    const time_t h = times_[i + 1] - times_[i];
+    num_t lo = 0., hi = 1., u = (s - s_a) / (s_b - s_a);
+    for (int iter = 0; iter < 50; ++iter) {
+      const num_t u2 = u * u;
+      const num_t f = eval(i, times_[i] + u * h) - s;
+      if (f > 0)
+        hi = u;
+      else
+        lo = u;
+      const num_t df = (6 * u2 - 6 * u) * (s_a - s_b) + (3 * u2 - 4 * u + 1) * h * slopes_[i] +
+                       (3 * u2 - 2 * u) * h * slopes_[i + 1];
+      num_t next = df > 0 ? u - f / df : (lo + hi) / 2;
+      if (!(next > lo && next < hi)) next = (lo + hi) / 2;
+      if (std::fabs(next - u) <= 1e-15) {
+        u = next;
+        break;
+      }
+      u = next;
+    }
+    return times_[i] + u * h;
+  }
+
+  std::size_t interval_of_time(const time_t t) const { return interval(times_, t); }
+  std::size_t interval_of_length(const num_t s) const { return interval(lengths_, s); }
+
+  /// \brief Index i of the interval [values[i], values[i + 1]] containing v, by binary search.
+  template <typename T>
+  static std::size_t interval(const std::vector<T>& values, const T v) {
+    const std::size_t i = std::upper_bound(values.begin(), values.end(), v) - values.begin();
+    return std::min(std::max(i, std::size_t(1)), values.size() - 1) - 1;
+  }
+
+  /// \brief Index of the interval containing v, searched from the interval i.
+  template <typename T>
+  static std::size_t walk(const std::vector<T>& values, std::size_t i, const T v) {
+    while (i > 0 && v < values[i]) --i;
+    while (i + 2 < values.size() && v >= values[i + 1]) ++i;
+    return i;
+  }
+
+  template <typename T>
+  static T clamp(const T v, const T lo, const T hi) {
+    return std::min(std::max(v, lo), hi);
+  }
+
+  void check_if_not_empty() const {
+    if (times_.size() < 2) throw std::runtime_error("arc_length_table : the table is empty");
+  }
+
+  /*Attributes*/
+  std::vector<time_t> times_;    // knots
+  std::vector<num_t> lengths_;  // arc length at the knots
+  std::vector<num_t> slopes_;   // derivative of the interpolation of the arc length at the knots
+  /*Attributes*/
+};  // End struct arc_length_table
+
+}  // namespace curves
+#endif  //_CLASS_ARC_LENGTH
@@ -83,5 +83,58 @@ std::vector<Bern<Numeric> > makeBernstein(const unsigned int n) {
   }
   return res;
 }
+
+namespace internal {
+template <typename Numeric>
+void push_root(const Numeric t, const Numeric prec, std::vector<Numeric>& roots) {
+  if (roots.empty() || t - roots.back() > prec) roots.push_back(t);
+}
+
+template <typename Numeric>
+void bernstein_roots(std::vector<Numeric>& coeffs, const Numeric t0, const Numeric t1, const Numeric prec,
+                     std::vector<Numeric>& roots) {
+  bool positive = false, negative = false;
+  for (std::size_t i = 0; i < coeffs.size(); ++i) {
+    positive = positive || coeffs[i] > 0;
+    negative = negative || coeffs[i] < 0;
+  }
+  if (!(positive && negative)) {
+    // no sign change, the polynomial can only vanish at the bounds of the interval
+    if (coeffs.front() == 0 && (positive || negative)) push_root(t0, prec, roots);
+    if (coeffs.back() == 0 && (positive || negative)) push_root(t1, prec, roots);
+    return;
+  }
+  if (t1 - t0 <= prec) {
+    push_root((t0 + t1) / 2, prec, roots);
+    return;
+  }
+  // de Casteljau subdivision at the middle : coeffs is replaced by the coefficients of the right half
+  const std::size_t n = coeffs.size();
+  std::vector<Numeric> left(n);
+  for (std::size_t r = 0; r < n; ++r) {
+    left[r] = coeffs[0];
+    for (std::size_t i = 0; i + 1 < n - r; ++i) coeffs[i] = (coeffs[i] + coeffs[i + 1]) / 2;
+  }
+  const Numeric middle = (t0 + t1) / 2;
+  bernstein_roots(left, t0, middle, prec, roots);
+  bernstein_roots(coeffs, middle, t1, prec, roots);
+}
+}  // namespace internal
+
+/// \brief Find the roots in \f$[0,1]\f$ of the polynomial \f$ \sum_i c_i B_i^n(u) \f$, by recursive subdivision :
+/// the sub-intervals where the coefficients do not change sign are discarded. Roots of even multiplicity that do not
+/// make the polynomial change sign may be missed.
+/// \param coeffs : coefficients \f$ c_i \f$ of the polynomial in the Bernstein basis.
+/// \param prec : precision of the roots.
+/// \param roots : output, the roots are appended in increasing order.
+///
+template <typename Numeric>
+void bernstein_roots(std::vector<Numeric> coeffs, const Numeric prec, std::vector<Numeric>& roots) {
+  if (!(prec > 0)) throw std::invalid_argument("bernstein_roots : the precision must be positive");
+  if (coeffs.empty()) return;
+  std::vector<Numeric> found;
+  internal::bernstein_roots(coeffs, Numeric(0), Numeric(1), prec, found);
+  roots.insert(roots.end(), found.begin(), found.end());
+}
 }  // namespace curves
 #endif  //_CLASS_BERNSTEIN
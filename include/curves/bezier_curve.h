@@ -11,6 +11,7 @@
 
 #include "curve_abc.h"
 #include "bernstein.h"
+#include "bounding_box.h"
 #include "curve_constraint.h"
 #include "piecewise_curve.h"
 
@@ -22,6 +23,13 @@
 #include <iostream>
 
 namespace curves {
+/// \brief res = a * x + b * y. The point types for which this expression creates temporaries (e.g. linear_variable)
+/// overload this function to evaluate it in a single pass into res. res may be one of x or y.
+template <typename Point, typename Numeric>
+inline void linear_combination(Point& res, const Numeric a, const Point& x, const Numeric b, const Point& y) {
+  res = a * x + b * y;
+}
+
 /// \class BezierCurve.
 /// \brief Represents a Bezier curve of arbitrary dimension and order.
 /// For degree lesser than 4, the evaluation is analitycal. Otherwise
@@ -43,12 +51,13 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
   typedef piecewise_curve<Time, Numeric, Safe, point_t, point_t, bezier_curve_t> piecewise_curve_t;
   typedef curve_abc<Time, Numeric, Safe, point_t> curve_abc_t;  // parent class
   typedef typename curve_abc_t::curve_ptr_t curve_ptr_t;
+  typedef bounding_box<Numeric> bounding_box_t;
 
   /* Constructors - destructors */
  public:
   /// \brief Empty constructor. Curve obtained this way can not perform other class functions.
   ///
-  bezier_curve() : dim_(0), T_min_(0), T_max_(0) {}
+  bezier_curve() : dim_(0), T_min_(0), T_max_(0), bounds_valid_(false) {}
 
   /// \brief Constructor.
   /// Given the first and last point of a control points set, create the bezier curve.
@@ -65,7 +74,8 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
         mult_T_(mult_T),
         size_(std::distance(PointsBegin, PointsEnd)),
         degree_(size_ - 1),
-        bernstein_(curves::makeBernstein<num_t>((unsigned int)degree_)) {
+        bernstein_(curves::makeBernstein<num_t>((unsigned int)degree_)),
+        bounds_valid_(false) {
     if (bernstein_.size() != size_) {
       throw std::invalid_argument("Invalid size of polynomial");
     }
@@ -97,7 +107,8 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
         mult_T_(mult_T),
         size_(std::distance(PointsBegin, PointsEnd) + 4),
         degree_(size_ - 1),
-        bernstein_(curves::makeBernstein<num_t>((unsigned int)degree_)) {
+        bernstein_(curves::makeBernstein<num_t>((unsigned int)degree_)),
+        bounds_valid_(false) {
     if (Safe && (size_ < 1 || T_max_ <= T_min_)) {
       throw std::invalid_argument("can't create bezier min bound is higher than max bound");
     }
@@ -119,7 +130,9 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
         size_(other.size_),
         degree_(other.degree_),
         bernstein_(other.bernstein_),
-        control_points_(other.control_points_) {}
+        control_points_(other.control_points_),
+        bounds_(other.bounds_),
+        bounds_valid_(other.bounds_valid_) {}
 
   ///\brief Destructor
   ~bezier_curve() {
@@ -184,8 +197,10 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
       return *this;
     }
     t_point_t derived_wp;
+    derived_wp.reserve(size_);
     for (typename t_point_t::const_iterator pit = control_points_.begin(); pit != control_points_.end() - 1; ++pit) {
-      derived_wp.push_back((num_t)degree_ * (*(pit + 1) - (*pit)));
+      derived_wp.push_back(point_t());
+      linear_combination(derived_wp.back(), (num_t)degree_, *(pit + 1), -(num_t)degree_, *pit);
     }
     if (derived_wp.empty()) {
       derived_wp.push_back(point_t::Zero(dim_));
@@ -303,7 +318,7 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
     const Numeric u = (t - T_min_) / (T_max_ - T_min_);
     t_point_t pts = deCasteljauReduction(waypoints(), u);
     while (pts.size() > 1) {
-      pts = deCasteljauReduction(pts, u);
+      deCasteljauReductionInPlace(pts, u);
     }
     return pts[0] * mult_T_;
   }
@@ -331,12 +346,33 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
     }
 
     t_point_t new_pts;
+    new_pts.reserve(pts.size() - 1);
     for (cit_point_t cit = pts.begin(); cit != (pts.end() - 1); ++cit) {
-      new_pts.push_back((1 - u) * (*cit) + u * (*(cit + 1)));
+      new_pts.push_back(point_t());
+      linear_combination(new_pts.back(), (Numeric)(1 - u), *cit, u, *(cit + 1));
     }
     return new_pts;
   }
 
+  /// \brief Compute de Casteljau's reduction of the given list of points at time t, in place.
+  /// Same as deCasteljauReduction, but the points of pts are overwritten and its last element removed,
+  /// so that no new list or point is allocated.
+  /// \param pts : list of points, replaced by the reduced list.
+  /// \param u   : NORMALIZED time when to evaluate the curve.
+  ///
+  void deCasteljauReductionInPlace(t_point_t& pts, const Numeric u) const {
+    if (u < 0 || u > 1) {
+      throw std::out_of_range("In deCasteljau reduction : u is not in [0;1]");
+    }
+    if (pts.size() <= 1) {
+      return;
+    }
+    for (typename t_point_t::iterator it = pts.begin(); it != (pts.end() - 1); ++it) {
+      linear_combination(*it, (Numeric)(1 - u), *it, u, *(it + 1));
+    }
+    pts.pop_back();
+  }
+
   /// \brief Split the bezier curve in 2 at time t.
   /// \param t : list of points.
   /// \param u : unNormalized time.
@@ -354,7 +390,7 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
     wps_second[degree_] = casteljau_pts.back();
     size_t id = 1;
     while (casteljau_pts.size() > 1) {
-      casteljau_pts = deCasteljauReduction(casteljau_pts, u);
+      deCasteljauReductionInPlace(casteljau_pts, u);
       wps_first[id] = casteljau_pts.front();
       wps_second[degree_ - id] = casteljau_pts.back();
       ++id;
@@ -412,6 +448,66 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
     return c_split.second.split(t2).first;
   }
 
+  /// \brief Axis aligned bounding box of the control points, which contains the curve (convex hull property).
+  /// It is computed at the first call and cached : the first call is not thread safe, and the control points
+  /// must only be modified afterwards with set_control_point.
+  /// \return a box containing the curve.
+  ///
+  const bounding_box_t& bounds() const {
+    if (!bounds_valid_) {
+      check_conditions();
+      bounding_box_t box;
+      for (cit_point_t cit = control_points_.begin(); cit != control_points_.end(); ++cit)
+        box.extend(mult_T_ * (*cit));
+      bounds_ = box;
+      bounds_valid_ = true;
+    }
+    return bounds_;
+  }
+
+  /// \brief Smallest axis aligned bounding box of the curve. Along each axis, the extrema of the curve are reached at
+  /// its ends or at the roots of its derivative, found with bernstein_roots.
+  /// \param prec : precision of the roots of the derivative, in normalized time.
+  /// \return the box containing the curve.
+  ///
+  bounding_box_t tight_bounds(const Numeric prec = 1e-10) const {
+    check_conditions();
+    bounding_box_t box;
+    box.extend((*this)(T_min_));
+    box.extend((*this)(T_max_));
+    if (degree_ < 2) return box;
+    std::vector<Numeric> coeffs(degree_), roots;
+    for (std::size_t d = 0; d < dim_; ++d) {
+      for (std::size_t i = 0; i < degree_; ++i) coeffs[i] = control_points_[i + 1][d] - control_points_[i][d];
+      roots.clear();
+      bernstein_roots(coeffs, prec, roots);
+      for (std::size_t i = 0; i < roots.size(); ++i)
+        box.extend((*this)(std::min(T_max_, T_min_ + roots[i] * (T_max_ - T_min_))));
+    }
+    return box;
+  }
+
+  /// \brief Set the control point of index index without rebuilding the curve. The bounding box cached by bounds()
+  /// is extended to the new point if the previous point was strictly inside it, and computed again at the next call
+  /// of bounds() otherwise.
+  /// \param index : index of the control point.
+  /// \param point : new value of the control point, of the dimension of the curve.
+  ///
+  void set_control_point(const std::size_t index, const point_t& point) {
+    check_conditions();
+    if (index >= size_) throw std::out_of_range("set_control_point : index greater than the number of points");
+    if ((std::size_t)point.size() != dim_)
+      throw std::invalid_argument("set_control_point : the point does not have the dimension of the curve");
+    if (bounds_valid_) {
+      const point_t previous = mult_T_ * control_points_[index];
+      if ((previous.array() > bounds_.min_.array()).all() && (previous.array() < bounds_.max_.array()).all())
+        bounds_.extend(mult_T_ * point);
+      else
+        bounds_valid_ = false;
+    }
+    control_points_[index] = point;
+  }
+
  private:
   template <typename In>
   t_point_t add_constraints(In PointsBegin, In PointsEnd, const curve_constraints_t& constraints) {
@@ -477,6 +573,12 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
   /*const*/ std::vector<Bern<Numeric> > bernstein_;
   /*const*/ t_point_t control_points_;
   static const double MARGIN;
+
+ private:
+  mutable bounding_box_t bounds_;
+  mutable bool bounds_valid_;
+
+ public:
   /* Attributes */
 
   static bezier_curve_t zero(const std::size_t dim, const time_t T = 1.) {
@@ -502,6 +604,7 @@ struct bezier_curve : public curve_abc<Time, Numeric, Safe, Point> {
     ar& boost::serialization::make_nvp("degree", degree_);
     ar& boost::serialization::make_nvp("bernstein", bernstein_);
     ar& boost::serialization::make_nvp("control_points", control_points_);
+    bounds_valid_ = false;
   }
 };  // End struct bezier_curve
 
@@ -0,0 +1,102 @@
+/**
+ * \file bounding_box.h
+ * \brief Axis aligned bounding box of arbitrary dimension.
+ */
+
+#ifndef _CLASS_BOUNDING_BOX
+#define _CLASS_BOUNDING_BOX
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace curves {
+/// \class bounding_box.
+/// \brief Axis aligned box \f$ \{ x, min \leq x \leq max \} \f$. A box of min > max along one axis is empty.
+///
+template <typename Numeric = double>
+struct bounding_box {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Ref<const vector_x_t> vector_x_ref_t;
+  typedef bounding_box<Numeric> bounding_box_t;
+
+  /* Constructors - destructors */
+ public:
+  bounding_box() {}
+
+  /// \brief Empty box of dimension dim.
+  explicit bounding_box(const std::size_t dim)
+      : min_(vector_x_t::Constant(dim, std::numeric_limits<Numeric>::infinity())),
+        max_(vector_x_t::Constant(dim, -std::numeric_limits<Numeric>::infinity())) {}
+
+  bounding_box(const vector_x_t& min, const vector_x_t& max) : min_(min), max_(max) {
+    if (min_.size() != max_.size()) throw std::invalid_argument("bounding_box : the bounds do not have the same size");
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  std::size_t dim() const { return (std::size_t)min_.size(); }
+
+  bool empty() const { return min_.size() == 0 || (min_.array() > max_.array()).any(); }
+
+  /// \brief Grow the box so that it contains pt.
+  void extend(const vector_x_ref_t& pt) {
+    if (min_.size() == 0) *this = bounding_box_t(pt.size());
+    min_ = min_.cwiseMin(pt);
+    max_ = max_.cwiseMax(pt);
+  }
+
+  /// \brief Grow the box so that it contains other.
+  void extend(const bounding_box_t& other) {
+    if (other.empty()) return;
+    if (min_.size() == 0) {
+      *this = other;
+      return;
+    }
+    min_ = min_.cwiseMin(other.min_);
+    max_ = max_.cwiseMax(other.max_);
+  }
+
+  bool contains(const vector_x_ref_t& pt, const Numeric prec = 0.) const {
+    return !empty() && (pt.array() >= min_.array() - prec).all() && (pt.array() <= max_.array() + prec).all();
+  }
+
+  /// \brief Check if other is included in the box.
+  bool contains(const bounding_box_t& other, const Numeric prec = 0.) const {
+    return other.empty() || (!empty() && (other.min_.array() >= min_.array() - prec).all() &&
+                             (other.max_.array() <= max_.array() + prec).all());
+  }
+
+  bool intersects(const bounding_box_t& other) const {
+    return !empty() && !other.empty() && (other.min_.array() <= max_.array()).all() &&
+           (other.max_.array() >= min_.array()).all();
+  }
+
+  /// \brief Squared distance between pt and the closest point of the box, 0 if pt is inside the box.
+  Numeric squared_distance(const vector_x_ref_t& pt) const {
+    if (empty()) return std::numeric_limits<Numeric>::infinity();
+    return (min_ - pt).cwiseMax(pt - max_).cwiseMax(Numeric(0)).squaredNorm();
+  }
+
+  /// \brief Squared distance between pt and the farthest point of the box.
+  Numeric squared_max_distance(const vector_x_ref_t& pt) const {
+    if (empty()) return std::numeric_limits<Numeric>::infinity();
+    return (min_ - pt).cwiseAbs().cwiseMax((max_ - pt).cwiseAbs()).squaredNorm();
+  }
+
+  bool isApprox(const bounding_box_t& other, const Numeric prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    return dim() == other.dim() && (min_ - other.min_).isZero(prec) && (max_ - other.max_).isZero(prec);
+  }
+  /*Operations*/
+
+  /*Attributes*/
+  vector_x_t min_;
+  vector_x_t max_;
+  /*Attributes*/
+};  // End struct bounding_box
+
+}  // namespace curves
+#endif  //_CLASS_BOUNDING_BOX
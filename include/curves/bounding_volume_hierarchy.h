@@ -0,0 +1,167 @@
+/**
+ * \file bounding_volume_hierarchy.h
+ * \brief Hierarchy of bounding boxes over the segments of a piecewise bezier curve.
+ *
+ * Each leaf of the tree bounds one segment, each node bounds a contiguous range of segments, so that the
+ * queries on the whole curve (does it leave a box, which segments are close to a point) only evaluate the segments
+ * whose bounds can not be used to answer.
+ */
+
+#ifndef _CLASS_BOUNDING_VOLUME_HIERARCHY
+#define _CLASS_BOUNDING_VOLUME_HIERARCHY
+
+#include "bounding_box.h"
+
+#include <boost/smart_ptr/shared_ptr.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \class bounding_volume_hierarchy.
+/// \brief Binary tree of the bounding boxes of the segments of a piecewise curve, the segments being bezier curves of
+/// type Bezier.
+///
+template <typename Bezier>
+struct bounding_volume_hierarchy {
+  typedef Bezier bezier_t;
+  typedef boost::shared_ptr<bezier_t> bezier_ptr_t;
+  typedef typename bezier_t::num_t num_t;
+  typedef typename bezier_t::time_t time_t;
+  typedef typename bezier_t::bounding_box_t bounding_box_t;
+  typedef typename bounding_box_t::vector_x_ref_t vector_x_ref_t;
+
+  /// \brief Node of the tree, bounding the segments [begin, end[. The node is a leaf if end = begin + 1.
+  struct node_t {
+    bounding_box_t box;
+    std::size_t begin, end;
+    std::size_t left, right;
+    bool is_leaf() const { return end == begin + 1; }
+  };
+
+  /* Constructors - destructors */
+ public:
+  bounding_volume_hierarchy() {}
+
+  /// \brief Constructor.
+  /// \param curve : piecewise curve of which all the segments are of type Bezier,
+  /// see piecewise_curve::convert_piecewise_curve_to_bezier for the other curves.
+  /// \param tight : if true, the leaves bound the segments with bezier_curve::tight_bounds instead of the bounds of
+  /// their control points.
+  template <typename Piecewise>
+  explicit bounding_volume_hierarchy(const Piecewise& curve, const bool tight = false) {
+    for (std::size_t i = 0; i < curve.num_curves(); ++i) {
+      bezier_ptr_t segment = boost::dynamic_pointer_cast<bezier_t>(curve.curve_at_index(i));
+      if (!segment) {
+        throw std::invalid_argument("bounding_volume_hierarchy : all the segments of the curve must be bezier curves");
+      }
+      segments_.push_back(segment);
+    }
+    if (segments_.empty()) throw std::invalid_argument("bounding_volume_hierarchy : the curve is empty");
+    nodes_.reserve(2 * segments_.size() - 1);
+    build(0, segments_.size(), tight);
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Box containing the whole curve.
+  const bounding_box_t& bounds() const {
+    check_if_not_empty();
+    return nodes_.front().box;
+  }
+
+  /// \brief Check if the curve stays inside box. The segments are only evaluated when their bounds intersect the
+  /// border of box.
+  /// \param box : the box.
+  /// \param prec : precision of the extrema of the segments, see bezier_curve::tight_bounds.
+  /// \return true if the whole curve is inside box.
+  bool is_inside(const bounding_box_t& box, const num_t prec = 1e-10) const {
+    check_if_not_empty();
+    return is_inside(0, box, prec);
+  }
+
+  /// \brief Indices of the segments whose bounds intersect box, in increasing order.
+  void segments_intersecting(const bounding_box_t& box, std::vector<std::size_t>& segments) const {
+    check_if_not_empty();
+    segments.clear();
+    segments_intersecting(0, box, segments);
+  }
+
+  /// \brief Indices of the segments whose bounds are at a distance lower than distance of pt, in increasing order.
+  void segments_near(const vector_x_ref_t& pt, const num_t distance, std::vector<std::size_t>& segments) const {
+    check_if_not_empty();
+    segments.clear();
+    segments_near(0, pt, distance * distance, segments);
+  }
+
+  std::size_t num_segments() const { return segments_.size(); }
+  const bezier_ptr_t& segment(const std::size_t i) const { return segments_.at(i); }
+  const std::vector<node_t>& nodes() const { return nodes_; }
+  /*Operations*/
+
+ private:
+  std::size_t build(const std::size_t begin, const std::size_t end, const bool tight) {
+    const std::size_t id = nodes_.size();
+    nodes_.push_back(node_t());
+    nodes_[id].begin = begin;
+    nodes_[id].end = end;
+    if (end == begin + 1) {
+      nodes_[id].left = nodes_[id].right = id;
+      nodes_[id].box = tight ? segments_[begin]->tight_bounds() : segments_[begin]->bounds();
+    } else {
+      const std::size_t middle = begin + (end - begin) / 2;
+      const std::size_t left = build(begin, middle, tight);
+      const std::size_t right = build(middle, end, tight);
+      nodes_[id].left = left;
+      nodes_[id].right = right;
+      nodes_[id].box = nodes_[left].box;
+      nodes_[id].box.extend(nodes_[right].box);
+    }
+    return id;
+  }
+
+  bool is_inside(const std::size_t id, const bounding_box_t& box, const num_t prec) const {
+    const node_t& node = nodes_[id];
+    if (box.contains(node.box)) return true;
+    if (!box.intersects(node.box)) return false;
+    if (node.is_leaf()) return box.contains(segments_[node.begin]->tight_bounds(prec));
+    return is_inside(node.left, box, prec) && is_inside(node.right, box, prec);
+  }
+
+  void segments_intersecting(const std::size_t id, const bounding_box_t& box,
+                             std::vector<std::size_t>& segments) const {
+    const node_t& node = nodes_[id];
+    if (!box.intersects(node.box)) return;
+    if (node.is_leaf()) {
+      segments.push_back(node.begin);
+      return;
+    }
+    segments_intersecting(node.left, box, segments);
+    segments_intersecting(node.right, box, segments);
+  }
+
+  void segments_near(const std::size_t id, const vector_x_ref_t& pt, const num_t squared_distance,
+                     std::vector<std::size_t>& segments) const {
+    const node_t& node = nodes_[id];
+    if (node.box.squared_distance(pt) > squared_distance) return;
+    if (node.is_leaf()) {
+      segments.push_back(node.begin);
+      return;
+    }
+    segments_near(node.left, pt, squared_distance, segments);
+    segments_near(node.right, pt, squared_distance, segments);
+  }
+
+  void check_if_not_empty() const {
+    if (nodes_.empty()) throw std::runtime_error("bounding_volume_hierarchy : no curve added");
+  }
+
+  /*Attributes*/
+  std::vector<bezier_ptr_t> segments_;
+  std::vector<node_t> nodes_;  // the root is nodes_[0]
+  /*Attributes*/
+};  // End struct bounding_volume_hierarchy
+
+}  // namespace curves
+#endif  //_CLASS_BOUNDING_VOLUME_HIERARCHY
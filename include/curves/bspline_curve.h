@@ -0,0 +1,392 @@
+/**
+ * \file bspline_curve.h
+ * \brief B-spline curve of arbitrary degree, with uniform or non-uniform knots.
+ *
+ * A curve of degree p with the control points \f$ P_0, ..., P_{n-1} \f$ and the knots \f$ t_0 \leq ... \leq t_{n+p} \f$
+ * is defined on \f$ [t_p, t_n] \f$, the point at a time of the span \f$ [t_k, t_{k+1}[ \f$ only depending on the
+ * control points \f$ P_{k-p}, ..., P_k \f$. It is evaluated with the de Boor algorithm, or, when the knots are
+ * equally spaced, with a basis matrix computed once that gives the coefficients of the p + 1 control points as a
+ * polynomial of the local time of the span.
+ */
+
+#ifndef _CLASS_BSPLINE_CURVE
+#define _CLASS_BSPLINE_CURVE
+
+#include "curve_abc.h"
+#include "bezier_curve.h"
+#include "piecewise_curve.h"
+
+#include "MathDefs.h"
+
+#include <Eigen/LU>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \class bspline_curve.
+/// \brief B-spline curve of arbitrary dimension and degree.
+///
+template <typename Time = double, typename Numeric = Time, bool Safe = false,
+          typename Point = Eigen::Matrix<Numeric, Eigen::Dynamic, 1> >
+struct bspline_curve : public curve_abc<Time, Numeric, Safe, Point> {
+  typedef Point point_t;
+  typedef Time time_t;
+  typedef Numeric num_t;
+  typedef std::vector<point_t, Eigen::aligned_allocator<point_t> > t_point_t;
+  typedef std::vector<time_t> t_time_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef bspline_curve<Time, Numeric, Safe, Point> bspline_curve_t;
+  typedef bezier_curve<Time, Numeric, Safe, Point> bezier_curve_t;
+  typedef typename bezier_curve_t::piecewise_curve_t piecewise_bezier_t;
+  typedef curve_abc<Time, Numeric, Safe, point_t> curve_abc_t;  // parent class
+
+  /* Constructors - destructors */
+ public:
+  /// \brief Empty constructor. Curve obtained this way can not perform other class functions.
+  ///
+  bspline_curve() : dim_(0), degree_(0), T_min_(0), T_max_(0), uniform_(false) {}
+
+  /// \brief Constructor with non-uniform knots.
+  /// \param PointsBegin   : an iterator pointing to the first element of a control point container.
+  /// \param PointsEnd     : an iterator pointing to the last element of a control point container.
+  /// \param knots         : non decreasing knots, their number must be the number of control points plus degree + 1.
+  /// \param degree        : degree of the curve.
+  ///
+  template <typename In>
+  bspline_curve(In PointsBegin, In PointsEnd, const t_time_t& knots, const std::size_t degree)
+      : degree_(degree), control_points_(PointsBegin, PointsEnd), knots_(knots) {
+    init();
+  }
+
+  /// \brief Constructor with uniform knots, the curve being defined between T_min and T_max.
+  /// The curve does not interpolate its first and last control points, see clamped for this.
+  /// \param PointsBegin   : an iterator pointing to the first element of a control point container.
+  /// \param PointsEnd     : an iterator pointing to the last element of a control point container.
+  /// \param degree        : degree of the curve, lower than the number of control points.
+  /// \param T_min, T_max  : time range of the curve.
+  ///
+  template <typename In>
+  bspline_curve(In PointsBegin, In PointsEnd, const std::size_t degree, const time_t T_min = 0.,
+                const time_t T_max = 1.)
+      : degree_(degree), control_points_(PointsBegin, PointsEnd) {
+    const std::size_t n = control_points_.size();
+    if (n <= degree) throw std::invalid_argument("bspline_curve : the degree must be lower than the number of points");
+    const time_t step = (T_max - T_min) / (time_t)(n - degree);
+    for (std::size_t j = 0; j < n + degree + 1; ++j) knots_.push_back(T_min + ((time_t)j - (time_t)degree) * step);
+    knots_[degree] = T_min;
+    knots_[n] = T_max;
+    init();
+  }
+
+  /// \brief Curve with uniform knots inside its time range, and knots of multiplicity degree + 1 at its ends, so that
+  /// it interpolates its first and last control points.
+  ///
+  template <typename In>
+  static bspline_curve_t clamped(In PointsBegin, In PointsEnd, const std::size_t degree, const time_t T_min = 0.,
+                                 const time_t T_max = 1.) {
+    const std::size_t n = std::distance(PointsBegin, PointsEnd);
+    if (n <= degree) throw std::invalid_argument("bspline_curve : the degree must be lower than the number of points");
+    t_time_t knots(degree + 1, T_min);
+    for (std::size_t j = 1; j < n - degree; ++j)
+      knots.push_back(T_min + (T_max - T_min) * (time_t)j / (time_t)(n - degree));
+    knots.insert(knots.end(), degree + 1, T_max);
+    return bspline_curve_t(PointsBegin, PointsEnd, knots, degree);
+  }
+
+  ///\brief Destructor
+  ~bspline_curve() {}
+  /* Constructors - destructors */
+
+  /*Operations*/
+  ///  \brief Evaluation of the curve at time t.
+  ///  \param t : time when to evaluate the curve.
+  ///  \return \f$x(t)\f$ point corresponding on curve at time t.
+  virtual point_t operator()(const time_t t) const { return derivate(t, 0); }
+
+  ///  \brief Evaluate the derivative of order N of curve at time t.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param order : order of derivative.
+  ///  \return \f$\frac{d^Nx(t)}{dt^N}\f$ point corresponding on derivative curve of order N at time t.
+  virtual point_t derivate(const time_t t, const std::size_t order) const {
+    check_conditions();
+    if (Safe && !(T_min_ <= t && t <= T_max_))
+      throw std::invalid_argument("can't evaluate bspline curve, time t is out of range");
+    if (order > degree_) return point_t::Zero(dim_);
+    const std::size_t k = find_span(t);
+    if (uniform_) return eval_uniform(k, t, order);
+    return eval_de_boor(k, t, order);
+  }
+
+  /// \brief Compute the derived curve at order N, a bspline curve of degree reduced by N.
+  ///  \param order : order of derivative.
+  ///  \return \f$\frac{d^Nx(t)}{dt^N}\f$ derivative order N of the curve.
+  bspline_curve_t compute_derivate(const std::size_t order) const {
+    check_conditions();
+    if (order == 0) return *this;
+    if (degree_ == 0) {
+      const t_point_t zeros(control_points_.size(), point_t::Zero(dim_));
+      return bspline_curve_t(zeros.begin(), zeros.end(), knots_, 0);
+    }
+    t_point_t derived;
+    for (std::size_t i = 0; i + 1 < control_points_.size(); ++i) {
+      // a knot of multiplicity degree + 1 makes the curve discontinuous, the derivative is 0 at this knot
+      const time_t duration = knots_[i + degree_ + 1] - knots_[i + 1];
+      derived.push_back(duration > 0 ? point_t((control_points_[i + 1] - control_points_[i]) * (degree_ / duration))
+                                     : point_t(point_t::Zero(dim_)));
+    }
+    const t_time_t knots(knots_.begin() + 1, knots_.end() - 1);
+    return bspline_curve_t(derived.begin(), derived.end(), knots, degree_ - 1).compute_derivate(order - 1);
+  }
+
+  ///  \brief Compute the derived curve at order N.
+  ///  \param order : order of derivative.
+  ///  \return A pointer to \f$\frac{d^Nx(t)}{dt^N}\f$ derivative order N of the curve.
+  bspline_curve_t* compute_derivate_ptr(const std::size_t order) const {
+    return new bspline_curve_t(compute_derivate(order));
+  }
+
+  /// \brief Insert the knot t with Boehm's algorithm, adding one control point without changing the curve.
+  /// Only the control points \f$ P_{k-p}, ..., P_k \f$ of the span of t are modified.
+  /// \param t : the knot, in \f$[T_{min}, T_{max}]\f$.
+  ///
+  void insert_knot(const time_t t) {
+    check_conditions();
+    if (t < T_min_ || t > T_max_) throw std::invalid_argument("bspline_curve : the knot is out of the time range");
+    const std::size_t p = degree_;
+    // span [t_k, t_k+1] of t, the new knot is inserted after t_k
+    const std::size_t k = std::min((std::size_t)(std::upper_bound(knots_.begin(), knots_.end(), t) - knots_.begin()),
+                                   control_points_.size()) - 1;
+    if (p == 0) {
+      control_points_.insert(control_points_.begin() + k + 1, point_t(control_points_[k]));
+      knots_.insert(knots_.begin() + k + 1, t);
+      init();
+      return;
+    }
+    t_point_t updated;
+    for (std::size_t i = k + 1 - p; i <= k; ++i) {
+      const num_t alpha = (t - knots_[i]) / (knots_[i + p] - knots_[i]);
+      updated.push_back((1 - alpha) * control_points_[i - 1] + alpha * control_points_[i]);
+    }
+    // the points k - p + 1, ..., k - 1 are replaced by the p new points
+    control_points_.erase(control_points_.begin() + (k + 1 - p), control_points_.begin() + k);
+    control_points_.insert(control_points_.begin() + (k + 1 - p), updated.begin(), updated.end());
+    knots_.insert(knots_.begin() + k + 1, t);
+    init();
+  }
+
+  /// \brief Convert the curve in a piecewise curve of bezier curves, one per non empty span, by inserting each knot
+  /// of the time range until its multiplicity is the degree.
+  /// \return the equivalent piecewise bezier curve.
+  ///
+  piecewise_bezier_t convert_to_piecewise_bezier() const {
+    check_conditions();
+    bspline_curve_t refined(*this);
+    const std::size_t p = degree_;
+    t_time_t values;
+    for (std::size_t j = p; j <= control_points_.size(); ++j) {
+      if (values.empty() || knots_[j] > values.back()) values.push_back(knots_[j]);
+    }
+    for (std::size_t v = 0; v < values.size(); ++v) {
+      std::size_t multiplicity = std::count(refined.knots_.begin(), refined.knots_.end(), values[v]);
+      for (; multiplicity < p; ++multiplicity) refined.insert_knot(values[v]);
+    }
+    piecewise_bezier_t res;
+    for (std::size_t k = p; k < refined.control_points_.size(); ++k) {
+      if (!(refined.knots_[k + 1] > refined.knots_[k])) continue;
+      res.add_curve(bezier_curve_t(refined.control_points_.begin() + (k - p), refined.control_points_.begin() + k + 1,
+                                   refined.knots_[k], refined.knots_[k + 1]));
+    }
+    return res;
+  }
+
+  /**
+   * @brief isApprox check if other and *this are approximately equals.
+   * Only two curves of the same class can be approximately equals, for comparison between different type of curves see
+   * isEquivalent
+   * @param other the other curve to check
+   * @param prec the precision treshold, default Eigen::NumTraits<Numeric>::dummy_precision()
+   * @return true is the two curves are approximately equals
+   */
+  bool isApprox(const bspline_curve_t& other, const Numeric prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    if (dim_ != other.dim_ || degree_ != other.degree_ || control_points_.size() != other.control_points_.size())
+      return false;
+    for (std::size_t j = 0; j < knots_.size(); ++j) {
+      if (!curves::isApprox<num_t>(knots_[j], other.knots_[j])) return false;
+    }
+    for (std::size_t i = 0; i < control_points_.size(); ++i) {
+      if (!control_points_[i].isApprox(other.control_points_[i], prec)) return false;
+    }
+    return true;
+  }
+
+  virtual bool isApprox(const curve_abc_t* other,
+                        const Numeric prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    const bspline_curve_t* other_cast = dynamic_cast<const bspline_curve_t*>(other);
+    if (other_cast)
+      return isApprox(*other_cast, prec);
+    else
+      return false;
+  }
+
+  virtual bool operator==(const bspline_curve_t& other) const { return isApprox(other); }
+
+  virtual bool operator!=(const bspline_curve_t& other) const { return !(*this == other); }
+
+  const t_point_t& control_points() const { return control_points_; }
+  const t_time_t& knots() const { return knots_; }
+  /// \brief True if the knots are equally spaced, the curve then being evaluated with the basis matrix.
+  bool is_uniform() const { return uniform_; }
+  /*Operations*/
+
+  /*Helpers*/
+  /// \brief Get dimension of curve.
+  /// \return dimension of curve.
+  std::size_t virtual dim() const { return dim_; };
+  /// \brief Get the minimum time for which the curve is defined
+  /// \return \f$t_{min}\f$, lower bound of time range.
+  virtual time_t min() const { return T_min_; }
+  /// \brief Get the maximum time for which the curve is defined.
+  /// \return \f$t_{max}\f$, upper bound of time range.
+  virtual time_t max() const { return T_max_; }
+  /// \brief Get the degree of the curve.
+  /// \return \f$degree\f$, the degree of the curve.
+  virtual std::size_t degree() const { return degree_; }
+  /*Helpers*/
+
+ private:
+  /// \brief Check the knots, and compute the time range and the basis matrix of the uniform knots.
+  void init() {
+    const std::size_t n = control_points_.size(), p = degree_;
+    if (n <= p) throw std::invalid_argument("bspline_curve : the degree must be lower than the number of points");
+    if (knots_.size() != n + p + 1)
+      throw std::invalid_argument("bspline_curve : the number of knots must be the number of points plus degree + 1");
+    for (std::size_t j = 0; j + 1 < knots_.size(); ++j) {
+      if (knots_[j + 1] < knots_[j]) throw std::invalid_argument("bspline_curve : the knots must be non decreasing");
+    }
+    dim_ = control_points_.front().size();
+    T_min_ = knots_[p];
+    T_max_ = knots_[n];
+    if (!(T_max_ > T_min_)) throw std::invalid_argument("bspline_curve : the time range of the curve is empty");
+    const time_t step = knots_[1] - knots_[0];
+    uniform_ = step > 0;
+    for (std::size_t j = 1; uniform_ && j + 1 < knots_.size(); ++j)
+      uniform_ = std::fabs(knots_[j + 1] - knots_[j] - step) <= 1e-12 * (T_max_ - T_min_);
+    if (uniform_) compute_basis_matrix();
+  }
+
+  /// \brief basis_(i, j) is the coefficient of \f$ u^i \f$ in the basis function of the control point j of a span of
+  /// uniform knots, u being the local time of the span in [0, 1]. It is the inverse of the Vandermonde matrix applied
+  /// to the basis functions of the integer knots \f$ 0, ..., 2p + 1 \f$ evaluated at \f$ u = m / p \f$.
+  void compute_basis_matrix() {
+    const std::size_t p = degree_;
+    matrix_x_t values(p + 1, p + 1), vandermonde(p + 1, p + 1);
+    for (std::size_t m = 0; m <= p; ++m) {
+      const num_t u = p > 0 ? (num_t)m / (num_t)p : 0.;
+      for (std::size_t i = 0; i <= p; ++i) vandermonde(m, i) = std::pow(u, (num_t)i);
+      // Cox-de Boor recursion on the integer knots, in the span [p, p + 1[
+      vector_x_t basis = vector_x_t::Zero(2 * p + 1);
+      basis[p] = 1.;
+      const num_t t = (num_t)p + u;
+      for (std::size_t q = 1; q <= p; ++q) {
+        for (std::size_t j = 0; j + q < 2 * p + 1; ++j)
+          basis[j] = (t - (num_t)j) / (num_t)q * basis[j] + ((num_t)(j + q + 1) - t) / (num_t)q * basis[j + 1];
+      }
+      values.row(m) = basis.head(p + 1).transpose();
+    }
+    basis_ = vandermonde.fullPivLu().solve(values);
+  }
+
+  /// \brief Index k of the span \f$ [t_k, t_{k+1}[ \f$ containing t, between degree and the number of points - 1.
+  std::size_t find_span(const time_t t) const {
+    const std::size_t n = control_points_.size();
+    if (uniform_) {
+      const time_t step = knots_[degree_ + 1] - knots_[degree_];
+      const long k = (long)std::floor((t - T_min_) / step) + (long)degree_;
+      return (std::size_t)std::min(std::max(k, (long)degree_), (long)n - 1);
+    }
+    const std::size_t k = std::upper_bound(knots_.begin() + degree_ + 1, knots_.begin() + n, t) - knots_.begin() - 1;
+    return std::min(k, n - 1);
+  }
+
+  point_t eval_uniform(const std::size_t k, const time_t t, const std::size_t order) const {
+    const std::size_t p = degree_;
+    const time_t step = knots_[k + 1] - knots_[k];
+    const num_t u = (t - knots_[k]) / step;
+    // derivative of order order of the powers of u, with respect to t
+    vector_x_t powers = vector_x_t::Zero(p + 1);
+    num_t scale = 1.;
+    for (std::size_t i = 0; i < order; ++i) scale /= step;
+    for (std::size_t i = order; i <= p; ++i) {
+      num_t coef = scale;
+      for (std::size_t j = 0; j < order; ++j) coef *= (num_t)(i - j);
+      powers[i] = coef * std::pow(u, (num_t)(i - order));
+    }
+    const vector_x_t weights = basis_.transpose() * powers;
+    point_t res = weights[0] * control_points_[k - p];
+    for (std::size_t j = 1; j <= p; ++j) res += weights[j] * control_points_[k - p + j];
+    return res;
+  }
+
+  /// \brief de Boor algorithm on the control points of the span k, after order differentiations of these points.
+  point_t eval_de_boor(const std::size_t k, const time_t t, const std::size_t order) const {
+    std::size_t q = degree_, shift = 0, span = k;
+    t_point_t local(control_points_.begin() + (k - q), control_points_.begin() + k + 1);
+    for (std::size_t r = 0; r < order; ++r, --q, ++shift, --span) {
+      // control points of the derivative, whose knots are the knots without the first one
+      for (std::size_t j = 0; j < q; ++j) {
+        const std::size_t i = span - q + j + shift;
+        local[j] = (local[j + 1] - local[j]) * ((num_t)q / (knots_[i + q + 1] - knots_[i + 1]));
+      }
+      local.pop_back();
+    }
+    for (std::size_t r = 1; r <= q; ++r) {
+      for (std::size_t j = q; j >= r; --j) {
+        const time_t a = knots_[j + span - q + shift], b = knots_[j + 1 + span - r + shift];
+        const num_t alpha = (t - a) / (b - a);
+        local[j] = (1 - alpha) * local[j - 1] + alpha * local[j];
+      }
+    }
+    return local[q];
+  }
+
+  void check_conditions() const {
+    if (control_points_.size() == 0)
+      throw std::runtime_error(
+          "Error in bspline curve : there is no control points set / did you use empty constructor ?");
+  }
+
+  /* Attributes */
+  std::size_t dim_;
+  std::size_t degree_;
+  t_point_t control_points_;
+  t_time_t knots_;
+  time_t T_min_;
+  time_t T_max_;
+  bool uniform_;
+  matrix_x_t basis_;  // basis matrix of the uniform knots
+  /* Attributes */
+
+ public:
+  // Serialization of the class
+  friend class boost::serialization::access;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    if (version) {
+      // Do something depending on version ?
+    }
+    ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(curve_abc_t);
+    ar& boost::serialization::make_nvp("dim", dim_);
+    ar& boost::serialization::make_nvp("degree", degree_);
+    ar& boost::serialization::make_nvp("control_points", control_points_);
+    ar& boost::serialization::make_nvp("knots", knots_);
+    if (Archive::is_loading::value) init();
+  }
+};  // End struct bspline_curve
+
+}  // namespace curves
+#endif  //_CLASS_BSPLINE_CURVE
@@ -0,0 +1,210 @@
+/**
+ * \file closest_point.h
+ * \brief Closest point and distance queries between a point and a piecewise bezier curve.
+ *
+ * The segments are visited in the bounding_volume_hierarchy, closest bounds first, and skipped when their bounds are
+ * farther than the best distance found. In each visited segment, the local minima of the distance to a cached
+ * sampling of the segment are refined with Newton iterations on \f$ (c(t) - p) . c'(t) = 0 \f$.
+ * The derivatives of the segments are computed once, so that the queries do not allocate memory when the points
+ * have a fixed size.
+ */
+
+#ifndef _CLASS_CLOSEST_POINT
+#define _CLASS_CLOSEST_POINT
+
+#include "bounding_volume_hierarchy.h"
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \class closest_point_query.
+/// \brief Closest point queries on a piecewise curve of which all the segments are bezier curves of type Bezier.
+///
+template <typename Bezier>
+struct closest_point_query {
+  typedef Bezier bezier_t;
+  typedef typename bezier_t::point_t point_t;
+  typedef typename bezier_t::t_point_t t_point_t;
+  typedef typename bezier_t::time_t time_t;
+  typedef typename bezier_t::num_t num_t;
+  typedef typename bezier_t::piecewise_curve_t piecewise_curve_t;
+  typedef bounding_volume_hierarchy<bezier_t> bounding_volume_hierarchy_t;
+  typedef typename bounding_volume_hierarchy_t::node_t node_t;
+
+  /// \brief Result of a query, the point of the curve at time time is at distance distance of the query point.
+  struct result_t {
+    time_t time;
+    point_t point;
+    num_t distance;
+    std::size_t segment;
+  };
+
+  /* Constructors - destructors */
+ public:
+  /// \brief Constructor.
+  /// \param curve : piecewise curve of which all the segments are of type Bezier.
+  /// \param samples : number of samples per segment used to initialize the Newton iterations.
+  template <typename Piecewise>
+  explicit closest_point_query(const Piecewise& curve, const std::size_t samples = 16) : bvh_(curve) {
+    init(samples);
+  }
+
+  /// \brief Constructor for a single bezier curve.
+  explicit closest_point_query(const bezier_t& curve, const std::size_t samples = 16)
+      : bvh_(piecewise_curve_t(boost::make_shared<bezier_t>(curve))) {
+    init(samples);
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Closest point of the curve to pt.
+  /// \param pt : the query point.
+  /// \param res : output, res.point should already have the dimension of the curve to avoid its allocation.
+  void closest_point(const point_t& pt, result_t& res) const {
+    res.distance = std::numeric_limits<num_t>::infinity();
+    num_t best = std::numeric_limits<num_t>::infinity();
+    visit(0, pt, best, res);
+    res.distance = std::sqrt(best);
+  }
+
+  /// \brief Closest point of the curve to pt in the neighbourhood of the time hint, for tracking a point moving
+  /// along the curve : the Newton iterations start from hint, and the segment of hint and its neighbours are searched.
+  /// The search continues in the next segments while the closest point is on the bounds of the searched segments.
+  /// \param pt : the query point.
+  /// \param hint : initial time, for instance the time of the result of the previous query.
+  /// \param res : output.
+  void closest_point(const point_t& pt, const time_t hint, result_t& res) const {
+    const std::size_t segment =
+        std::upper_bound(times_.begin() + 1, times_.end() - 1, hint) - (times_.begin() + 1);
+    num_t best = std::numeric_limits<num_t>::infinity();
+    refine(segment, std::min(std::max(hint, times_.front()), times_.back()), pt, best, res);
+    std::size_t first = segment > 0 ? segment - 1 : 0;
+    std::size_t last = std::min(segment + 1, bvh_.num_segments() - 1);
+    for (std::size_t i = first; i <= last; ++i) search_segment(i, pt, best, res);
+    while (first > 0 && res.segment == first && res.time <= times_[first]) search_segment(--first, pt, best, res);
+    while (last + 1 < bvh_.num_segments() && res.segment == last && res.time >= times_[last + 1])
+      search_segment(++last, pt, best, res);
+    res.distance = std::sqrt(best);
+  }
+
+  /// \brief Distance between pt and the curve.
+  num_t distance(const point_t& pt) const {
+    result_t res;
+    closest_point(pt, res);
+    return res.distance;
+  }
+
+  const bounding_volume_hierarchy_t& hierarchy() const { return bvh_; }
+  /*Operations*/
+
+ private:
+  void init(const std::size_t samples) {
+    if (samples < 2) throw std::invalid_argument("closest_point_query : at least two samples per segment are needed");
+    samples_ = samples;
+    times_.push_back(bvh_.segment(0)->min());
+    for (std::size_t i = 0; i < bvh_.num_segments(); ++i) {
+      const bezier_t& curve = *bvh_.segment(i);
+      derivative_.push_back(curve.compute_derivate(1));
+      second_derivative_.push_back(derivative_.back().compute_derivate(1));
+      times_.push_back(curve.max());
+      for (std::size_t j = 0; j < samples; ++j) {
+        const time_t t = curve.min() + (curve.max() - curve.min()) * (time_t)j / (time_t)(samples - 1);
+        sample_times_.push_back(t);
+        sample_points_.push_back(curve(t));
+      }
+    }
+  }
+
+  /// \brief Visit the node id, closest child first, if its bounds are closer than the best distance.
+  void visit(const std::size_t id, const point_t& pt, num_t& best, result_t& res) const {
+    const node_t& node = bvh_.nodes()[id];
+    if (node.box.squared_distance(pt) >= best) return;
+    if (node.is_leaf()) {
+      search_segment(node.begin, pt, best, res);
+      return;
+    }
+    const node_t& left = bvh_.nodes()[node.left];
+    const node_t& right = bvh_.nodes()[node.right];
+    if (left.box.squared_distance(pt) <= right.box.squared_distance(pt)) {
+      visit(node.left, pt, best, res);
+      visit(node.right, pt, best, res);
+    } else {
+      visit(node.right, pt, best, res);
+      visit(node.left, pt, best, res);
+    }
+  }
+
+  /// \brief Refine each local minimum of the distance to the samples of the segment.
+  void search_segment(const std::size_t segment, const point_t& pt, num_t& best, result_t& res) const {
+    const std::size_t first = segment * samples_;
+    num_t previous = std::numeric_limits<num_t>::infinity();
+    num_t current = (sample_points_[first] - pt).squaredNorm();
+    for (std::size_t j = 0; j < samples_; ++j) {
+      const num_t next = j + 1 < samples_ ? (sample_points_[first + j + 1] - pt).squaredNorm()
+                                          : std::numeric_limits<num_t>::infinity();
+      if (current <= previous && current <= next) refine(segment, sample_times_[first + j], pt, best, res);
+      previous = current;
+      current = next;
+    }
+  }
+
+  /// \brief Newton iterations on the derivative of the squared distance, the steps that do not decrease the distance
+  /// are halved. res is updated if the distance found is lower than best.
+  /// \return the final time of the iterations.
+  time_t refine(const std::size_t segment, time_t t, const point_t& pt, num_t& best, result_t& res) const {
+    const bezier_t& curve = *bvh_.segment(segment);
+    const bezier_t& d1 = derivative_[segment];
+    const bezier_t& d2 = second_derivative_[segment];
+    const time_t t_min = curve.min(), t_max = curve.max();
+    const time_t prec = (t_max - t_min) * 1e-12;
+    point_t p = curve(t);
+    num_t dist = (p - pt).squaredNorm();
+    for (int iter = 0; iter < 50; ++iter) {
+      const point_t v = d1(t);
+      const num_t f = (p - pt).dot(v);
+      const num_t df = v.squaredNorm() + (p - pt).dot(d2(t));
+      time_t step = df > 0 ? -f / df : (f > 0 ? -1 : 1) * (t_max - t_min) / (time_t)samples_;
+      time_t t_new = std::min(std::max(t + step, t_min), t_max);
+      point_t p_new = curve(t_new);
+      num_t dist_new = (p_new - pt).squaredNorm();
+      while (dist_new > dist && std::fabs(t_new - t) > prec) {
+        t_new = (t + t_new) / 2;
+        p_new = curve(t_new);
+        dist_new = (p_new - pt).squaredNorm();
+      }
+      if (dist_new > dist) break;
+      const bool converged = std::fabs(t_new - t) <= prec;
+      t = t_new;
+      p = p_new;
+      dist = dist_new;
+      if (converged) break;
+    }
+    if (dist < best) {
+      best = dist;
+      res.time = t;
+      res.point = p;
+      res.segment = segment;
+    }
+    return t;
+  }
+
+  /*Attributes*/
+  bounding_volume_hierarchy_t bvh_;
+  std::vector<bezier_t> derivative_;
+  std::vector<bezier_t> second_derivative_;
+  std::vector<time_t> times_;  // bounds of the segments
+  std::size_t samples_;
+  std::vector<time_t> sample_times_;
+  t_point_t sample_points_;
+  /*Attributes*/
+};  // End struct closest_point_query
+
+}  // namespace curves
+#endif  //_CLASS_CLOSEST_POINT
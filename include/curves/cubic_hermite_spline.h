@@ -184,7 +184,7 @@ struct cubic_hermite_spline : public curve_abc<Time, Numeric, Safe, Point> {
   /// \brief Get vector of Time corresponding to Time for each control point.
   /// \return vector containing time of each control point.
   ///
-  vector_time_t getTime() { return time_control_points_; }
+  vector_time_t getTime() const { return time_control_points_; }
 
   /// \brief Get number of control points contained in the trajectory.
   /// \return number of control points.
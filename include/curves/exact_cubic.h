@@ -101,6 +101,12 @@ struct exact_cubic : public piecewise_curve<Time, Numeric, Safe, Point> {
   /// \brief Copy Constructor.
   exact_cubic(const exact_cubic& other) : piecewise_curve_t(other) {}
 
+  /// \brief Assignment operator.
+  exact_cubic& operator=(const exact_cubic& other) {
+    piecewise_curve_t::operator=(other);
+    return *this;
+  }
+
   /// \brief Destructor.
   virtual ~exact_cubic() {}
 
@@ -0,0 +1,156 @@
+/**
+ * \file extrema.h
+ * \brief Exact extrema of the components of a curve and of its derivatives.
+ *
+ * Along each axis, the extrema of a derivative of a curve are reached at the ends of the curve or at the roots of the
+ * next derivative. These roots are found with crossing_times for the polynomials and with bernstein_roots for the
+ * bezier curves, see bezier_curve::tight_bounds.
+ */
+
+#ifndef _CLASS_EXTREMA
+#define _CLASS_EXTREMA
+
+#include "bounding_box.h"
+#include "cubic_hermite_spline.h"
+#include "root_finding.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \brief Smallest box containing the derivative of order order of a polynomial.
+/// \param curve : the polynomial.
+/// \param order : order of the derivative, 0 for the positions.
+/// \param prec : precision of the times of the extrema.
+/// \return the box, the minimum and maximum of each component being its bounds.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point, typename T_Point>
+bounding_box<Numeric> extrema(const polynomial<Time, Numeric, Safe, Point, T_Point>& curve,
+                              const std::size_t order = 0, const Numeric prec = 1e-10) {
+  typedef polynomial<Time, Numeric, Safe, Point, T_Point> polynomial_t;
+  const polynomial_t derivative = curve.compute_derivate(order);
+  bounding_box<Numeric> box;
+  box.extend(derivative(curve.min()));
+  box.extend(derivative(curve.max()));
+  if (derivative.degree() < 2) return box;
+  const polynomial_t next = derivative.compute_derivate(1);
+  std::vector<Time> times;
+  for (std::size_t k = 0; k < curve.dim(); ++k) {
+    times.clear();
+    crossing_times(next, k, Numeric(0), times, prec);
+    for (std::size_t i = 0; i < times.size(); ++i) box.extend(derivative(times[i]));
+  }
+  return box;
+}
+
+/// \brief Smallest box containing the derivative of order order of a bezier curve, see bezier_curve::tight_bounds.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point>
+bounding_box<Numeric> extrema(const bezier_curve<Time, Numeric, Safe, Point>& curve, const std::size_t order = 0,
+                              const Numeric prec = 1e-10) {
+  if (order == 0) return curve.tight_bounds(prec);
+  return curve.compute_derivate(order).tight_bounds(prec);
+}
+
+/// \brief Smallest box containing the derivative of order order of a cubic hermite spline. Each interval of the
+/// spline is the cubic polynomial interpolating the positions and tangents of its ends.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point>
+bounding_box<Numeric> extrema(const cubic_hermite_spline<Time, Numeric, Safe, Point>& curve,
+                              const std::size_t order = 0, const Numeric prec = 1e-10) {
+  typedef polynomial<Time, Numeric, Safe, Point> polynomial_t;
+  const typename cubic_hermite_spline<Time, Numeric, Safe, Point>::vector_time_t times = curve.getTime();
+  bounding_box<Numeric> box;
+  for (std::size_t i = 0; i + 1 < times.size(); ++i) {
+    const polynomial_t segment(curve(times[i]), curve.derivate(times[i], 1), curve(times[i + 1]),
+                               curve.derivate(times[i + 1], 1), times[i], times[i + 1]);
+    box.extend(extrema(segment, order, prec));
+  }
+  return box;
+}
+
+/// \brief Smallest box containing the derivative of order order of a piecewise curve. The bezier, polynomial and
+/// cubic hermite segments are handled by the functions above, the other segments are converted with
+/// polynomial_from_curve.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point, typename Point_derivate, typename CurveType>
+bounding_box<Numeric> extrema(const piecewise_curve<Time, Numeric, Safe, Point, Point_derivate, CurveType>& curve,
+                              const std::size_t order = 0, const Numeric prec = 1e-10) {
+  typedef bezier_curve<Time, Numeric, Safe, Point> bezier_t;
+  typedef polynomial<Time, Numeric, Safe, Point> polynomial_t;
+  typedef cubic_hermite_spline<Time, Numeric, Safe, Point> cubic_hermite_spline_t;
+  bounding_box<Numeric> box;
+  for (std::size_t i = 0; i < curve.num_curves(); ++i) {
+    const CurveType* segment = curve.curve_at_index(i).get();
+    if (const bezier_t* bezier = dynamic_cast<const bezier_t*>(segment))
+      box.extend(extrema(*bezier, order, prec));
+    else if (const polynomial_t* pol = dynamic_cast<const polynomial_t*>(segment))
+      box.extend(extrema(*pol, order, prec));
+    else if (const cubic_hermite_spline_t* hermite = dynamic_cast<const cubic_hermite_spline_t*>(segment))
+      box.extend(extrema(*hermite, order, prec));
+    else
+      box.extend(extrema(polynomial_from_curve<polynomial_t>(*segment), order, prec));
+  }
+  return box;
+}
+
+/// \class limits_summary.
+/// \brief Extrema of a curve and of its first derivatives, computed once to check the curve against limits.
+///
+template <typename Numeric = double>
+struct limits_summary {
+  typedef bounding_box<Numeric> bounding_box_t;
+  typedef typename bounding_box_t::vector_x_t vector_x_t;
+  typedef typename bounding_box_t::vector_x_ref_t vector_x_ref_t;
+
+  /* Constructors - destructors */
+ public:
+  limits_summary() {}
+
+  /// \brief Constructor.
+  /// \param curve : a polynomial, bezier curve, cubic hermite spline or piecewise curve.
+  /// \param max_order : highest order of the derivatives, 2 for the positions, velocities and accelerations.
+  /// \param prec : precision of the times of the extrema.
+  template <typename Curve>
+  explicit limits_summary(const Curve& curve, const std::size_t max_order = 2, const Numeric prec = 1e-10) {
+    for (std::size_t order = 0; order <= max_order; ++order) bounds_.push_back(extrema(curve, order, prec));
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Extrema of the derivative of order order.
+  const bounding_box_t& bounds(const std::size_t order) const {
+    if (order >= bounds_.size()) throw std::invalid_argument("limits_summary : the order exceeds the highest order");
+    return bounds_[order];
+  }
+
+  /// \brief Maximal absolute value of each component of the derivative of order order.
+  vector_x_t max_abs(const std::size_t order) const {
+    const bounding_box_t& box = bounds(order);
+    return box.min_.cwiseAbs().cwiseMax(box.max_.cwiseAbs());
+  }
+
+  /// \brief Check that each component of the derivative of order order stays in [-limit, limit].
+  bool satisfies(const std::size_t order, const vector_x_ref_t& limit, const Numeric prec = 0.) const {
+    return (max_abs(order).array() <= limit.array() + prec).all();
+  }
+
+  /// \brief Check that each component of the derivative of order order stays in [lower, upper].
+  bool satisfies(const std::size_t order, const vector_x_ref_t& lower, const vector_x_ref_t& upper,
+                 const Numeric prec = 0.) const {
+    return bounding_box_t(lower, upper).contains(bounds(order), prec);
+  }
+
+  std::size_t max_order() const { return bounds_.size() - 1; }
+  /*Operations*/
+
+ private:
+  /*Attributes*/
+  std::vector<bounding_box_t> bounds_;  // extrema of each derivative
+  /*Attributes*/
+};  // End struct limits_summary
+
+}  // namespace curves
+#endif  //_CLASS_EXTREMA
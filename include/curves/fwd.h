@@ -24,6 +24,9 @@ struct bezier_curve;
 template <typename Time, typename Numeric, bool Safe, typename Point>
 struct cubic_hermite_spline;
 
+template <typename Time, typename Numeric, bool Safe, typename Point>
+struct bspline_curve;
+
 template <typename Time, typename Numeric, bool Safe, typename Point, typename T_Point, typename SplineBase>
 struct exact_cubic;
 
@@ -39,6 +42,9 @@ struct SE3Curve;
 template <typename Time, typename Numeric, bool Safe>
 struct SO3Linear;
 
+template <typename Time, typename Numeric, bool Safe, typename TranslationCurve, typename RotationCurve>
+struct SE3CurveTyped;
+
 template <typename Numeric>
 struct Bern;
 
@@ -83,6 +89,7 @@ typedef exact_cubic<double, double, true, pointX_t, t_pointX_t, polynomial_t> ex
 typedef bezier_curve<double, double, true, pointX_t> bezier_t;
 typedef cubic_hermite_spline<double, double, true, pointX_t> cubic_hermite_spline_t;
 typedef piecewise_curve<double, double, true, pointX_t, pointX_t, curve_abc_t> piecewise_t;
+typedef bspline_curve<double, double, true, pointX_t> bspline_t;
 
 // definition of all curves class with point3 as return type:
 typedef polynomial<double, double, true, point3_t, t_point3_t> polynomial3_t;
@@ -90,11 +97,14 @@ typedef exact_cubic<double, double, true, point3_t, t_point3_t, polynomial_t> ex
 typedef bezier_curve<double, double, true, point3_t> bezier3_t;
 typedef cubic_hermite_spline<double, double, true, point3_t> cubic_hermite_spline3_t;
 typedef piecewise_curve<double, double, true, point3_t, point3_t, curve_3_t> piecewise3_t;
+typedef bspline_curve<double, double, true, point3_t> bspline3_t;
 
 // special curves with return type fixed:
 typedef SO3Linear<double, double, true> SO3Linear_t;
 typedef SE3Curve<double, double, true> SE3Curve_t;
 typedef piecewise_curve<double, double, true, transform_t, point6_t, curve_SE3_t> piecewise_SE3_t;
+typedef SE3CurveTyped<double, double, true, bezier3_t, SO3Linear_t> SE3CurveBezier3_t;
+typedef SE3CurveTyped<double, double, true, polynomial3_t, SO3Linear_t> SE3CurvePolynomial3_t;
 
 }  // namespace curves
 
@@ -78,6 +78,7 @@ spline_constraints_t compute_required_offset_velocity_acceleration(const spline_
 /// ending positions, automatically create the spline such that:
 /// + init and end velocities / accelerations are 0.
 /// + the effector lifts and lands exactly in the direction of the specified normals.
+/// Contrary to effector_spline, the spline is returned by value.
 /// \param wayPointsBegin   : an iterator pointing to the first element of a waypoint container.
 /// \param wayPointsEnd     : an iterator pointing to the last element of a waypoint container.
 /// \param lift_normal      : normal to be followed by end effector at take-off.
@@ -88,11 +89,13 @@ spline_constraints_t compute_required_offset_velocity_acceleration(const spline_
 /// \param land_offset_duration : time travelled along straight line at landing.
 ///
 template <typename In>
-exact_cubic_t* effector_spline(In wayPointsBegin, In wayPointsEnd, const Point& lift_normal = Eigen::Vector3d::UnitZ(),
-                               const Point& land_normal = Eigen::Vector3d::UnitZ(), const Numeric lift_offset = 0.02,
-                               const Numeric land_offset = 0.02, const Time lift_offset_duration = 0.02,
-                               const Time land_offset_duration = 0.02) {
+exact_cubic_t make_effector_spline(In wayPointsBegin, In wayPointsEnd,
+                                   const Point& lift_normal = Eigen::Vector3d::UnitZ(),
+                                   const Point& land_normal = Eigen::Vector3d::UnitZ(),
+                                   const Numeric lift_offset = 0.02, const Numeric land_offset = 0.02,
+                                   const Time lift_offset_duration = 0.02, const Time land_offset_duration = 0.02) {
   T_Waypoint waypoints;
+  waypoints.reserve(std::distance(wayPointsBegin, wayPointsEnd) + 2);
   const Waypoint &inPoint = *wayPointsBegin, endPoint = *(wayPointsEnd - 1);
   waypoints.push_back(inPoint);
   // adding initial offset
@@ -100,15 +103,39 @@ exact_cubic_t* effector_spline(In wayPointsBegin, In wayPointsEnd, const Point&
   // inserting all waypoints but last
   waypoints.insert(waypoints.end(), wayPointsBegin + 1, wayPointsEnd - 1);
   // inserting waypoint to start landing
-  const Waypoint& landWaypoint = compute_offset(endPoint, land_normal, land_offset, -land_offset_duration);
-  waypoints.push_back(landWaypoint);
+  waypoints.push_back(compute_offset(endPoint, land_normal, land_offset, -land_offset_duration));
+  const Waypoint& landWaypoint = waypoints.back();
   // specifying end velocity constraint such that landing will be in straight line
   spline_t end_spline =
       make_end_spline(land_normal, landWaypoint.second, land_offset, landWaypoint.first, land_offset_duration);
   spline_constraints_t constraints = compute_required_offset_velocity_acceleration(end_spline, land_offset_duration);
   exact_cubic_t splines(waypoints.begin(), waypoints.end(), constraints);
   splines.add_curve(end_spline);
-  return new exact_cubic_t(splines);
+  return splines;
+}
+
+/// \brief Helper method to create a spline typically used to
+/// guide the 3d trajectory of a robot end effector.
+/// Given a set of waypoints, and the normal vector of the start and
+/// ending positions, automatically create the spline such that:
+/// + init and end velocities / accelerations are 0.
+/// + the effector lifts and lands exactly in the direction of the specified normals.
+/// \param wayPointsBegin   : an iterator pointing to the first element of a waypoint container.
+/// \param wayPointsEnd     : an iterator pointing to the last element of a waypoint container.
+/// \param lift_normal      : normal to be followed by end effector at take-off.
+/// \param land_normal      : normal to be followed by end effector at landing.
+/// \param lift_offset      : length of the straight line along normal at take-off.
+/// \param land_offset      : length of the straight line along normal at landing.
+/// \param lift_offset_duration : time travelled along straight line at take-off.
+/// \param land_offset_duration : time travelled along straight line at landing.
+///
+template <typename In>
+exact_cubic_t* effector_spline(In wayPointsBegin, In wayPointsEnd, const Point& lift_normal = Eigen::Vector3d::UnitZ(),
+                               const Point& land_normal = Eigen::Vector3d::UnitZ(), const Numeric lift_offset = 0.02,
+                               const Numeric land_offset = 0.02, const Time lift_offset_duration = 0.02,
+                               const Time land_offset_duration = 0.02) {
+  return new exact_cubic_t(make_effector_spline(wayPointsBegin, wayPointsEnd, lift_normal, land_normal, lift_offset,
+                                                land_offset, lift_offset_duration, land_offset_duration));
 }
 }  // namespace helpers
 }  // namespace curves
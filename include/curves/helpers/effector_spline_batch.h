@@ -0,0 +1,179 @@
+/**
+ * \file effector_spline_batch.h
+ * \brief Generation of many effector trajectories at once.
+ *
+ * Each trajectory of the batch goes from a lift-off position to a landing position, and is
+ * created with the same method as effector_spline / effector_spline_rotation. The trajectories
+ * are independent and are generated in parallel, either as splines stored in a preallocated vector,
+ * or directly sampled in a preallocated matrix.
+ */
+
+#ifndef _CLASS_EFFECTOR_SPLINE_BATCH
+#define _CLASS_EFFECTOR_SPLINE_BATCH
+
+#include "curves/helpers/effector_spline.h"
+#include "curves/helpers/effector_spline_rotation.h"
+#include "curves/parallel.h"
+
+namespace curves {
+namespace helpers {
+
+/// \struct effector_batch.
+/// \brief Lift-off / landing positions and timings of a batch of N effector trajectories, stored column-wise.
+/// The normals may be left empty, in which case Eigen::Vector3d::UnitZ() is used for all the trajectories.
+/// The quaternions (x, y, z, w) are only used by the functions generating the rotation of the effector,
+/// they may be left empty, in which case the identity is used.
+struct effector_batch {
+  effector_batch()
+      : lift_offset(0.02), land_offset(0.02), lift_offset_duration(0.02), land_offset_duration(0.02) {}
+
+  /// \brief Number of trajectories in the batch.
+  std::size_t size() const { return static_cast<std::size_t>(lift_times.size()); }
+
+  /// \brief Check the dimensions of the arrays.
+  void check() const {
+    const Eigen::Index N = lift_times.size();
+    if (land_times.size() != N || lift_positions.cols() != N || land_positions.cols() != N) {
+      throw std::invalid_argument("effector_batch : lift / land positions and times should have the same size");
+    }
+    if ((lift_normals.cols() != 0 && lift_normals.cols() != N) ||
+        (land_normals.cols() != 0 && land_normals.cols() != N)) {
+      throw std::invalid_argument("effector_batch : normals should be empty or have one column per trajectory");
+    }
+    if ((lift_quats.cols() != 0 && lift_quats.cols() != N) || (land_quats.cols() != 0 && land_quats.cols() != N)) {
+      throw std::invalid_argument("effector_batch : quaternions should be empty or have one column per trajectory");
+    }
+    for (Eigen::Index i = 0; i < N; ++i) {
+      if (land_times[i] - lift_times[i] <= lift_offset_duration + land_offset_duration) {
+        throw std::invalid_argument("effector_batch : trajectory too short for the lift / land offset durations");
+      }
+    }
+  }
+
+  /// \brief Waypoints (lift-off and landing) of the trajectory i.
+  T_Waypoint waypoints(const std::size_t i) const {
+    T_Waypoint res;
+    res.reserve(2);
+    res.push_back(std::make_pair(lift_times[i], Point(lift_positions.col(i))));
+    res.push_back(std::make_pair(land_times[i], Point(land_positions.col(i))));
+    return res;
+  }
+
+  Point lift_normal(const std::size_t i) const {
+    return lift_normals.cols() ? Point(lift_normals.col(i)) : Point(Eigen::Vector3d::UnitZ());
+  }
+  Point land_normal(const std::size_t i) const {
+    return land_normals.cols() ? Point(land_normals.col(i)) : Point(Eigen::Vector3d::UnitZ());
+  }
+  quat_t lift_quat(const std::size_t i) const {
+    return lift_quats.cols() ? quat_t(lift_quats.col(i)) : quat_t(0, 0, 0, 1);
+  }
+  quat_t land_quat(const std::size_t i) const {
+    return land_quats.cols() ? quat_t(land_quats.col(i)) : quat_t(0, 0, 0, 1);
+  }
+
+  /*Attributes*/
+  Eigen::Matrix3Xd lift_positions;  // 3xN
+  Eigen::Matrix3Xd land_positions;  // 3xN
+  Eigen::VectorXd lift_times;       // N
+  Eigen::VectorXd land_times;       // N
+  Eigen::Matrix3Xd lift_normals;    // 3xN or empty
+  Eigen::Matrix3Xd land_normals;    // 3xN or empty
+  Eigen::Matrix4Xd lift_quats;      // 4xN or empty
+  Eigen::Matrix4Xd land_quats;      // 4xN or empty
+  Numeric lift_offset;
+  Numeric land_offset;
+  Time lift_offset_duration;
+  Time land_offset_duration;
+  /*Attributes*/
+};
+
+/// \brief Create the effector splines of all the trajectories of a batch, see make_effector_spline.
+/// \param batch : lift-off / landing description of the trajectories.
+/// \param splines : output, resized to batch.size(), splines[i] is the trajectory i.
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+///
+inline void effector_splines(const effector_batch& batch, std::vector<exact_cubic_t>& splines,
+                             const std::size_t num_threads = 0) {
+  batch.check();
+  splines.resize(batch.size());
+  parallel_for(0, batch.size(),
+               [&batch, &splines](const std::size_t i) {
+                 const T_Waypoint waypoints = batch.waypoints(i);
+                 splines[i] = make_effector_spline(waypoints.begin(), waypoints.end(), batch.lift_normal(i),
+                                                   batch.land_normal(i), batch.lift_offset, batch.land_offset,
+                                                   batch.lift_offset_duration, batch.land_offset_duration);
+               },
+               num_threads);
+}
+
+/// \brief Sample the effector positions of all the trajectories of a batch, see effector_spline.
+/// Each trajectory is sampled at num_samples times uniformly distributed between its lift-off and landing times.
+/// \param batch : lift-off / landing description of the trajectories.
+/// \param num_samples : number of samples per trajectory, must be greater than 1.
+/// \param positions : output, matrix of size 3 x (N * num_samples), column i * num_samples + j is the j-th sample
+/// of the trajectory i.
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+///
+inline void sample_effector_splines(const effector_batch& batch, const std::size_t num_samples,
+                                    Eigen::Ref<Eigen::MatrixXd> positions, const std::size_t num_threads = 0) {
+  batch.check();
+  if (num_samples < 2) {
+    throw std::invalid_argument("sample_effector_splines : num_samples should be greater than 1");
+  }
+  if (positions.rows() != 3 || positions.cols() != static_cast<Eigen::Index>(batch.size() * num_samples)) {
+    throw std::invalid_argument("sample_effector_splines : positions should be of size 3 x (N * num_samples)");
+  }
+  parallel_for(0, batch.size(),
+               [&batch, &positions, num_samples](const std::size_t i) {
+                 const T_Waypoint waypoints = batch.waypoints(i);
+                 const exact_cubic_t spline = make_effector_spline(
+                     waypoints.begin(), waypoints.end(), batch.lift_normal(i), batch.land_normal(i),
+                     batch.lift_offset, batch.land_offset, batch.lift_offset_duration, batch.land_offset_duration);
+                 const Time dt = (spline.max() - spline.min()) / static_cast<Time>(num_samples - 1);
+                 for (std::size_t j = 0; j < num_samples; ++j) {
+                   const Time t = j + 1 < num_samples ? spline.min() + dt * j : spline.max();
+                   positions.col(i * num_samples + j) = spline(t);
+                 }
+               },
+               num_threads);
+}
+
+/// \brief Sample the effector positions and rotations of all the trajectories of a batch,
+/// see effector_spline_rotation. Each trajectory is sampled at num_samples times uniformly distributed between
+/// its lift-off and landing times.
+/// \param batch : lift-off / landing description of the trajectories.
+/// \param num_samples : number of samples per trajectory, must be greater than 1.
+/// \param configs : output, matrix of size 7 x (N * num_samples), column i * num_samples + j is the j-th sample
+/// of the trajectory i (3D position followed by the quaternion (x, y, z, w)).
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+///
+inline void sample_effector_splines_rotation(const effector_batch& batch, const std::size_t num_samples,
+                                             Eigen::Ref<Eigen::MatrixXd> configs, const std::size_t num_threads = 0) {
+  batch.check();
+  if (num_samples < 2) {
+    throw std::invalid_argument("sample_effector_splines_rotation : num_samples should be greater than 1");
+  }
+  if (configs.rows() != 7 || configs.cols() != static_cast<Eigen::Index>(batch.size() * num_samples)) {
+    throw std::invalid_argument("sample_effector_splines_rotation : configs should be of size 7 x (N * num_samples)");
+  }
+  parallel_for(0, batch.size(),
+               [&batch, &configs, num_samples](const std::size_t i) {
+                 const T_Waypoint waypoints = batch.waypoints(i);
+                 const quat_t lift_quat = batch.lift_quat(i), land_quat = batch.land_quat(i);
+                 const quat_ref_const_t to_quat(lift_quat), to_land(land_quat);
+                 const effector_spline_rotation trajectory(
+                     waypoints.begin(), waypoints.end(), to_quat, to_land, batch.lift_normal(i), batch.land_normal(i),
+                     batch.lift_offset, batch.land_offset, batch.lift_offset_duration, batch.land_offset_duration);
+                 const Time dt = (trajectory.max() - trajectory.min()) / static_cast<Time>(num_samples - 1);
+                 for (std::size_t j = 0; j < num_samples; ++j) {
+                   const Time t = j + 1 < num_samples ? trajectory.min() + dt * j : trajectory.max();
+                   configs.col(i * num_samples + j) = trajectory(t);
+                 }
+               },
+               num_threads);
+}
+
+}  // namespace helpers
+}  // namespace curves
+#endif  //_CLASS_EFFECTOR_SPLINE_BATCH
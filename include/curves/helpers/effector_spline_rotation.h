@@ -22,6 +22,7 @@
 #include "curves/helpers/effector_spline.h"
 #include "curves/curve_abc.h"
 #include <Eigen/Geometry>
+#include <complex>
 
 namespace curves {
 namespace helpers {
@@ -36,6 +37,7 @@ typedef Eigen::Matrix<Numeric, 1, 1> point_one_dim_t;
 typedef exact_cubic<Numeric, Numeric, false, point_one_dim_t> exact_cubic_constraint_one_dim;
 typedef std::pair<Numeric, point_one_dim_t> waypoint_one_dim_t;
 typedef std::vector<waypoint_one_dim_t> t_waypoint_one_dim_t;
+typedef polynomial<Numeric, Numeric, false, point_one_dim_t> polynomial_one_dim_t;
 
 class rotation_spline : public curve_abc_quat_t {
  public:
@@ -47,7 +49,7 @@ class rotation_spline : public curve_abc_quat_t {
         dim_(4),
         min_(min),
         max_(max),
-        time_reparam_(computeWayPoints()) {}
+        time_reparam_(shared_time_reparam()) {}
 
   ~rotation_spline() {}
 
@@ -58,7 +60,7 @@ class rotation_spline : public curve_abc_quat_t {
     dim_ = from.dim_;
     min_ = from.min_;
     max_ = from.max_;
-    time_reparam_ = exact_cubic_constraint_one_dim(from.time_reparam_);
+    // time_reparam_ is shared by all the instances
     return *this;
   }
   /* Copy Constructors / operator=*/
@@ -69,7 +71,19 @@ class rotation_spline : public curve_abc_quat_t {
     // normalize u
     Numeric u = (t - min()) / (max() - min());
     // reparametrize u
-    return quat_from_.slerp(time_reparam_(u)[0], quat_to_).coeffs();
+    return quat_from_.slerp(reparametrize(u), quat_to_).coeffs();
+  }
+
+  ///  \brief Evaluation of the spline for several times.
+  ///  \param times : vector of size N of the times when to evaluate the spline.
+  ///  \param quats : output, matrix of size 4xN, column i contains the quaternion (x,y,z,w) at time times[i].
+  void evaluate(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> quats) const {
+    if (quats.rows() != 4 || quats.cols() != times.size()) {
+      throw std::invalid_argument("rotation_spline::evaluate : quats should be of size 4 x number of times");
+    }
+    for (Eigen::Index i = 0; i < times.size(); ++i) {
+      quats.col(i) = rotation_spline::operator()(times[i]);
+    }
   }
 
   /**
@@ -100,8 +114,57 @@ class rotation_spline : public curve_abc_quat_t {
 
   virtual bool operator!=(const rotation_spline& other) const { return !(*this == other); }
 
-  virtual quat_t derivate(time_t /*t*/, std::size_t /*order*/) const {
-    throw std::runtime_error("TODO quaternion spline does not implement derivate");
+  ///  \brief Evaluation of the derivative of order N of the quaternion coefficients at time t.
+  ///  The spline is \f$ q(t) = q_{from} \exp(s(t) \frac{\omega}{2}) \f$ with \f$ \omega \f$ the rotation vector from
+  ///  quat_from to quat_to and s the time reparametrization. The powers of \f$ \frac{\omega}{2} \f$ behave as the ones
+  ///  of the complex number \f$ i \frac{\theta}{2} \f$, the derivatives are thus computed with the Leibniz rule in this
+  ///  complex plane.
+  ///  \param t : the time when to evaluate the spline.
+  ///  \param order : order of derivative.
+  ///  \return \f$\frac{d^Nq(t)}{dt^N}\f$, coefficients (x,y,z,w) of the derivative at time t.
+  virtual quat_t derivate(const time_t t, const std::size_t order) const {
+    if (order <= 0) {
+      throw std::invalid_argument("Order must be strictly positive");
+    }
+    // s and its first derivative are continuous at the bounds, but not its second and third derivatives
+    if (t < min() || t > max()) return quat_t::Zero();
+    Eigen::Vector3d axis;
+    Numeric theta;
+    relative_rotation(axis, theta);
+    const Numeric T = max() - min();
+    const Numeric u = (t - min()) / T;
+    // derivatives of s(t) of order 1 to 3, higher orders are null
+    Numeric ds[3];
+    for (std::size_t k = 0; k < 3; ++k) {
+      ds[k] = time_reparam_.polynomial_one_dim_t::derivate(u, k + 1)[0] / std::pow(T, (Numeric)(k + 1));
+    }
+    const std::complex<Numeric> a(0., theta / 2.);
+    std::vector<std::complex<Numeric> > c(order + 1);
+    c[0] = 1.;
+    for (std::size_t n = 1; n <= order; ++n) {
+      c[n] = 0.;
+      Numeric binom = 1.;  // binomial coefficient (n-1, k)
+      for (std::size_t k = 0; k < n && k < 3; ++k) {
+        c[n] += binom * a * ds[k] * c[n - 1 - k];
+        binom = binom * (Numeric)(n - 1 - k) / (Numeric)(k + 1);
+      }
+    }
+    const Eigen::Quaterniond q(rotation_spline::operator()(t));
+    const Eigen::Quaterniond dq(c[order].real(), c[order].imag() * axis.x(), c[order].imag() * axis.y(),
+                                c[order].imag() * axis.z());
+    return (q * dq).coeffs();
+  }
+
+  ///  \brief Angular velocity at time t, expressed in the world frame.
+  ///  \param t : the time when to evaluate the spline.
+  Eigen::Vector3d angular_velocity(const time_t t) const {
+    if (t <= min() || t >= max()) return Eigen::Vector3d::Zero();
+    Eigen::Vector3d axis;
+    Numeric theta;
+    relative_rotation(axis, theta);
+    const Numeric T = max() - min();
+    const Numeric ds = time_reparam_.polynomial_one_dim_t::derivate((t - min()) / T, 1)[0] / T;
+    return quat_from_ * axis * (theta * ds);
   }
 
   ///  \brief Compute the derived curve at order N.
@@ -111,12 +174,17 @@ class rotation_spline : public curve_abc_quat_t {
     throw std::logic_error("Compute derivate for quaternion spline is not implemented yet.");
   }
 
-  /// \brief Initialize time reparametrization for spline.
-  exact_cubic_constraint_one_dim computeWayPoints() const {
-    t_waypoint_one_dim_t waypoints;
-    waypoints.push_back(std::make_pair(0, point_one_dim_t::Zero()));
-    waypoints.push_back(std::make_pair(1, point_one_dim_t::Ones()));
-    return exact_cubic_constraint_one_dim(waypoints.begin(), waypoints.end());
+  /// \brief Initialize time reparametrization for spline: cubic polynomial going from 0 to 1 on [0, 1],
+  /// with null velocities at both ends.
+  static polynomial_one_dim_t computeWayPoints() {
+    return polynomial_one_dim_t(point_one_dim_t::Zero(), point_one_dim_t::Zero(), point_one_dim_t::Ones(),
+                                point_one_dim_t::Zero(), 0., 1.);
+  }
+
+  /// \brief Time reparametrization shared by all the instances of rotation_spline.
+  static const polynomial_one_dim_t& shared_time_reparam() {
+    static const polynomial_one_dim_t time_reparam(computeWayPoints());
+    return time_reparam;
   }
 
   virtual std::size_t dim() const { return dim_; }
@@ -125,14 +193,32 @@ class rotation_spline : public curve_abc_quat_t {
   /// \brief Get the degree of the curve.
   /// \return \f$degree\f$, the degree of the curve.
   virtual std::size_t degree() const { return 1; }
+  /// \brief Get the time reparametrization, shared by all the instances.
+  const polynomial_one_dim_t& time_reparam() const { return time_reparam_; }
+
+ private:
+  Numeric reparametrize(const Numeric u) const { return time_reparam_.polynomial_one_dim_t::operator()(u)[0]; }
 
+  /// \brief Compute the rotation from quat_from_ to quat_to_ (following the shortest path, as slerp) as an axis and
+  /// an angle.
+  void relative_rotation(Eigen::Vector3d& axis, Numeric& theta) const {
+    Eigen::Quaterniond d = quat_from_.conjugate() * quat_to_;
+    if (d.w() < 0) d.coeffs() = -d.coeffs();
+    const Eigen::AngleAxisd aa(d);
+    axis = aa.axis();
+    theta = aa.angle();
+  }
+
+ public:
   /*Attributes*/
-  Eigen::Quaterniond quat_from_;                 // const
-  Eigen::Quaterniond quat_to_;                   // const
-  std::size_t dim_;                              // const
-  double min_;                                   // const
-  double max_;                                   // const
-  exact_cubic_constraint_one_dim time_reparam_;  // const
+  Eigen::Quaterniond quat_from_;               // const
+  Eigen::Quaterniond quat_to_;                 // const
+  std::size_t dim_;                            // const
+  double min_;                                 // const
+  double max_;                                 // const
+
+ private:
+  const polynomial_one_dim_t& time_reparam_;  // shared
   /*Attributes*/
 };  // End class rotation_spline
 
@@ -244,6 +330,17 @@ class effector_spline_rotation {
     return quat_spline_(t);
   }
 
+  ///  \brief Angular velocity of the effector at time t, expressed in the world frame.
+  ///  \param t : the time when to evaluate the spline.
+  ///  \return A 3D vector, null during the take off and landing phases.
+  ///
+  Eigen::Vector3d angular_velocity(const Numeric t) const {
+    if (t <= time_lift_offset_ || t >= time_land_offset_) return Eigen::Vector3d::Zero();
+    const Eigen::Quaterniond q(quat_spline_(t));
+    const Eigen::Quaterniond dq(quat_spline_.derivate(t, 1));
+    return 2. * (dq * q.conjugate()).vec();
+  }
+
  private:
   exact_cubic_quat_t simple_quat_spline() const {
     std::vector<rotation_spline> splines;
@@ -26,7 +26,7 @@ template <typename Numeric = double, bool Safe = true>
 struct linear_variable : public serialization::Serializable {
   typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
   typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
-  typedef linear_variable<Numeric> linear_variable_t;
+  typedef linear_variable<Numeric, Safe> linear_variable_t;
 
   linear_variable() : B_(matrix_x_t::Identity(0, 0)), c_(vector_x_t::Zero(0)), zero(true) {}              // variable
   linear_variable(const vector_x_t& c) : B_(matrix_x_t::Zero(c.size(), c.size())), c_(c), zero(false) {}  // constant
@@ -73,6 +73,45 @@ struct linear_variable : public serialization::Serializable {
     return *this;
   }
 
+  /// \brief In place fused operation *this += a * x, evaluated in a single pass without temporaries.
+  linear_variable_t& axpy(const Numeric a, const linear_variable_t& x) {
+    if (x.isZero()) return *this;
+    if (isZero()) {
+      this->B_ = a * x.B_;
+      this->c_ = a * x.c_;
+      zero = false;
+    } else {
+      this->B_ += a * x.B_;
+      this->c_ += a * x.c_;
+    }
+    return *this;
+  }
+
+  /// \brief Set *this to a * x + b * y, evaluated in a single pass without temporaries.
+  /// *this may be one of x or y. The storage of *this is reused when it already has the right size.
+  /// Zero variables are considered as null.
+  linear_variable_t& set_linear_combination(const Numeric a, const linear_variable_t& x, const Numeric b,
+                                            const linear_variable_t& y) {
+    if (x.isZero()) {
+      if (y.isZero()) {
+        *this = linear_variable_t();
+        return *this;
+      }
+      this->B_ = b * y.B_;
+      this->c_ = b * y.c_;
+    } else if (y.isZero()) {
+      this->B_ = a * x.B_;
+      this->c_ = a * x.c_;
+    } else {
+      if (Safe && (x.B_.rows() != y.B_.rows() || x.B_.cols() != y.B_.cols() || x.c_.size() != y.c_.size()))
+        throw std::length_error("Cannot combine linear variables, dimensions do not match");
+      this->B_ = a * x.B_ + b * y.B_;
+      this->c_ = a * x.c_ + b * y.c_;
+    }
+    zero = false;
+    return *this;
+  }
+
   static linear_variable_t Zero(size_t dim = 0) {
     return linear_variable_t(matrix_x_t::Identity(dim, dim), vector_x_t::Zero(dim));
   }
@@ -111,32 +150,51 @@ struct linear_variable : public serialization::Serializable {
 
 template <typename N, bool S>
 inline linear_variable<N, S> operator+(const linear_variable<N, S>& w1, const linear_variable<N, S>& w2) {
-  linear_variable<N, S> res(w1.B(), w1.c());
-  return res += w2;
+  if (w2.isZero()) return linear_variable<N, S>(w1.B(), w1.c());
+  linear_variable<N, S> res;
+  return res.set_linear_combination(1., w1, 1., w2);
+}
+
+// the temporary on the left hand side of a composite expression is reused
+template <typename N, bool S>
+inline linear_variable<N, S> operator+(linear_variable<N, S>&& w1, const linear_variable<N, S>& w2) {
+  w1 += w2;
+  return std::move(w1);
 }
 
 template <typename N, bool S>
 linear_variable<N, S> operator-(const linear_variable<N, S>& w1, const linear_variable<N, S>& w2) {
-  linear_variable<N, S> res(w1.B(), w1.c());
-  return res -= w2;
+  if (w2.isZero()) return linear_variable<N, S>(w1.B(), w1.c());
+  linear_variable<N, S> res;
+  return res.set_linear_combination(1., w1, -1., w2);
+}
+
+template <typename N, bool S>
+inline linear_variable<N, S> operator-(linear_variable<N, S>&& w1, const linear_variable<N, S>& w2) {
+  w1 -= w2;
+  return std::move(w1);
 }
 
 template <typename N, bool S>
 linear_variable<N, S> operator*(const double k, const linear_variable<N, S>& w) {
-  linear_variable<N, S> res(w.B(), w.c());
-  return res *= k;
+  return linear_variable<N, S>(k * w.B(), k * w.c());
 }
 
 template <typename N, bool S>
 linear_variable<N, S> operator*(const linear_variable<N, S>& w, const double k) {
-  linear_variable<N, S> res(w.B(), w.c());
-  return res *= k;
+  return linear_variable<N, S>(k * w.B(), k * w.c());
 }
 
 template <typename N, bool S>
 linear_variable<N, S> operator/(const linear_variable<N, S>& w, const double k) {
-  linear_variable<N, S> res(w.B(), w.c());
-  return res /= k;
+  return linear_variable<N, S>(w.B() / k, w.c() / k);
+}
+
+/// \brief res = a * x + b * y, see linear_variable::set_linear_combination.
+template <typename N, bool S>
+inline void linear_combination(linear_variable<N, S>& res, const N a, const linear_variable<N, S>& x, const N b,
+                               const linear_variable<N, S>& y) {
+  res.set_linear_combination(a, x, b, y);
 }
 
 template <typename BezierFixed, typename BezierLinear, typename X>
@@ -5,8 +5,9 @@
  * \version 0.1
  * \date 06/17/2013
  *
- * This file uses the mosek library to optimize the waypoints location
- * to generate exactCubic spline
+ * This file optimizes the waypoints location to generate exactCubic spline.
+ * The quadratic problem is solved by a solver given as a template parameter,
+ * the ADMM solver of qp_solver.h by default.
  */
 
 #ifndef _CLASS_SPLINEOPTIMIZER
@@ -14,37 +15,49 @@
 
 #include "curves/MathDefs.h"
 #include "curves/exact_cubic.h"
+#include "curves/optimization/qp_solver.h"
 
-#include "mosek/mosek.h"
 #include <Eigen/SparseCore>
 
+#include <limits>
 #include <utility>
+#include <vector>
 
 namespace curves {
 /// \class SplineOptimizer
-/// \brief Mosek connection to produce optimized splines
+/// \brief Produce optimized splines by solving a quadratic problem.
+/// The solver is kept between two calls to GenerateOptimizedCurve : an optimizer must not be used by several threads
+/// at the same time.
+/// \tparam Solver : quadratic solver with the interface of optimization::qp_solver, for the sparse matrices
+/// Eigen::SparseMatrix<Numeric> : setup(A, b, C, l, u) and solve() returning a qp_result<Numeric>.
+/// Other solvers can be used through a thin adapter class.
 template <typename Time = double, typename Numeric = Time, std::size_t Dim = 3, bool Safe = false,
-          typename Point = Eigen::Matrix<Numeric, Dim, 1> >
+          typename Point = Eigen::Matrix<Numeric, Dim, 1>,
+          typename Solver = optimization::qp_solver<Numeric, Eigen::SparseMatrix<Numeric> > >
 struct SplineOptimizer {
   typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> MatrixX;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> VectorX;
+  typedef Eigen::SparseMatrix<Numeric> SparseMatrixX;
+  typedef Eigen::Triplet<Numeric> triplet_t;
   typedef Point point_t;
   typedef Time time_t;
   typedef Numeric num_t;
-  typedef exact_cubic<time_t, Numeric, Dim, Safe, Point> exact_cubic_t;
-  typedef SplineOptimizer<time_t, Numeric, Dim, Safe, Point> splineOptimizer_t;
+  typedef Solver solver_t;
+  typedef exact_cubic<time_t, Numeric, Safe, Point> exact_cubic_t;
+  typedef SplineOptimizer<time_t, Numeric, Dim, Safe, Point, Solver> splineOptimizer_t;
 
   /* Constructors - destructors */
  public:
   ///\brief Initializes optimizer environment.
-  SplineOptimizer() {
-    MSKrescodee r_ = MSK_makeenv(&env_, NULL);
-    if (r_ != MSK_RES_OK) {
-      throw std::runtime_error("Issue initializing MSK_makeenv");
-    }
-  }
+  SplineOptimizer() : solver_() {}
+
+  ///\brief Initializes optimizer environment.
+  /// \param arg : argument forwarded to the constructor of the solver, for instance its settings.
+  template <typename SolverArg>
+  explicit SplineOptimizer(const SolverArg& arg) : solver_(arg) {}
 
   ///\brief Destructor.
-  ~SplineOptimizer() { MSK_deleteenv(&env_); }
+  ~SplineOptimizer() {}
 
  private:
   SplineOptimizer(const SplineOptimizer&);
@@ -55,17 +68,34 @@ struct SplineOptimizer {
  public:
   /// \brief Start an optimization loop to create curve.
   /// \param waypoints : a list containing at least 2 waypoints in ascending time order.
-  /// \return An Optimised curve.
+  /// \return An Optimised curve, or a null pointer if the problem could not be solved.
   template <typename In>
-  exact_cubic_t* GenerateOptimizedCurve(In wayPointsBegin, In wayPointsEnd) const;
+  exact_cubic_t* GenerateOptimizedCurve(In wayPointsBegin, In wayPointsEnd);
+
+  solver_t& solver() { return solver_; }
+  const solver_t& solver() const { return solver_; }
   /*Operations*/
 
  private:
   template <typename In>
-  void ComputeHMatrices(In wayPointsBegin, In wayPointsEnd, MatrixX& h1, MatrixX& h2, MatrixX& h3, MatrixX& h4) const;
+  void ComputeHMatrices(In wayPointsBegin, In wayPointsEnd, SparseMatrixX& h1, SparseMatrixX& h2, SparseMatrixX& h3,
+                        SparseMatrixX& h4) const;
+
+  /// \brief Append the rows coefs * x[offset:offset+size] of each dimension to the constraint triplets,
+  /// dimension j being written at the row firstRow + j * rowsPerDim + row.
+  static void AppendBlock(const SparseMatrixX& coefs, const int size, const int offset, const int firstRow,
+                          const int rowsPerDim, std::vector<triplet_t>& triplets) {
+    for (int k = 0; k < coefs.outerSize(); ++k) {
+      for (typename SparseMatrixX::InnerIterator it(coefs, k); it; ++it) {
+        for (int j = 0; j < (int)Dim; ++j)
+          triplets.push_back(triplet_t(firstRow + j * rowsPerDim + (int)it.row(), offset + j * size + (int)it.col(),
+                                       it.value()));
+      }
+    }
+  }
 
   /*Attributes*/
-  MSKenv_t env_;
+  solver_t solver_;
   /*Attributes*/
 
  private:
@@ -73,418 +103,126 @@ struct SplineOptimizer {
   typedef std::vector<waypoint_t> T_waypoints_t;
 };  // End struct SplineOptimizer
 
-template <typename Time, typename Numeric, std::size_t Dim, bool Safe, typename Point>
+template <typename Time, typename Numeric, std::size_t Dim, bool Safe, typename Point, typename Solver>
 template <typename In>
-inline void SplineOptimizer<Time, Numeric, Dim, Safe, Point>::ComputeHMatrices(In wayPointsBegin, In wayPointsEnd,
-                                                                               MatrixX& h1, MatrixX& h2, MatrixX& h3,
-                                                                               MatrixX& h4) const {
+inline void SplineOptimizer<Time, Numeric, Dim, Safe, Point, Solver>::ComputeHMatrices(In wayPointsBegin,
+                                                                                       In wayPointsEnd,
+                                                                                       SparseMatrixX& h1,
+                                                                                       SparseMatrixX& h2,
+                                                                                       SparseMatrixX& h3,
+                                                                                       SparseMatrixX& h4) const {
   std::size_t const size(std::distance(wayPointsBegin, wayPointsEnd));
   assert((!Safe) || (size > 1));
+  std::vector<triplet_t> t1, t2, t3, t4;
 
   In it(wayPointsBegin), next(wayPointsBegin);
   ++next;
-  Numeric t_previous((*it).first);
 
-  for (std::size_t i(0); next != wayPointsEnd; ++next, ++it, ++i) {
+  for (int i(0); next != wayPointsEnd; ++next, ++it, ++i) {
     num_t const dTi((*next).first - (*it).first);
     num_t const dTi_sqr(dTi * dTi);
-    // filling matrices values
-    h3(i, i) = -3 / dTi_sqr;
-    h3(i, i + 1) = 3 / dTi_sqr;
-    h4(i, i) = -2 / dTi;
-    h4(i, i + 1) = -1 / dTi;
-    if (i + 2 < size) {
+    // acceleration at the beginning of the segment i
+    t3.push_back(triplet_t(i, i, -6 / dTi_sqr));
+    t3.push_back(triplet_t(i, i + 1, 6 / dTi_sqr));
+    t4.push_back(triplet_t(i, i, -4 / dTi));
+    t4.push_back(triplet_t(i, i + 1, -2 / dTi));
+    if (std::size_t(i + 2) < size) {
       In it2(next);
       ++it2;
       num_t const dTi_1((*it2).first - (*next).first);
       num_t const dTi_1sqr(dTi_1 * dTi_1);
-      // this can be optimized but let's focus on clarity as long as not needed
-      h1(i + 1, i) = 2 / dTi;
-      h1(i + 1, i + 1) = 4 / dTi + 4 / dTi_1;
-      h1(i + 1, i + 2) = 2 / dTi_1;
-      h2(i + 1, i) = -6 / dTi_sqr;
-      h2(i + 1, i + 1) = (6 / dTi_1sqr) - (6 / dTi_sqr);
-      h2(i + 1, i + 2) = 6 / dTi_1sqr;
+      // continuity of the acceleration at the waypoint i + 1
+      t1.push_back(triplet_t(i + 1, i, 2 / dTi));
+      t1.push_back(triplet_t(i + 1, i + 1, 4 / dTi + 4 / dTi_1));
+      t1.push_back(triplet_t(i + 1, i + 2, 2 / dTi_1));
+      t2.push_back(triplet_t(i + 1, i, -6 / dTi_sqr));
+      t2.push_back(triplet_t(i + 1, i + 1, (6 / dTi_sqr) - (6 / dTi_1sqr)));
+      t2.push_back(triplet_t(i + 1, i + 2, 6 / dTi_1sqr));
     }
   }
+  h1.resize(size, size);
+  h2.resize(size, size);
+  h3.resize(size, size);
+  h4.resize(size, size);
+  h1.setFromTriplets(t1.begin(), t1.end());
+  h2.setFromTriplets(t2.begin(), t2.end());
+  h3.setFromTriplets(t3.begin(), t3.end());
+  h4.setFromTriplets(t4.begin(), t4.end());
 }
 
-template <typename Time, typename Numeric, std::size_t Dim, bool Safe, typename Point>
+template <typename Time, typename Numeric, std::size_t Dim, bool Safe, typename Point, typename Solver>
 template <typename In>
-inline exact_cubic<Time, Numeric, Dim, Safe, Point>*
-SplineOptimizer<Time, Numeric, Dim, Safe, Point>::GenerateOptimizedCurve(In wayPointsBegin, In wayPointsEnd) const {
-  exact_cubic_t* res = 0;
+inline typename SplineOptimizer<Time, Numeric, Dim, Safe, Point, Solver>::exact_cubic_t*
+SplineOptimizer<Time, Numeric, Dim, Safe, Point, Solver>::GenerateOptimizedCurve(In wayPointsBegin,
+                                                                                 In wayPointsEnd) {
   int const size((int)std::distance(wayPointsBegin, wayPointsEnd));
-  if (Safe && size < 1) {
+  if (Safe && size < 2) {
     throw std::length_error("can not generate optimizedCurve, number of waypoints should be superior to one");
-    ;  // TODO
   }
   // refer to the paper to understand all this.
-  MatrixX h1 = MatrixX::Zero(size, size);
-  MatrixX h2 = MatrixX::Zero(size, size);
-  MatrixX h3 = MatrixX::Zero(size, size);
-  MatrixX h4 = MatrixX::Zero(size, size);
-
-  // remove this for the time being
-  /*MatrixX g1 = MatrixX::Zero(size, size);
-  MatrixX g2 = MatrixX::Zero(size, size);
-  MatrixX g3 = MatrixX::Zero(size, size);
-  MatrixX g4 = MatrixX::Zero(size, size);*/
-
+  SparseMatrixX h1, h2, h3, h4;
   ComputeHMatrices(wayPointsBegin, wayPointsEnd, h1, h2, h3, h4);
 
-  // number of Waypoints : T + 1 => T mid points. Dim variables per points, + acceleration + derivations
-  // (T * t+ 1 ) * Dim * 3 = nb var
-
-  // NOG const MSKint32t numvar = ( size + size - 1) * 3 * 3;
-  const MSKint32t numvar = (size)*Dim * 3;
   /*
-  We store the variables in that order to simplifly matrix computation ( see later )
-  // NOG [ x0  x1 --- xn y0 --- y z0 --- zn x0. --- zn. x0..--- zn.. x0' --- zn..' ] T
+  We store the variables in that order to simplifly matrix computation
   [ x0  x1 --- xn y0 --- y z0 --- zn x0. --- zn. x0..--- zn..] T
   */
-
-  /*the first constraint is H1x. = H2x => H2x - H1x. = 0
-  this will give us size * 3 inequalities constraints
-  So this line of A will be writen
-  H2 -H1 0 0 0 0
-  */
-
-  int ptOff = (int)Dim * size;        // . offest
-  int ptptOff = (int)Dim * 2 * size;  // .. offest
-  int prOff = (int)3 * ptOff;         // ' offest
-  // NOG int prptOff   = (int) prOff + ptOff; // '. offest
-  // NOG int prptptOff = (int) prptOff + ptOff; // '.. offest
-
-  MatrixX h2x_h1x = MatrixX::Zero(size * Dim, numvar);
-  /**A looks something like that : (n = size)
-  [H2(0)  0      0     -H1(0) 0-------------------0]
-  [ 0  0  H2(0)  0       0   -H1(0)---------------0]
-  [ 0  0  0      H2(0)   0     0     H1(0)--------0]
-  ...
-  [ 0  0  0      0   H2(n)   0    0      0     -H1(n)-0] // row n
-
-  Overall it's fairly easy to fill
-  */
-  for (int i = 0; i < size * Dim; i = i + 3) {
-    for (int j = 0; j < Dim; ++j) {
-      int id = i + j;
-      h2x_h1x.block(id, j * size, 1, size) = h2.row(i % 3);
-      h2x_h1x.block(id, j * size + ptOff, 1, size) -= h1.row(i % 3);
-    }
-  }
-
-  /*the second constraint is x' = G1x + G2x. => G1x + G2x. - x' = 0
-  this will give us size * 3 inequalities constraints
-  So this line of A will be writen
-  H2 -H1 0 0 0 0
-  */
-  MatrixX g1x_g2x = MatrixX::Zero(size * Dim, numvar);
-  /**A looks something like that : (n = size)
-  [G1(0)  0      0     G2(0) 0-----------------------0 -1 0]
-  [ 0  0  G1(0)  0       0   G2(0)-------------------0 -1 0]
-  [ 0  0  0      G1(0)   0     0     G2(0)-----------0 -1 0]
-  ...
-  [ 0  0  0      0   G1(n)   0    0      0     G2(n)-0 -1 0] // row n
-
-  Overall it's fairly easy to fill
-  */
-  // NOG
-  /*for(int j = 0; j<3; ++j)
-  {
-  for(int j =0; j<3; ++j)
-  {
-  int id = i + j;
-  g1x_g2x.block(id, j*size      , 1, size)   = g1.row(i);
-  g1x_g2x.block(id, j*size + ptOff, 1, size)   = g2.row(i);
-  g1x_g2x.block(id, j*size + prOff, 1, size)  -= MatrixX::Ones(1, size);
-  }
-  }*/
-
-  /*the third constraint is x.' = G3x + G4x. => G3x + G4x. - x.' = 0
-  this will give us size * 3 inequalities constraints
-  So this line of A will be writen
-  H2 -H1 0 0 0 0
-  */
-  MatrixX g3x_g4x = MatrixX::Zero(size * Dim, numvar);
-  /**A looks something like that : (n = size)
-  [G3(0)  0      0     G4(0) 0-------------------0 -1 0]
-  [ 0  0  G3(0)  0       0   G4(0)---------------0 -1 0]
-  [ 0  0  0      G3(0)   0     0     G4(0)--------0 -1 0]
-  ...
-  [ 0  0  0      0   G3(n)   0    0      0     G4(n)-0 -1 0] // row n
-
-  Overall it's fairly easy to fill
-  */
-  // NOG
-  /*for(int j = 0; j<3; ++j)
-  {
-  for(int j =0; j<3; ++j)
-  {
-  int id = i + j;
-  g3x_g4x.block(id, j*size     , 1, size)   = g3.row(i);
-  g3x_g4x.block(id, j*size + ptOff, 1, size)   = g4.row(i);
-  g3x_g4x.block(id, j*size + prptOff, 1, size)  -= MatrixX::Ones(1, size);
-  }
-  }
-  */
-  /*the fourth constraint is x.. = 1/2(H3x + H4x.) => 1/2(H3x + H4x.) - x.. = 0
-  => H3x + H4x. - 2x.. = 0
-  this will give us size * 3 inequalities constraints
-  So this line of A will be writen
-  H2 -H1 0 0 0 0
-  */
-  MatrixX h3x_h4x = MatrixX::Zero(size * Dim, numvar);
-  /**A looks something like that : (n = size)
-  [H3(0)  0      0     H4(0) 0-------------------0 -2 0]
-  [ 0  0  H3(0)  0       0   H4(0)---------------0 -2 0]
-  [ 0  0  0      H3(0)   0     0     H4(0)-------0 -2 0]
-  ...
-  [ 0  0  0      0   H3(n)   0    0      0     H4(n)-0 -2 0] // row n
-
-  Overall it's fairly easy to fill
-  */
-  for (int i = 0; i < size * Dim; i = i + Dim) {
-    for (int j = 0; j < Dim; ++j) {
-      int id = i + j;
-      h3x_h4x.block(id, j * size, 1, size) = h3.row(i % 3);
-      h3x_h4x.block(id, j * size + ptOff, 1, size) = h4.row(i % 3);
-      h3x_h4x.block(id, j * size + ptptOff, 1, size) = MatrixX::Ones(1, size) * -2;
-    }
-  }
-
-  /*the following constraints are easy to understand*/
-
-  /*x0,: = x^0*/
-  MatrixX x0_x0 = MatrixX::Zero(Dim, numvar);
-  for (int j = 0; j < Dim; ++j) {
-    x0_x0(0, 0) = 1;
-    x0_x0(1, size) = 1;
-    x0_x0(2, size * 2) = 1;
-  }
-
-  /*x0.,: = 0*/
-  MatrixX x0p_0 = MatrixX::Zero(Dim, numvar);
-  for (int j = 0; j < Dim; ++j) {
-    x0p_0(0, ptOff) = 1;
-    x0p_0(1, ptOff + size) = 1;
-    x0p_0(2, ptOff + size * 2) = 1;
-  }
-
-  /*xt,: = x^t*/
-  MatrixX xt_xt = MatrixX::Zero(Dim, numvar);
-  for (int j = 0; j < Dim; ++j) {
-    xt_xt(0, size - 1) = 1;
-    xt_xt(1, 2 * size - 1) = 1;
-    xt_xt(2, 3 * size - 1) = 1;
-  }
-
-  /*xT.,: = 0*/
-  MatrixX xtp_0 = MatrixX::Zero(Dim, numvar);
-  for (int j = 0; j < Dim; ++j) {
-    xtp_0(0, ptOff + size - 1) = 1;
-    xtp_0(1, ptOff + size + size - 1) = 1;
-    xtp_0(2, ptOff + size * 2 + size - 1) = 1;
-  }
-
-  // skipping constraints on x and y accelerations for the time being
-  // to compute A i'll create an eigen matrix, then i'll convert it to a sparse one and fill those tables
-
-  // total number of constraints
-  // NOG h2x_h1x (size * Dim) + h3x_h4x (size * Dim ) + g1x_g2x (size * Dim ) + g3x_g4x (size*Dim)
-  // NOG + x0_x0 (Dim ) + x0p_0 (Dim) + xt_xt (Dim)  + xtp_0 (Dim) = 4 * Dim * size + 4 * Dim
-  // h2x_h1x (size * Dim) + h3x_h4x (size * Dim )
-  // + x0_x0 (Dim ) + x0p_0 (Dim) + xt_xt (Dim)  + xtp_0 (Dim) = 2 * Dim * size + 4 * Dim
-  // NOG const MSKint32t numcon = 12 * size + 12;
-  const MSKint32t numcon = Dim * 2 * size + 4 * Dim;  // TODO
-
-  // this gives us the matrix A of size numcon * numvaar
-  MatrixX a = MatrixX::Zero(numcon, numvar);
-  a.block(0, 0, size * Dim, numvar) = h2x_h1x;
-  a.block(size * Dim, 0, size * Dim, numvar) = h3x_h4x;
-  a.block(size * Dim * 2, 0, Dim, numvar) = x0p_0;
-  a.block(size * Dim * 2 + Dim, 0, Dim, numvar) = xtp_0;
-  a.block(size * Dim * 2 + Dim * 2, 0, Dim, numvar) = x0_x0;
-  a.block(size * Dim * 2 + Dim * 3, 0, Dim, numvar) = xt_xt;
-
-  // convert to sparse representation
-  Eigen::SparseMatrix<Numeric> spA;
-  spA = a.sparseView();
-
-  // convert to sparse representation using column
-  // http://docs.mosek.com/7.0/capi/Conventions_employed_in_the_API.html#sec-intro-subsubsec-cmo-rmo-matrix
-
-  int nonZeros = spA.nonZeros();
-
-  /* Below is the sparse representation of the A
-  matrix stored by column. */
-  double* aval = new double[nonZeros];
-  MSKint32t* asub = new MSKint32t[nonZeros];
-  MSKint32t* aptrb = new MSKint32t[numvar];
-  MSKint32t* aptre = new MSKint32t[numvar];
-
-  int currentIndex = 0;
-  for (int j = 0; j < numvar; ++j) {
-    bool nonZeroAtThisCol = false;
-    for (int i = 0; i < numcon; ++i) {
-      if (a(i, j) != 0) {
-        if (!nonZeroAtThisCol) {
-          aptrb[j] = currentIndex;
-          nonZeroAtThisCol = true;
-        }
-        aval[currentIndex] = a(i, j);
-        asub[currentIndex] = i;
-        aptre[j] = currentIndex + 1;  // overriding previous value
-        ++currentIndex;
-      }
-    }
-  }
-
-  /*Q looks like this
-  0 0 0 0 0 0  | -> size * 3
-  0 0 2 0 0 0  | -> size *3
-  0 0 0 0 0 0
-  0 0 0 0 2 0
-  0 0 0 0 0 0
+  const int numvar = size * (int)Dim * 3;
+  const int ptOff = (int)Dim * size;        // . offest
+  const int ptptOff = (int)Dim * 2 * size;  // .. offest
+
+  /* the constraint matrix is filled directly in sparse form, its rows are :
+  - H2x - H1x. = 0 : continuity of the accelerations, size * Dim rows (the first and last rows of H1, H2 are empty)
+  - H3x + H4x. - x.. = 0 : accelerations at the beginning of each segment, size * Dim rows
+  - x0. = 0, xT. = 0, x0 = x^0, xT = x^T : Dim rows each
   */
-  /* Number of non-zeros in Q.*/
-  const MSKint32t numqz = size * Dim * 2;
-  MSKint32t* qsubi = new MSKint32t[numqz];
-  MSKint32t* qsubj = new MSKint32t[numqz];
-  double* qval = new double[numqz];
-  for (int id = 0; id < numqz; ++id) {
-    qsubi[id] = id + ptOff;  // we want the x.
-    qsubj[id] = id + ptOff;
-    qval[id] = 2;
-  }
-
-  /* Bounds on constraints. */
-  MSKboundkeye* bkc = new MSKboundkeye[numcon];
-
-  double* blc = new double[numcon];
-  double* buc = new double[numcon];
-
-  for (int i = 0; i < numcon - Dim * 2; ++i) {
-    bkc[i] = MSK_BK_FX;
-    blc[i] = 0;
-    buc[i] = 0;
-  }
-  for (int i = numcon - Dim * 2; i < numcon - Dim; ++i)  // x0 = x^0
-  {
-    bkc[i] = MSK_BK_FX;
-    blc[i] = wayPointsBegin->second(i - (numcon - Dim * 2));
-    buc[i] = wayPointsBegin->second(i - (numcon - Dim * 2));
-  }
+  const int numcon = (int)Dim * 2 * size + 4 * (int)Dim;
+  std::vector<triplet_t> triplets;
+  triplets.reserve(Dim * size * 13 + 4 * Dim);
+  AppendBlock(h2, size, 0, 0, size, triplets);
+  AppendBlock(-h1, size, ptOff, 0, size, triplets);
+  AppendBlock(h3, size, 0, size * (int)Dim, size, triplets);
+  AppendBlock(h4, size, ptOff, size * (int)Dim, size, triplets);
+  const int boundRow = size * (int)Dim * 2;
+  for (int j = 0; j < (int)Dim; ++j) {
+    for (int i = 0; i + 1 < size; ++i)
+      triplets.push_back(triplet_t(size * ((int)Dim + j) + i, ptptOff + j * size + i, -1));
+    triplets.push_back(triplet_t(boundRow + j, ptOff + j * size, 1));
+    triplets.push_back(triplet_t(boundRow + (int)Dim + j, ptOff + j * size + size - 1, 1));
+    triplets.push_back(triplet_t(boundRow + 2 * (int)Dim + j, j * size, 1));
+    triplets.push_back(triplet_t(boundRow + 3 * (int)Dim + j, j * size + size - 1, 1));
+  }
+  SparseMatrixX a(numcon, numvar);
+  a.setFromTriplets(triplets.begin(), triplets.end());
+
+  /* Bounds on constraints, all of them are equalities. */
+  VectorX bounds = VectorX::Zero(numcon);
   In last(wayPointsEnd);
   --last;
-  for (int i = numcon - 3; i < numcon; ++i)  // xT = x^T
-  {
-    bkc[i] = MSK_BK_FX;
-    blc[i] = last->second(i - (numcon - Dim));
-    buc[i] = last->second(i - (numcon - Dim));
-  }
-
-  ///*No Bounds on variables. */
-  MSKboundkeye* bkx = new MSKboundkeye[numvar];
-
-  double* blx = new double[numvar];
-  double* bux = new double[numvar];
-
-  for (int i = 0; i < numvar; ++i) {
-    bkx[i] = MSK_BK_FR;
-    blx[i] = -MSK_INFINITY;
-    bux[i] = +MSK_INFINITY;
-  }
-
-  MSKrescodee r;
-  MSKtask_t task = NULL;
-  /* Create the optimization task. */
-  r = MSK_maketask(env_, numcon, numvar, &task);
-
-  /* Directs the log task stream to the 'printstr' function. */
-  /*if ( r==MSK_RES_OK )
-  r = MSK_linkfunctotaskstream(task,MSK_STREAM_LOG,NULL,printstr);*/
-
-  /* Append 'numcon' empty constraints.
-  The constraints will initially have no bounds. */
-  if (r == MSK_RES_OK) {
-    r = MSK_appendcons(task, numcon);
-  }
-
-  /* Append 'numvar' variables.
-  The variables will initially be fixed at zero (x=0). */
-  if (r == MSK_RES_OK) {
-    r = MSK_appendvars(task, numvar);
-  }
-
-  for (int j = 0; j < numvar && r == MSK_RES_OK; ++j) {
-    /* Set the linear term c_j in the objective.*/
-    if (r == MSK_RES_OK) {
-      r = MSK_putcj(task, j, 0);
-    }
-    /* Set the bounds on variable j.
-    blx[j] <= x_j <= bux[j] */
-    if (r == MSK_RES_OK) {
-      r = MSK_putvarbound(task, j, /* Index of variable.*/
-                          bkx[j],  /* Bound key.*/
-                          blx[j],  /* Numerical value of lower bound.*/
-                          bux[j]); /* Numerical value of upper bound.*/
-    }
-    /* Input column j of A */
-    if (r == MSK_RES_OK) {
-      r = MSK_putacol(task, j,             /* Variable (column) index.*/
-                      aptre[j] - aptrb[j], /* Number of non-zeros in column j.*/
-                      asub + aptrb[j],     /* Pointer to row indexes of column j.*/
-                      aval + aptrb[j]);    /* Pointer to Values of column j.*/
-    }
-  }
-
-  /* Set the bounds on constraints.
-  for i=1, ...,numcon : blc[i] <= constraint i <= buc[i] */
-  for (int i = 0; i < numcon && r == MSK_RES_OK; ++i) {
-    r = MSK_putconbound(task, i, /* Index of constraint.*/
-                        bkc[i],  /* Bound key.*/
-                        blc[i],  /* Numerical value of lower bound.*/
-                        buc[i]); /* Numerical value of upper bound.*/
-  }
-
-  /* Maximize objective function. */
-  if (r == MSK_RES_OK) {
-    r = MSK_putobjsense(task, MSK_OBJECTIVE_SENSE_MINIMIZE);
-  }
-
-  if (r == MSK_RES_OK) {
-    /* Input the Q for the objective. */
-    r = MSK_putqobj(task, numqz, qsubi, qsubj, qval);
-  }
-
-  if (r == MSK_RES_OK) {
-    MSKrescodee trmcode;
-
-    /* Run optimizer */
-    r = MSK_optimizetrm(task, &trmcode);
-    if (r == MSK_RES_OK) {
-      double* xx = (double*)calloc(numvar, sizeof(double));
-      if (xx) {
-        /* Request the interior point solution. */
-        MSK_getxx(task, MSK_SOL_ITR, xx);
-        T_waypoints_t nwaypoints;
-        In begin(wayPointsBegin);
-        for (int i = 0; i < size; i = ++i, ++begin) {
-          point_t target;
-          for (int j = 0; j < Dim; ++j) {
-            target(j) = xx[i + j * size];
-          }
-          nwaypoints.push_back(std::make_pair(begin->first, target));
-        }
-        res = new exact_cubic_t(nwaypoints.begin(), nwaypoints.end());
-        free(xx);
-      }
+  for (int j = 0; j < (int)Dim; ++j) {
+    bounds[boundRow + 2 * (int)Dim + j] = wayPointsBegin->second[j];
+    bounds[boundRow + 3 * (int)Dim + j] = last->second[j];
+  }
+
+  /* the cost is the squared norm of the velocities and accelerations */
+  SparseMatrixX q(numvar, numvar);
+  std::vector<triplet_t> qtriplets;
+  for (int id = ptOff; id < numvar; ++id) qtriplets.push_back(triplet_t(id, id, 1));
+  q.setFromTriplets(qtriplets.begin(), qtriplets.end());
+
+  solver_.setup(q, VectorX::Zero(numvar), a, bounds, bounds);
+  const optimization::qp_result<Numeric>& result = solver_.solve();
+  if (result.status != optimization::QP_SOLVED) return 0;
+  T_waypoints_t nwaypoints;
+  In begin(wayPointsBegin);
+  for (int i = 0; i < size; ++i, ++begin) {
+    point_t target(begin->second);
+    for (int j = 0; j < (int)Dim; ++j) {
+      target(j) = result.x[i + j * size];
     }
+    nwaypoints.push_back(std::make_pair(begin->first, target));
   }
-  /* Delete the task and the associated data. */
-  MSK_deletetask(&task);
-  return res;
+  return new exact_cubic_t(nwaypoints.begin(), nwaypoints.end());
 }  // End SplineOptimizer
 }  // namespace curves
 #endif  //_CLASS_SPLINEOPTIMIZER
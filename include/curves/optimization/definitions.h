@@ -14,6 +14,8 @@
 #include <curves/quadratic_variable.h>
 #include <curves/curve_constraint.h>
 
+#include <Eigen/Sparse>
+
 namespace curves {
 namespace optimization {
 
@@ -37,6 +39,17 @@ struct quadratic_problem {
   quadratic_variable<Numeric> cost;
 };
 
+/// \brief Same as quadratic_problem, with a sparse inequality matrix.
+/// Most of the coefficients of the inequality matrix are zeros for problems with several phases,
+/// since each constraint only depends on the variables of one control point.
+template <typename Point, typename Numeric>
+struct sparse_quadratic_problem {
+  typedef Eigen::SparseMatrix<Numeric> sparse_matrix_t;
+  sparse_matrix_t ineqMatrix;
+  Eigen::Matrix<Numeric, Eigen::Dynamic, 1> ineqVector;
+  quadratic_variable<Numeric> cost;
+};
+
 template <typename Point, typename Numeric>
 struct problem_definition : public curve_constraints<Point> {
   typedef Point point_t;
@@ -11,10 +11,14 @@
 
 #include <curves/bezier_curve.h>
 #include <curves/linear_variable.h>
+#include <curves/sparse_linear_variable.h>
 #include <curves/curve_constraint.h>
 #include <curves/optimization/definitions.h>
 #include <curves/bernstein.h>
 
+#include <map>
+#include <mutex>
+
 namespace curves {
 namespace optimization {
 template <typename Point, typename Numeric, bool Safe = true>
@@ -27,6 +31,7 @@ struct problem_data {
   typedef linear_variable<Numeric> var_t;
   typedef std::vector<var_t> T_var_t;
   typedef bezier_curve<Numeric, Numeric, true, linear_variable<Numeric> > bezier_t;
+  typedef bezier_curve<Numeric, Numeric, true, sparse_linear_variable<Numeric> > sparse_bezier_t;
 
   std::vector<var_t> variables_;   // includes constant variables
   std::size_t numVariables;        // total number of variable (/ DIM for total size)
@@ -69,6 +74,37 @@ LinearVar fill_with_zeros(const LinearVar& var, const std::size_t i, const std::
   return LinearVar(B, var.c());
 }
 
+/// \brief Same as fill_with_zeros, but only the non zero coefficients of the resulting variable are stored.
+template <typename Numeric>
+sparse_linear_variable<Numeric> fill_with_zeros_sparse(const linear_variable<Numeric>& var, const std::size_t i,
+                                                       const std::size_t startVariableIndex,
+                                                       const std::size_t numVariables, const std::size_t Dim) {
+  typedef sparse_linear_variable<Numeric> sparse_var_t;
+  typename sparse_var_t::sparse_matrix_t B(Dim, numVariables * Dim);
+  if (startVariableIndex <= i && i <= startVariableIndex + numVariables - 1 && var.size() > 0) {
+    std::vector<typename sparse_var_t::triplet_t> triplets;
+    const std::size_t col = Dim * (i - startVariableIndex);
+    for (std::size_t r = 0; r < Dim; ++r)
+      for (std::size_t c = 0; c < Dim; ++c)
+        if (var.B()(r, c) != 0) triplets.push_back(typename sparse_var_t::triplet_t(r, col + c, var.B()(r, c)));
+    B.setFromTriplets(triplets.begin(), triplets.end());
+  }
+  return sparse_var_t(B, var.c());
+}
+
+/// \brief Same as compute_linear_control_points, but the control points are sparse linear variables.
+template <typename Point, typename Numeric>
+typename problem_data<Point, Numeric>::sparse_bezier_t compute_sparse_linear_control_points(
+    const problem_data<Point, Numeric>& pData, const Numeric totalTime) {
+  typedef typename problem_data<Point, Numeric>::sparse_bezier_t sparse_bezier_t;
+  typename sparse_bezier_t::t_point_t res;
+  const std::size_t totalvar = pData.variables_.size();
+  for (std::size_t i = 0; i < totalvar; ++i)
+    res.push_back(fill_with_zeros_sparse<Numeric>(pData.variables_[i], i, pData.startVariableIndex,
+                                                  pData.numVariables, pData.dim_));
+  return sparse_bezier_t(res.begin(), res.end(), 0., totalTime);
+}
+
 template <typename Point, typename Numeric, typename Bezier, typename LinearVar>
 Bezier* compute_linear_control_points(const problem_data<Point, Numeric>& pData,
                                       const std::vector<LinearVar>& linearVars, const Numeric totalTime) {
@@ -81,8 +117,10 @@ Bezier* compute_linear_control_points(const problem_data<Point, Numeric>& pData,
   return new Bezier(res.begin(), res.end(), 0., totalTime);
 }
 
+/// \brief Fill the control points of problemData, constant or variable, from the constraints of pDef.
+/// The bezier curve of problemData is not computed, see setup_control_points.
 template <typename Point, typename Numeric, bool Safe>
-problem_data<Point, Numeric, Safe> setup_control_points(const problem_definition<Point, Numeric>& pDef) {
+void setup_variables(const problem_definition<Point, Numeric>& pDef, problem_data<Point, Numeric>& problemData) {
   typedef Numeric num_t;
   typedef Point point_t;
   typedef linear_variable<Numeric> var_t;
@@ -96,8 +134,8 @@ problem_data<Point, Numeric, Safe> setup_control_points(const problem_definition
   if (numActiveConstraints >= numControlPoints)
     throw std::runtime_error("In setup_control_points; too many constraints for the considered degree");
 
-  problem_data_t problemData(pDef.dim_);
   typename problem_data_t::T_var_t& variables_ = problemData.variables_;
+  variables_.clear();
 
   std::size_t numConstants = 0;
   std::size_t i = 0;
@@ -185,9 +223,52 @@ problem_data<Point, Numeric, Safe> setup_control_points(const problem_definition
   problemData.numVariables = numControlPoints - numConstants;
   problemData.startVariableIndex = first_variable_idx;
   problemData.numStateConstraints = numActiveConstraints - problemData.numVariables;
+}
+
+/// \brief Derivative with respect to pDef.totalTime of the constant parts of the control points computed by
+/// setup_variables, zero for the variable control points. Must be kept consistent with setup_variables.
+template <typename Point, typename Numeric>
+std::vector<Eigen::Matrix<Numeric, Eigen::Dynamic, 1> > constant_control_points_time_derivative(
+    const problem_definition<Point, Numeric>& pDef) {
+  typedef Numeric num_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  const std::size_t& degree = pDef.degree;
+  const constraint_flag& flag = pDef.flag;
+  const num_t T = pDef.totalTime;
+  std::vector<vector_x_t> res(degree + 1, vector_x_t::Zero(pDef.dim_));
+  if ((flag & INIT_POS) && (flag & INIT_VEL)) {
+    const vector_x_t vel = -(pDef.init_vel / (num_t)degree) / (T * T);
+    res[1] = vel;
+    if (flag & INIT_ACC) {
+      const vector_x_t acc = -2. * (pDef.init_acc / (num_t)(degree * (degree - 1))) / (T * T * T) + 2 * vel;
+      res[2] = acc;
+      if (flag & INIT_JERK)
+        res[3] = 3. * pDef.init_jerk * T * T / (num_t)(degree * (degree - 1) * (degree - 2)) + 3 * acc - 3 * vel;
+    }
+  }
+  if ((flag & END_POS) && (flag & END_VEL)) {
+    const vector_x_t vel = (pDef.end_vel / (num_t)degree) / (T * T);
+    res[degree - 1] = vel;
+    if (flag & END_ACC) {
+      const vector_x_t acc = 2 * vel;
+      res[degree - 2] = acc;
+      if (flag & END_JERK)
+        res[degree - 3] =
+            -3. * pDef.end_jerk * T * T / (num_t)(degree * (degree - 1) * (degree - 2)) + 3 * acc - 3 * vel;
+    }
+  }
+  return res;
+}
+
+template <typename Point, typename Numeric, bool Safe>
+problem_data<Point, Numeric, Safe> setup_control_points(const problem_definition<Point, Numeric>& pDef) {
+  typedef linear_variable<Numeric> var_t;
+  typedef problem_data<Point, Numeric> problem_data_t;
+  problem_data_t problemData(pDef.dim_);
+  setup_variables<Point, Numeric, Safe>(pDef, problemData);
   problemData.bezier =
       compute_linear_control_points<Point, Numeric, bezier_curve<Numeric, Numeric, true, var_t>, var_t>(
-          problemData, variables_, pDef.totalTime);
+          problemData, problemData.variables_, pDef.totalTime);
   return problemData;
 }
 
@@ -204,6 +285,21 @@ long compute_num_ineq_control_points(const problem_definition<Point, Numeric>& p
   return rows;
 }
 
+/// \brief Split a bezier curve starting at 0 at the given times.
+template <typename Bezier>
+std::vector<Bezier> split_bezier(const Eigen::VectorXd& times, const Bezier& bezier) {
+  std::vector<Bezier> res(1, bezier);
+  res.reserve(times.rows() + 1);
+  for (int i = 0; i < times.rows(); ++i) {
+    // the split times are absolute times, as the bounds of the remaining curve, which is the last one of res
+    const std::pair<Bezier, Bezier> pairsplit = res.back().split(times[i]);
+    res.pop_back();
+    res.push_back(pairsplit.first);
+    res.push_back(pairsplit.second);
+  }
+  return res;
+}
+
 template <typename Point, typename Numeric>
 std::vector<bezier_curve<Numeric, Numeric, true, linear_variable<Numeric> > > split(
     const problem_definition<Point, Numeric>& pDef, problem_data<Point, Numeric>& pData) {
@@ -214,27 +310,57 @@ std::vector<bezier_curve<Numeric, Numeric, true, linear_variable<Numeric> > > sp
   const Eigen::VectorXd& times = pDef.splitTimes_;
   T_bezier_t res;
   bezier_t& current = *pData.bezier;
-  Numeric current_time = 0.;
-  Numeric tmp;
   for (int i = 0; i < times.rows(); ++i) {
-    tmp = times[i];
-    std::pair<bezier_t, bezier_t> pairsplit = current.split(tmp - current_time);
+    std::pair<bezier_t, bezier_t> pairsplit = current.split(times[i]);
     res.push_back(pairsplit.first);
     current = pairsplit.second;
-    current_time += tmp - current_time;
   }
   res.push_back(current);
   return res;
 }
 
+/// \brief Compute the sub-bezier curves, with sparse control points, on which the inequality constraints of pDef
+/// apply.
+/// \param pDef : definition of the problem, its split times are ignored.
+/// \param splitTimes : split times of the curve.
+/// \param bezier : curve of the problem, see compute_sparse_linear_control_points.
 template <typename Point, typename Numeric>
-void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, problem_data<Point, Numeric>& pData,
+std::vector<typename problem_data<Point, Numeric>::sparse_bezier_t> split_inequality_beziers(
+    const problem_definition<Point, Numeric>& pDef, const Eigen::VectorXd& splitTimes,
+    const typename problem_data<Point, Numeric>::sparse_bezier_t& bezier) {
+  std::vector<typename problem_data<Point, Numeric>::sparse_bezier_t> beziers = split_bezier(splitTimes, bezier);
+  if (pDef.inequalityMatrices_.size() != pDef.inequalityVectors_.size()) {
+    throw std::invalid_argument("The sizes of the inequality matrices and vectors do not match.");
+  }
+  if (pDef.inequalityMatrices_.size() != beziers.size()) {
+    throw std::invalid_argument("The sizes of the inequality matrices and the bezier degree do not match.");
+  }
+  return beziers;
+}
+
+template <typename Point, typename Numeric>
+std::vector<typename problem_data<Point, Numeric>::sparse_bezier_t> split_inequality_beziers(
+    const problem_definition<Point, Numeric>& pDef, const problem_data<Point, Numeric>& pData) {
+  return split_inequality_beziers<Point, Numeric>(
+      pDef, pDef.splitTimes_, compute_sparse_linear_control_points<Point, Numeric>(pData, pDef.totalTime));
+}
+
+/// \brief Fill the inequality constraints of prob for the given split times.
+/// \param pDef : definition of the problem, its split times are ignored.
+/// \param splitTimes : split times of the curve.
+/// \param pData : control points of the problem.
+/// \param bezier : curve of the problem, see compute_sparse_linear_control_points.
+/// \param prob : output problem.
+template <typename Point, typename Numeric>
+void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, const Eigen::VectorXd& splitTimes,
+                          const problem_data<Point, Numeric>& pData,
+                          const typename problem_data<Point, Numeric>::sparse_bezier_t& bezier,
                           quadratic_problem<Point, Numeric>& prob) {
   const std::size_t& Dim = pData.dim_;
   typedef problem_definition<Point, Numeric> problem_definition_t;
   typedef typename problem_definition_t::matrix_x_t matrix_x_t;
   typedef typename problem_definition_t::vector_x_t vector_x_t;
-  typedef bezier_curve<Numeric, Numeric, true, linear_variable<Numeric> > bezier_t;
+  typedef typename problem_data<Point, Numeric>::sparse_bezier_t bezier_t;
   typedef std::vector<bezier_t> T_bezier_t;
   typedef typename T_bezier_t::const_iterator CIT_bezier_t;
   typedef typename bezier_t::t_point_t t_point;
@@ -247,15 +373,8 @@ void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, proble
 
   if (pDef.inequalityMatrices_.size() == 0) return;
 
-  // compute sub-bezier curves
-  T_bezier_t beziers = split<Point, Numeric>(pDef, pData);
-
-  if (pDef.inequalityMatrices_.size() != pDef.inequalityVectors_.size()) {
-    throw std::invalid_argument("The sizes of the inequality matrices and vectors do not match.");
-  }
-  if (pDef.inequalityMatrices_.size() != beziers.size()) {
-    throw std::invalid_argument("The sizes of the inequality matrices and the bezier degree do not match.");
-  }
+  // compute sub-bezier curves, with sparse control points
+  T_bezier_t beziers = split_inequality_beziers<Point, Numeric>(pDef, splitTimes, bezier);
 
   long currentRowIdx = 0;
   typename problem_definition_t::CIT_matrix_x_t cmit = pDef.inequalityMatrices_.begin();
@@ -275,38 +394,182 @@ void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, proble
   assert(rows == currentRowIdx);  // we filled all the constraints - NB: leave assert for Debug tests
 }
 
+template <typename Point, typename Numeric>
+void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, problem_data<Point, Numeric>& pData,
+                          quadratic_problem<Point, Numeric>& prob) {
+  initInequalityMatrix<Point, Numeric>(pDef, pDef.splitTimes_, pData,
+                                       compute_sparse_linear_control_points<Point, Numeric>(pData, pDef.totalTime),
+                                       prob);
+}
+
+/// \brief Same as initInequalityMatrix, but the inequality matrix is assembled as a sparse matrix.
+/// Each block of rows only depends on the variables of one control point, only these columns are stored.
+template <typename Point, typename Numeric>
+void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, const Eigen::VectorXd& splitTimes,
+                          const problem_data<Point, Numeric>& pData,
+                          const typename problem_data<Point, Numeric>::sparse_bezier_t& bezier,
+                          sparse_quadratic_problem<Point, Numeric>& prob) {
+  const std::size_t& Dim = pData.dim_;
+  typedef problem_definition<Point, Numeric> problem_definition_t;
+  typedef typename problem_definition_t::vector_x_t vector_x_t;
+  typedef typename sparse_quadratic_problem<Point, Numeric>::sparse_matrix_t sparse_matrix_t;
+  typedef Eigen::Triplet<Numeric> triplet_t;
+  typedef typename problem_data<Point, Numeric>::sparse_bezier_t bezier_t;
+  typedef std::vector<bezier_t> T_bezier_t;
+  typedef typename T_bezier_t::const_iterator CIT_bezier_t;
+  typedef typename bezier_t::t_point_t t_point;
+  typedef typename bezier_t::t_point_t::const_iterator cit_point;
+
+  long cols = pData.numVariables * Dim;
+  long rows = compute_num_ineq_control_points<Point, Numeric>(pDef, pData);
+  prob.ineqMatrix = sparse_matrix_t(rows, cols);
+  prob.ineqVector = vector_x_t::Zero(rows);
+
+  if (pDef.inequalityMatrices_.size() == 0) return;
+
+  T_bezier_t beziers = split_inequality_beziers<Point, Numeric>(pDef, splitTimes, bezier);
+  std::vector<triplet_t> triplets;
+  long currentRowIdx = 0;
+  typename problem_definition_t::CIT_matrix_x_t cmit = pDef.inequalityMatrices_.begin();
+  typename problem_definition_t::CIT_vector_x_t cvit = pDef.inequalityVectors_.begin();
+  vector_x_t column;
+  for (CIT_bezier_t bit = beziers.begin(); bit != beziers.end(); ++bit, ++cvit, ++cmit) {
+    const t_point& wps = bit->waypoints();
+    for (cit_point cit = wps.begin(); cit != wps.end(); ++cit) {
+      const sparse_matrix_t& B = cit->B();
+      // column k of (*cmit) * B, only for the non empty columns of B
+      for (long k = 0; k < B.outerSize(); ++k) {
+        typename sparse_matrix_t::InnerIterator it(B, k);
+        if (!it) continue;
+        column = vector_x_t::Zero(cmit->rows());
+        for (; it; ++it) column += it.value() * cmit->col(it.row());
+        for (long j = 0; j < column.size(); ++j)
+          if (column[j] != 0) triplets.push_back(triplet_t(currentRowIdx + j, k, column[j]));
+      }
+      prob.ineqVector.segment(currentRowIdx, cmit->rows()) = *cvit - (*cmit) * (cit->c());
+      currentRowIdx += cmit->rows();
+    }
+  }
+  assert(rows == currentRowIdx);  // we filled all the constraints - NB: leave assert for Debug tests
+  prob.ineqMatrix.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template <typename Point, typename Numeric>
+void initInequalityMatrix(const problem_definition<Point, Numeric>& pDef, problem_data<Point, Numeric>& pData,
+                          sparse_quadratic_problem<Point, Numeric>& prob) {
+  initInequalityMatrix<Point, Numeric>(pDef, pDef.splitTimes_, pData,
+                                       compute_sparse_linear_control_points<Point, Numeric>(pData, pDef.totalTime),
+                                       prob);
+}
+
+/// \brief Binomial coefficient computed with floating point numbers, to avoid the overflow of bin for high degrees.
+template <typename Numeric>
+Numeric binomial(const unsigned int n, const unsigned int k) {
+  if (k > n) throw std::runtime_error("binomial coefficient higher than degree");
+  Numeric res = 1.;
+  const unsigned int kk = k > n - k ? n - k : k;
+  for (unsigned int i = 1; i <= kk; ++i) res = res * (Numeric)(n - kk + i) / (Numeric)i;
+  return res;
+}
+
+/// \brief Gram matrix of the Bernstein polynomials of degrees deg1 and deg2 over [0, 1]:
+/// \f$ G_{ij} = \int_0^1 B_i^{deg1}(u) B_j^{deg2}(u) du = \frac{\binom{deg1}{i}\binom{deg2}{j}}{\binom{deg1+deg2}{i+j}
+/// (deg1+deg2+1)} \f$. The matrices are computed once for each pair of degrees and shared by all the threads.
+/// \return a (deg1+1) x (deg2+1) matrix.
+template <typename Numeric>
+const Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic>& bernstein_gram_matrix(const unsigned int deg1,
+                                                                                    const unsigned int deg2) {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef std::map<std::pair<unsigned int, unsigned int>, matrix_x_t> T_gram_t;
+  static T_gram_t cache;
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  const std::pair<unsigned int, unsigned int> key(deg1, deg2);
+  typename T_gram_t::const_iterator cit = cache.find(key);
+  if (cit != cache.end()) return cit->second;
+  const unsigned int newDeg = deg1 + deg2;
+  matrix_x_t G(deg1 + 1, deg2 + 1);
+  for (unsigned int i = 0; i <= deg1; ++i)
+    for (unsigned int j = 0; j <= deg2; ++j)
+      G(i, j) = binomial<Numeric>(deg1, i) * binomial<Numeric>(deg2, j) /
+                (binomial<Numeric>(newDeg, i + j) * (Numeric)(newDeg + 1));
+  return cache.insert(std::make_pair(key, G)).first->second;
+}
+
+/// \brief Stack the linear variables [begin, end) in a single matrix B_all and vector c_all.
+/// The rows are ordered by dimension: row d * n + i is the dimension d of the i-th variable,
+/// so that B_all can be seen as a n x (Dim * numVariables) matrix where each column corresponds to one dimension
+/// of one variable.
+template <typename Numeric, typename In>
+void stack_linear_variables(In begin, In end, const long numVariables,
+                            Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic>& B_all,
+                            Eigen::Matrix<Numeric, Eigen::Dynamic, 1>& c_all) {
+  const long n = (long)(std::distance(begin, end));
+  const long Dim = (long)(begin->c().size());
+  B_all.setZero(Dim * n, numVariables);
+  c_all.setZero(Dim * n);
+  long i = 0;
+  for (In it = begin; it != end; ++it, ++i) {
+    if (it->isZero()) continue;
+    for (long d = 0; d < Dim; ++d) {
+      B_all.row(d * n + i) = it->B().row(d);
+      c_all[d * n + i] = it->c()[d];
+    }
+  }
+}
+
+/// \brief Compute the integral over [0, 1] of the product of two bezier curves of linear variables,
+/// \f$ \int_0^1 p_1(u)^T p_2(u) du \f$, as a quadratic variable.
+/// With G the Gram matrix of the Bernstein polynomials, the cost is assembled as
+/// \f$ A = B_1^T (G \otimes I) B_2 \f$, \f$ b = B_1^T (G \otimes I) c_2 + B_2^T (G \otimes I)^T c_1 \f$
+/// and \f$ c = c_1^T (G \otimes I) c_2 \f$. When both curves are the same, only one half of the symmetric matrix A
+/// is computed.
 template <typename Point, typename Numeric, typename In>
 quadratic_variable<Numeric> bezier_product(In PointsBegin1, In PointsEnd1, In PointsBegin2, In PointsEnd2,
                                            const std::size_t /*Dim*/) {
   typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
   unsigned int nPoints1 = (unsigned int)(std::distance(PointsBegin1, PointsEnd1)),
                nPoints2 = (unsigned int)(std::distance(PointsBegin2, PointsEnd2));
   if (nPoints1 <= 0 || nPoints2 <= 0) {
     throw std::runtime_error("This should never happen because an unsigned int cannot go negative without underflowing.");
   }
-  unsigned int deg1 = nPoints1 - 1, deg2 = nPoints2 - 1;
-  unsigned int newDeg = (deg1 + deg2);
-  // the integral of the primitive will simply be the last control points of the primitive,
-  // divided by the degree of the primitive, newDeg. We will store this in matrices for bilinear terms,
-  // and a vector for the linear terms, as well as another one for the constants.
-  quadratic_variable<Numeric> res(vector_x_t::Zero(PointsBegin1->B().cols()));
-  // depending on the index, the fraction coefficient of the bernstein polynom
-  // is either the fraction given by  (i+j)/ (deg1+deg2), or 1 - (i+j)/ (deg1+deg2).
-  // The trick is that the condition is given by whether the current index in
-  // the combinatorial is odd or even.
-  // time parametrization is not relevant for the cost
-
-  Numeric ratio;
-  for (unsigned int i = 0; i < newDeg + 1; ++i) {
-    unsigned int j = i > deg2 ? i - deg2 : 0;
-    for (; j < std::min(deg1, i) + 1; ++j) {
-      ratio = (Numeric)(bin(deg1, j) * bin(deg2, i - j)) / (Numeric)(bin(newDeg, i));
-      In itj = PointsBegin1 + j;
-      In iti = PointsBegin2 + (i - j);
-      res += ((*itj) * (*iti)) * ratio;
-    }
+  const bool symmetric = (PointsBegin1 == PointsBegin2 && PointsEnd1 == PointsEnd2);
+  const long numVariables = (long)(PointsBegin1->B().cols());
+  const long Dim = (long)(PointsBegin1->c().size());
+  const matrix_x_t& G = bernstein_gram_matrix<Numeric>(nPoints1 - 1, nPoints2 - 1);
+
+  matrix_x_t B1, B2;
+  vector_x_t c1, c2;
+  stack_linear_variables<Numeric>(PointsBegin1, PointsEnd1, numVariables, B1, c1);
+  if (!symmetric) stack_linear_variables<Numeric>(PointsBegin2, PointsEnd2, numVariables, B2, c2);
+  const matrix_x_t& B2_ref = symmetric ? B1 : B2;
+  const vector_x_t& c2_ref = symmetric ? c1 : c2;
+
+  // (G x I) B2 : B2 is seen as a nPoints2 x (Dim * numVariables) matrix, single product with G
+  matrix_x_t GB2(nPoints1 * Dim, numVariables);
+  Eigen::Map<matrix_x_t>(GB2.data(), nPoints1, Dim * numVariables).noalias() =
+      G * Eigen::Map<const matrix_x_t>(B2_ref.data(), nPoints2, Dim * numVariables);
+  vector_x_t Gc2(nPoints1 * Dim);
+  Eigen::Map<matrix_x_t>(Gc2.data(), nPoints1, Dim).noalias() =
+      G * Eigen::Map<const matrix_x_t>(c2_ref.data(), nPoints2, Dim);
+
+  matrix_x_t A(matrix_x_t::Zero(numVariables, numVariables));
+  vector_x_t b;
+  if (symmetric) {
+    A.template triangularView<Eigen::Lower>() += B1.transpose() * GB2;
+    A = A.template selfadjointView<Eigen::Lower>();
+    b = 2. * (B1.transpose() * Gc2);
+  } else {
+    A.noalias() = B1.transpose() * GB2;
+    A = 0.5 * (A + A.transpose()).eval();
+    vector_x_t Gtc1(nPoints2 * Dim);
+    Eigen::Map<matrix_x_t>(Gtc1.data(), nPoints2, Dim).noalias() =
+        G.transpose() * Eigen::Map<const matrix_x_t>(c1.data(), nPoints1, Dim);
+    b = B1.transpose() * Gc2 + B2_ref.transpose() * Gtc1;
   }
-  return res / (newDeg + 1);
+  const Numeric c = c1.dot(Gc2);
+  return quadratic_variable<Numeric>(A, b, c);
 }
 
 inline constraint_flag operator~(constraint_flag a) {
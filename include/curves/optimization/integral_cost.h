@@ -26,17 +26,113 @@ enum integral_cost_flag {
   FIFTH = 0x005
 };
 
+/// \struct integral_cost_structure.
+/// \brief Parametric form of the integral cost of order num_derivate of a problem.
+/// The matrices only depend on the structure of the problem (dimension, degree and the position of the variables
+/// given by the constraint flag), and not on the values of the constant control points, which are the only part
+/// depending on the boundary conditions and on the total time.
+/// With c_all the stacked constant parts of the control points (row d * n + i is the dimension d of the i-th
+/// control point), the cost is x^T A x + 2 c_all^T HB x + c_all^T (I x H) c_all.
+template <typename Numeric>
+struct integral_cost_structure {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+
+  /// \brief Cost for the constant parts c_all of the control points.
+  quadratic_variable<Numeric> evaluate(const vector_x_t& c_all) const {
+    const long n = H.rows(), Dim = c_all.size() / n;
+    const matrix_x_t Hc(H * Eigen::Map<const matrix_x_t>(c_all.data(), n, Dim));
+    const vector_x_t b = 2. * (HB.transpose() * c_all);
+    return quadratic_variable<Numeric>(A, b, c_all.dot(Eigen::Map<const vector_x_t>(Hc.data(), Dim * n)));
+  }
+
+  matrix_x_t H;   // integral of the products of the num_derivate-th derivatives of the bernstein polynomials
+  matrix_x_t HB;  // (I x H) B_all, B_all being the stacked linear parts of the control points
+  matrix_x_t A;   // B_all^T (I x H) B_all, quadratic part of the cost
+};
+
+/// \brief Stack the constant parts of the control points of pData, row d * n + i is the dimension d
+/// of the i-th control point.
+template <typename Point, typename Numeric>
+void stack_constant_parts(const problem_data<Point, Numeric>& pData,
+                          Eigen::Matrix<Numeric, Eigen::Dynamic, 1>& c_all) {
+  const long n = (long)(pData.numControlPoints), Dim = (long)(pData.dim_);
+  c_all.resize(Dim * n);
+  for (long i = 0; i < n; ++i)
+    for (long d = 0; d < Dim; ++d) c_all[d * n + i] = pData.variables_[i].c()[d];
+}
+
+/// \brief Compute the parametric form of the integral cost of order num_derivate, see integral_cost_structure.
+template <typename Point, typename Numeric>
+integral_cost_structure<Numeric> compute_integral_cost_structure(const problem_data<Point, Numeric>& pData,
+                                                                 const std::size_t num_derivate) {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  const long n = (long)(pData.numControlPoints), Dim = (long)(pData.dim_);
+  const long numVariables = (long)(pData.numVariables * pData.dim_);
+  // D maps the control points to the control points of the derivative, see bezier_curve::compute_derivate
+  matrix_x_t D(matrix_x_t::Identity(n, n));
+  long degree = n - 1;
+  for (std::size_t k = 0; k < num_derivate; ++k) {
+    if (degree == 0) {
+      D = matrix_x_t::Zero(1, n);
+      break;
+    }
+    matrix_x_t Dk(matrix_x_t::Zero(degree, degree + 1));
+    for (long i = 0; i < degree; ++i) {
+      Dk(i, i) = -(Numeric)degree;
+      Dk(i, i + 1) = (Numeric)degree;
+    }
+    D = (Dk * D).eval();
+    --degree;
+  }
+  integral_cost_structure<Numeric> res;
+  res.H = D.transpose() * bernstein_gram_matrix<Numeric>((unsigned int)degree, (unsigned int)degree) * D;
+  matrix_x_t B_all(matrix_x_t::Zero(Dim * n, numVariables));
+  for (long i = 0; i < n; ++i) {
+    const typename problem_data<Point, Numeric>::var_t& var = pData.variables_[i];
+    const long idx = i - (long)(pData.startVariableIndex);
+    if (idx < 0 || idx >= (long)(pData.numVariables) || var.size() == 0) continue;
+    for (long d = 0; d < Dim; ++d) B_all.block(d * n + i, Dim * idx, 1, Dim) = var.B().row(d);
+  }
+  res.HB.resize(Dim * n, numVariables);
+  Eigen::Map<matrix_x_t>(res.HB.data(), n, Dim * numVariables).noalias() =
+      res.H * Eigen::Map<const matrix_x_t>(B_all.data(), n, Dim * numVariables);
+  res.A = matrix_x_t::Zero(numVariables, numVariables);
+  res.A.template triangularView<Eigen::Lower>() += B_all.transpose() * res.HB;
+  res.A = res.A.template selfadjointView<Eigen::Lower>();
+  return res;
+}
+
+/// \brief Return the parametric form of the integral cost of order num_derivate for the structure of pData.
+/// The structures are computed once for each dimension, degree, derivative order and position of the variables
+/// (determined by the constraint flag) and shared by all the threads, so that generating a problem with the same
+/// structure but new boundary conditions or total time only requires a few matrix vector products.
+template <typename Point, typename Numeric>
+const integral_cost_structure<Numeric>& get_integral_cost_structure(const problem_data<Point, Numeric>& pData,
+                                                                    const std::size_t num_derivate) {
+  typedef std::vector<std::size_t> key_t;
+  typedef std::map<key_t, integral_cost_structure<Numeric> > T_structure_t;
+  static T_structure_t cache;
+  static std::mutex mutex;
+  key_t key(5);
+  key[0] = pData.dim_;
+  key[1] = pData.numControlPoints;
+  key[2] = pData.startVariableIndex;
+  key[3] = pData.numVariables;
+  key[4] = num_derivate;
+  std::lock_guard<std::mutex> lock(mutex);
+  typename T_structure_t::const_iterator cit = cache.find(key);
+  if (cit != cache.end()) return cit->second;
+  return cache.insert(std::make_pair(key, compute_integral_cost_structure<Point, Numeric>(pData, num_derivate)))
+      .first->second;
+}
+
 template <typename Point, typename Numeric>
 quadratic_variable<Numeric> compute_integral_cost_internal(const problem_data<Point, Numeric>& pData,
                                                            const std::size_t num_derivate) {
-  typedef bezier_curve<Numeric, Numeric, true, linear_variable<Numeric> > bezier_t;
-  typedef typename bezier_t::t_point_t t_point_t;
-  typedef typename t_point_t::const_iterator cit_point_t;
-  bezier_t acc = pData.bezier->compute_derivate(num_derivate);
-  const t_point_t& wps = acc.waypoints();
-  quadratic_variable<Numeric> res(
-      bezier_product<Point, Numeric, cit_point_t>(wps.begin(), wps.end(), wps.begin(), wps.end(), pData.dim_));
-  return res;
+  Eigen::Matrix<Numeric, Eigen::Dynamic, 1> c_all;
+  stack_constant_parts(pData, c_all);
+  return get_integral_cost_structure<Point, Numeric>(pData, num_derivate).evaluate(c_all);
 }
 
 template <typename Point, typename Numeric>
@@ -0,0 +1,270 @@
+/**
+ * \file least_squares_fitting.h
+ * \brief Least squares fitting of a piecewise bezier curve to a stream of samples.
+ *
+ * The control points of the segments are the variables. Each sample adds the outer product of the Bernstein basis
+ * at its time to the normal matrix of its segment, so that the memory does not depend on the number of samples. The
+ * constraints of the problem definition and the continuity between the segments are equalities, and the problem is
+ * solved once with the KKT system, all the dimensions sharing the same matrix.
+ */
+
+#ifndef _CLASS_LEAST_SQUARES_FITTING
+#define _CLASS_LEAST_SQUARES_FITTING
+
+#include "curves/bernstein.h"
+#include "curves/optimization/definitions.h"
+#include "curves/parallel.h"
+
+#include <Eigen/SparseCore>
+#include <Eigen/SparseLU>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+namespace optimization {
+
+/// \class least_squares_fitter.
+/// \brief Fit a piecewise bezier curve of given degree and split times to samples \f$ (t_k, p_k) \f$, minimizing
+/// \f$ \sum_k w_k \| c(t_k) - p_k \|^2 \f$.
+///
+template <typename Point, typename Numeric>
+struct least_squares_fitter {
+  typedef Point point_t;
+  typedef Numeric num_t;
+  typedef problem_definition<Point, Numeric> problem_definition_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef Eigen::SparseMatrix<Numeric> sparse_matrix_t;
+  typedef Eigen::Triplet<Numeric> triplet_t;
+  typedef bezier_curve<Numeric, Numeric, true, Point> bezier_t;
+  typedef typename bezier_t::t_point_t t_point_t;
+  typedef typename bezier_t::piecewise_curve_t piecewise_curve_t;
+
+  /* Constructors - destructors */
+ public:
+  /// \brief Constructor.
+  /// \param pDef : the degree, total time and split times of the curve, and the constraints applied on its ends
+  /// according to pDef.flag. The inequality constraints are ignored.
+  /// \param continuity : order of the derivatives that are continuous at the split times.
+  explicit least_squares_fitter(const problem_definition_t& pDef, const std::size_t continuity = 1)
+      : pDef_(pDef), continuity_(continuity), dim_(pDef.dim_), degree_(pDef.degree) {
+    if (continuity > degree_) throw std::invalid_argument("least_squares_fitter : the continuity exceeds the degree");
+    knots_.push_back(0.);
+    for (long i = 0; i < pDef.splitTimes_.size(); ++i) knots_.push_back(pDef.splitTimes_[i]);
+    knots_.push_back(pDef.totalTime);
+    for (std::size_t i = 0; i + 1 < knots_.size(); ++i) {
+      if (!(knots_[i + 1] > knots_[i]))
+        throw std::invalid_argument("least_squares_fitter : the split times must be increasing in ]0, totalTime[");
+    }
+    stats_.init(knots_.size() - 1, degree_, dim_);
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Add a sample.
+  /// \param t : time of the sample, in [0, pDef.totalTime].
+  /// \param pt : position of the sample.
+  /// \param weight : weight of the sample in the cost.
+  void add_sample(const num_t t, const point_t& pt, const num_t weight = 1.) {
+    stats_.add(knots_, t, pt, weight);
+  }
+
+  /// \brief Add the samples (times[k], points[k]) with a unit weight. The samples are split in a bounded number
+  /// of contiguous ranges accumulated by different threads, the result does not depend on the number of threads.
+  /// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+  void add_samples(const std::vector<num_t>& times, const t_point_t& points, const std::size_t num_threads = 0) {
+    accumulate_samples(times, points, 0, num_threads);
+  }
+
+  /// \brief Add the samples (times[k], points[k]) with the weights weights[k], see add_samples.
+  void add_samples(const std::vector<num_t>& times, const t_point_t& points, const std::vector<num_t>& weights,
+                   const std::size_t num_threads = 0) {
+    if (weights.size() != times.size())
+      throw std::invalid_argument("least_squares_fitter : the times and weights must have the same size");
+    accumulate_samples(times, points, &weights, num_threads);
+  }
+
+  /// \brief Add the samples of other, which must have been built with the same problem definition, for instance
+  /// to accumulate the samples in several threads.
+  void merge(const least_squares_fitter& other) {
+    if (other.knots_ != knots_ || other.degree_ != degree_ || other.dim_ != dim_)
+      throw std::invalid_argument("least_squares_fitter : the fitters do not have the same segments");
+    stats_.merge(other.stats_);
+  }
+
+  /// \brief Number of samples added.
+  std::size_t num_samples() const { return stats_.count; }
+
+  /// \brief Compute the curve minimizing the weighted squared distance to the samples under the constraints.
+  /// \return the fitted curve, with one bezier curve per segment.
+  piecewise_curve_t solve() const {
+    const std::size_t num_segments = knots_.size() - 1, size = degree_ + 1;
+    const long num_vars = (long)(num_segments * size);
+    std::vector<triplet_t> triplets;
+    for (std::size_t s = 0; s < num_segments; ++s) {
+      for (std::size_t i = 0; i < size; ++i) {
+        for (std::size_t j = 0; j < size; ++j) {
+          if (stats_.normal[s](i, j) != 0)
+            triplets.push_back(triplet_t((int)(s * size + i), (int)(s * size + j), stats_.normal[s](i, j)));
+        }
+      }
+    }
+    // equality constraints, appended below the normal matrix
+    std::vector<matrix_x_t> rhs;
+    int row = (int)num_vars;
+    vector_x_t coefs;
+    for (std::size_t s = 0; s + 1 < num_segments; ++s) {
+      for (std::size_t r = 0; r <= continuity_; ++r, ++row) {
+        derivative_coefficients(s, r, true, coefs);
+        append_row(row, s, coefs, 1., triplets);
+        derivative_coefficients(s + 1, r, false, coefs);
+        append_row(row, s + 1, coefs, -1., triplets);
+        rhs.push_back(matrix_x_t::Zero(1, dim_));
+      }
+    }
+    const constraint_flag flags[8] = {INIT_POS, INIT_VEL, INIT_ACC, INIT_JERK, END_POS, END_VEL, END_ACC, END_JERK};
+    const point_t* values[8] = {&pDef_.init_pos, &pDef_.init_vel, &pDef_.init_acc, &pDef_.init_jerk,
+                                &pDef_.end_pos,  &pDef_.end_vel,  &pDef_.end_acc,  &pDef_.end_jerk};
+    for (std::size_t k = 0; k < 8; ++k) {
+      if (!(pDef_.flag & flags[k])) continue;
+      const std::size_t order = k % 4;
+      if (order > degree_)
+        throw std::invalid_argument("least_squares_fitter : the degree is too low for the constraints");
+      const std::size_t s = k < 4 ? 0 : num_segments - 1;
+      derivative_coefficients(s, order, k >= 4, coefs);
+      append_row(row, s, coefs, 1., triplets);
+      rhs.push_back(values[k]->transpose());
+      ++row;
+    }
+    sparse_matrix_t kkt(row, row);
+    // symmetric part of the constraints
+    for (std::size_t i = 0, n = triplets.size(); i < n; ++i) {
+      if (triplets[i].row() >= num_vars)
+        triplets.push_back(triplet_t(triplets[i].col(), triplets[i].row(), triplets[i].value()));
+    }
+    kkt.setFromTriplets(triplets.begin(), triplets.end());
+    matrix_x_t b = matrix_x_t::Zero(row, dim_);
+    for (std::size_t s = 0; s < num_segments; ++s) b.block(s * size, 0, size, dim_) = stats_.moments[s];
+    for (std::size_t i = 0; i < rhs.size(); ++i) b.row(num_vars + (long)i) = rhs[i];
+    Eigen::SparseLU<sparse_matrix_t> solver;
+    solver.compute(kkt);
+    if (solver.info() != Eigen::Success)
+      throw std::runtime_error("least_squares_fitter : not enough samples to determine the control points");
+    const matrix_x_t x = solver.solve(b);
+    if (solver.info() != Eigen::Success || !x.allFinite())
+      throw std::runtime_error("least_squares_fitter : not enough samples to determine the control points");
+    piecewise_curve_t res;
+    for (std::size_t s = 0; s < num_segments; ++s) {
+      t_point_t control_points;
+      for (std::size_t i = 0; i < size; ++i) control_points.push_back(x.row(s * size + i).transpose());
+      res.add_curve(bezier_t(control_points.begin(), control_points.end(), knots_[s], knots_[s + 1]));
+    }
+    return res;
+  }
+  /*Operations*/
+
+ private:
+  /// \brief Sufficient statistics of the samples : for each segment, the normal matrix \f$ \sum_k w_k B_k B_k^T \f$
+  /// and the moments \f$ \sum_k w_k B_k p_k^T \f$, B_k being the Bernstein basis at the time of the sample k.
+  struct statistics_t {
+    statistics_t() : count(0) {}
+
+    void init(const std::size_t num_segments, const std::size_t degree, const std::size_t dim) {
+      normal.assign(num_segments, matrix_x_t::Zero(degree + 1, degree + 1));
+      moments.assign(num_segments, matrix_x_t::Zero(degree + 1, dim));
+      basis = vector_x_t::Zero(degree + 1);
+      count = 0;
+    }
+
+    void add(const std::vector<num_t>& knots, const num_t t, const point_t& pt, const num_t weight) {
+      if (t < knots.front() || t > knots.back())
+        throw std::invalid_argument("least_squares_fitter : the time of the sample is outside of the curve");
+      if ((std::size_t)pt.size() != (std::size_t)moments.front().cols())
+        throw std::invalid_argument("least_squares_fitter : the sample does not have the dimension of the curve");
+      const std::size_t s =
+          std::min((std::size_t)(std::upper_bound(knots.begin(), knots.end(), t) - knots.begin()), knots.size() - 1) -
+          1;
+      const num_t u = (t - knots[s]) / (knots[s + 1] - knots[s]);
+      // Bernstein basis of degree n at u, computed by successive elevations of the degree
+      const long n = basis.size() - 1;
+      basis.setZero();
+      basis[0] = 1.;
+      for (long k = 1; k <= n; ++k) {
+        for (long j = k; j > 0; --j) basis[j] = (1 - u) * basis[j] + u * basis[j - 1];
+        basis[0] *= (1 - u);
+      }
+      normal[s].noalias() += weight * basis * basis.transpose();
+      moments[s].noalias() += weight * basis * pt.transpose();
+      ++count;
+    }
+
+    void merge(const statistics_t& other) {
+      for (std::size_t s = 0; s < normal.size(); ++s) {
+        normal[s] += other.normal[s];
+        moments[s] += other.moments[s];
+      }
+      count += other.count;
+    }
+
+    std::vector<matrix_x_t> normal;
+    std::vector<matrix_x_t> moments;
+    vector_x_t basis;  // buffer
+    std::size_t count;
+  };
+
+  /// \brief Coefficients of the control points of the segment s in its derivative of order r at its start, or at
+  /// its end if at_end is true.
+  void derivative_coefficients(const std::size_t s, const std::size_t r, const bool at_end, vector_x_t& coefs) const {
+    const num_t duration = knots_[s + 1] - knots_[s];
+    num_t factor = 1.;
+    for (std::size_t i = 0; i < r; ++i) factor *= (num_t)(degree_ - i) / duration;
+    coefs = vector_x_t::Zero(degree_ + 1);
+    const std::size_t first = at_end ? degree_ - r : 0;
+    for (std::size_t i = 0; i <= r; ++i)
+      coefs[first + i] = factor * bin((unsigned int)r, (unsigned int)i) * ((r - i) % 2 == 0 ? 1. : -1.);
+  }
+
+  /// \brief Accumulate the samples in at most max_ranges statistics, so that the memory does not depend on the
+  /// number of samples. The ranges only depend on the number of samples, which makes the sums deterministic.
+  /// \param weights : weights of the samples, a null pointer for unit weights.
+  void accumulate_samples(const std::vector<num_t>& times, const t_point_t& points,
+                          const std::vector<num_t>* weights, const std::size_t num_threads) {
+    if (times.size() != points.size())
+      throw std::invalid_argument("least_squares_fitter : the times and points must have the same size");
+    const std::size_t min_range_size = 4096, max_ranges = 64;
+    const std::size_t num_ranges = std::min(max_ranges, (times.size() + min_range_size - 1) / min_range_size);
+    std::vector<statistics_t> ranges(num_ranges);
+    parallel_for(0, num_ranges,
+                 [&](const std::size_t r) {
+                   ranges[r].init(knots_.size() - 1, degree_, dim_);
+                   const std::size_t end = times.size() * (r + 1) / num_ranges;
+                   for (std::size_t k = times.size() * r / num_ranges; k < end; ++k)
+                     ranges[r].add(knots_, times[k], points[k], weights ? (*weights)[k] : 1.);
+                 },
+                 num_threads);
+    for (std::size_t r = 0; r < num_ranges; ++r) stats_.merge(ranges[r]);
+  }
+
+  static void append_row(const int row, const std::size_t s, const vector_x_t& coefs, const num_t sign,
+                         std::vector<triplet_t>& triplets) {
+    for (long i = 0; i < coefs.size(); ++i) {
+      if (coefs[i] != 0) triplets.push_back(triplet_t(row, (int)(s * coefs.size() + i), sign * coefs[i]));
+    }
+  }
+
+  /*Attributes*/
+  problem_definition_t pDef_;
+  std::size_t continuity_;
+  std::size_t dim_;
+  std::size_t degree_;
+  std::vector<num_t> knots_;
+  statistics_t stats_;
+  /*Attributes*/
+};  // End struct least_squares_fitter
+
+}  // namespace optimization
+}  // namespace curves
+#endif  //_CLASS_LEAST_SQUARES_FITTING
@@ -0,0 +1,140 @@
+/**
+ * \file problem_derivatives.h
+ * \brief Derivatives of the quadratic problems with respect to the split times and the total time.
+ *
+ * The control points of the phase [t_{k-1}, t_k] of the curve are the blossoms
+ * \f$ q_j = P(a^{n-j}, b^j) \f$ of the curve, with \f$ a = t_{k-1} / T \f$ and \f$ b = t_k / T \f$.
+ * The blossom is multi-affine, so that \f$ \frac{\partial q_j}{\partial b} = j P'(a^{n-j}, b^{j-1}) \f$ and
+ * \f$ \frac{\partial q_j}{\partial a} = (n - j) P'(a^{n-j-1}, b^j) \f$, P' being the blossom of the differences
+ * \f$ p_{i+1} - p_i \f$ of the control points, that is of the derivative of the curve divided by n.
+ * The total time also changes the constant control points given by the boundary conditions.
+ */
+
+#ifndef _CLASS_PROBLEM_DERIVATIVES
+#define _CLASS_PROBLEM_DERIVATIVES
+
+#include "curves/optimization/definitions.h"
+#include "curves/optimization/details.h"
+#include "curves/optimization/integral_cost.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+namespace optimization {
+
+/// \brief Blossom of the bezier curve of control points pts, evaluated at params.
+/// \param pts : container of the control points of the curve, for which linear_combination is defined.
+/// \param params : params.size() must be equal to the degree of the curve.
+template <typename Numeric, typename Points>
+typename Points::value_type blossom(Points pts, const std::vector<Numeric>& params) {
+  if (params.size() + 1 != pts.size())
+    throw std::invalid_argument("blossom : the number of parameters must be equal to the degree of the curve");
+  for (std::size_t r = 0; r < params.size(); ++r) {
+    const Numeric u = params[r];
+    for (std::size_t i = 0; i + 1 + r < pts.size(); ++i) linear_combination(pts[i], 1 - u, pts[i], u, pts[i + 1]);
+  }
+  return pts.front();
+}
+
+/// \brief Compute the derivatives of the problem generated by generate_problem with respect to each split time and
+/// to the total time.
+/// \param pDef : definition of the problem.
+/// \param costFlag : derivative order of the integral cost.
+/// \param derivatives : output, of size pDef.splitTimes_.size() + 1. derivatives[i] contains the derivatives of
+/// the inequality matrix, inequality vector and cost with respect to pDef.splitTimes_[i] for
+/// i < pDef.splitTimes_.size(), and with respect to pDef.totalTime for the last element.
+template <typename Point, typename Numeric, bool Safe>
+void compute_problem_derivatives(const problem_definition<Point, Numeric>& pDef, const integral_cost_flag costFlag,
+                                 std::vector<quadratic_problem<Point, Numeric> >& derivatives) {
+  typedef problem_data<Point, Numeric> problem_data_t;
+  typedef typename problem_data_t::sparse_bezier_t sparse_bezier_t;
+  typedef typename sparse_bezier_t::t_point_t t_sparse_point_t;
+  typedef typename sparse_bezier_t::point_t sparse_var_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef std::vector<vector_x_t> t_vector_x_t;
+
+  const problem_data_t pData = setup_control_points<Point, Numeric, Safe>(pDef);
+  const sparse_bezier_t bezier = compute_sparse_linear_control_points<Point, Numeric>(pData, pDef.totalTime);
+  const t_sparse_point_t dwps = bezier.compute_derivate(1).waypoints();
+  const t_vector_x_t dconstants = constant_control_points_time_derivative<Point, Numeric>(pDef);
+  const std::size_t n = bezier.degree();
+  const std::size_t numSplits = (std::size_t)(pDef.splitTimes_.size());
+  const Numeric T = pDef.totalTime;
+  const long rows = compute_num_ineq_control_points<Point, Numeric>(pDef, pData);
+  const long cols = (long)(pData.numVariables * pData.dim_);
+  if (pDef.inequalityMatrices_.size() != pDef.inequalityVectors_.size() ||
+      (!pDef.inequalityMatrices_.empty() && pDef.inequalityMatrices_.size() != numSplits + 1)) {
+    throw std::invalid_argument("The sizes of the inequality matrices and vectors do not match.");
+  }
+
+  derivatives.resize(numSplits + 1);
+  for (std::size_t i = 0; i <= numSplits; ++i) {
+    derivatives[i].ineqMatrix = matrix_x_t::Zero(rows, cols);
+    derivatives[i].ineqVector = vector_x_t::Zero(rows);
+  }
+
+  // cost : only its constant parts depend on the total time, through the constant control points
+  const integral_cost_structure<Numeric>& structure = get_integral_cost_structure<Point, Numeric>(pData, costFlag);
+  vector_x_t c_all, dc_all(pData.dim_ * (n + 1));
+  stack_constant_parts(pData, c_all);
+  for (std::size_t i = 0; i <= n; ++i)
+    for (std::size_t d = 0; d < pData.dim_; ++d) dc_all[d * (n + 1) + i] = dconstants[i][d];
+  const matrix_x_t Hc(structure.H * Eigen::Map<const matrix_x_t>(c_all.data(), n + 1, pData.dim_));
+  const quadratic_variable<Numeric> zero_cost(matrix_x_t::Zero(cols, cols), vector_x_t::Zero(cols), 0.);
+  for (std::size_t i = 0; i < numSplits; ++i) derivatives[i].cost = zero_cost;
+  derivatives[numSplits].cost =
+      quadratic_variable<Numeric>(matrix_x_t::Zero(cols, cols), 2. * (structure.HB.transpose() * dc_all),
+                                  2. * dc_all.dot(Eigen::Map<const vector_x_t>(Hc.data(), Hc.size())));
+
+  if (pDef.inequalityMatrices_.empty()) return;
+  long row = 0;
+  std::vector<Numeric> params(n), dparams(n > 0 ? n - 1 : 0);
+  for (std::size_t k = 0; k <= numSplits; ++k) {
+    // phase k is [t_{k-1}, t_k], with t_{-1} = 0 and t_{numSplits} = T
+    const Numeric t_a = k > 0 ? pDef.splitTimes_[k - 1] : 0., t_b = k < numSplits ? pDef.splitTimes_[k] : T;
+    const Numeric a = t_a / T, b = t_b / T;
+    const matrix_x_t& ineq = pDef.inequalityMatrices_[k];
+    for (std::size_t j = 0; j <= n; ++j) {
+      // derivatives of the control point q_j with respect to a and b, dwps already contains the factor n
+      sparse_var_t dq_da, dq_db;
+      if (j < n) {
+        for (std::size_t r = 0; r < n - 1; ++r) dparams[r] = r < n - j - 1 ? a : b;
+        dq_da = ((Numeric)(n - j) / (Numeric)n) * blossom(dwps, dparams);
+      }
+      if (j > 0) {
+        for (std::size_t r = 0; r < n - 1; ++r) dparams[r] = r < n - j ? a : b;
+        dq_db = ((Numeric)j / (Numeric)n) * blossom(dwps, dparams);
+      }
+      // derivative of the control point q_j with respect to the constant parts of the control points
+      for (std::size_t r = 0; r < n; ++r) params[r] = r < n - j ? a : b;
+      const vector_x_t dq_dconstants = blossom(dconstants, params);
+
+      // a depends on t_{k-1}, b on t_k, and both on T
+      if (k > 0 && !dq_da.isZero()) {
+        derivatives[k - 1].ineqMatrix.block(row, 0, ineq.rows(), cols) += ineq * dq_da.B() / T;
+        derivatives[k - 1].ineqVector.segment(row, ineq.rows()) -= ineq * dq_da.c() / T;
+      }
+      if (k < numSplits && !dq_db.isZero()) {
+        derivatives[k].ineqMatrix.block(row, 0, ineq.rows(), cols) += ineq * dq_db.B() / T;
+        derivatives[k].ineqVector.segment(row, ineq.rows()) -= ineq * dq_db.c() / T;
+      }
+      quadratic_problem<Point, Numeric>& dT = derivatives[numSplits];
+      if (k > 0 && !dq_da.isZero()) {
+        dT.ineqMatrix.block(row, 0, ineq.rows(), cols) -= ineq * dq_da.B() * (a / T);
+        dT.ineqVector.segment(row, ineq.rows()) += ineq * dq_da.c() * (a / T);
+      }
+      if (k < numSplits && !dq_db.isZero()) {
+        dT.ineqMatrix.block(row, 0, ineq.rows(), cols) -= ineq * dq_db.B() * (b / T);
+        dT.ineqVector.segment(row, ineq.rows()) += ineq * dq_db.c() * (b / T);
+      }
+      dT.ineqVector.segment(row, ineq.rows()) -= ineq * dq_dconstants;
+      row += ineq.rows();
+    }
+  }
+}
+
+}  // namespace optimization
+}  // namespace curves
+#endif  //_CLASS_PROBLEM_DERIVATIVES
@@ -0,0 +1,363 @@
+/**
+ * \file qp_solver.h
+ * \brief Solver for the quadratic problems generated by the library.
+ *
+ * The problems \f$ \min_x x^T A x + b^T x + c \f$ subject to \f$ l \leq C x \leq u \f$ are solved with
+ * the alternating direction method of multipliers (ADMM), with the same splitting as OSQP.
+ * A single linear system is factorized (again only when the step size is adapted), which makes the solver
+ * well suited for the sequences of similar problems: the solution of the previous problem is used to warm start
+ * the next one. The same implementation is used for dense and sparse (Eigen::SparseMatrix) constraint matrices.
+ */
+
+#ifndef _CLASS_QP_SOLVER
+#define _CLASS_QP_SOLVER
+
+#include "curves/optimization/definitions.h"
+#include "curves/optimization/details.h"
+#include "curves/optimization/quadratic_problem.h"
+
+#include <Eigen/Cholesky>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace curves {
+namespace optimization {
+
+enum qp_status { QP_SOLVED = 0, QP_MAX_ITER_REACHED = 1, QP_PRIMAL_INFEASIBLE = 2, QP_NOT_SOLVED = 3 };
+
+/// \struct qp_settings.
+/// \brief Parameters of the ADMM iterations.
+template <typename Numeric = double>
+struct qp_settings {
+  qp_settings()
+      : max_iter(10000),
+        eps_abs(1e-7),
+        eps_rel(1e-7),
+        eps_prim_inf(1e-6),
+        rho(0.1),
+        sigma(1e-6),
+        alpha(1.6),
+        adaptive_rho_interval(25) {}
+
+  std::size_t max_iter;
+  Numeric eps_abs;       // absolute tolerance on the residuals
+  Numeric eps_rel;       // relative tolerance on the residuals
+  Numeric eps_prim_inf;  // tolerance of the primal infeasibility test
+  Numeric rho;           // initial step size
+  Numeric sigma;         // regularization of the cost, makes the linear system definite
+  Numeric alpha;         // relaxation parameter, in ]0, 2[
+  std::size_t adaptive_rho_interval;  // number of iterations between two updates of rho, 0 to keep rho constant
+};
+
+/// \struct qp_result.
+/// \brief Solution of a quadratic problem, with the dual variables y of the constraints and z = C x.
+template <typename Numeric = double>
+struct qp_result {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  qp_result() : status(QP_NOT_SOLVED), iterations(0), cost(0) {}
+
+  vector_x_t x;
+  vector_x_t y;
+  vector_x_t z;
+  qp_status status;
+  std::size_t iterations;
+  Numeric cost;
+};
+
+/// \brief Operations depending on the storage of the matrices of the problem.
+template <typename Matrix>
+struct qp_linear_system;
+
+template <typename Numeric>
+struct qp_linear_system<Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> > {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::LLT<matrix_t> factorization_t;
+
+  static void compute(factorization_t& factorization, const matrix_t& P, const matrix_t& C, const vector_x_t& rho,
+                      const Numeric sigma) {
+    matrix_t K(P);
+    K.diagonal().array() += sigma;
+    K.noalias() += C.transpose() * rho.asDiagonal() * C;
+    factorization.compute(K);
+    if (factorization.info() != Eigen::Success) throw std::runtime_error("qp_solver : factorization failed");
+  }
+};
+
+template <typename Numeric>
+struct qp_linear_system<Eigen::SparseMatrix<Numeric> > {
+  typedef Eigen::SparseMatrix<Numeric> matrix_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::SimplicialLDLT<matrix_t> factorization_t;
+
+  static void compute(factorization_t& factorization, const matrix_t& P, const matrix_t& C, const vector_x_t& rho,
+                      const Numeric sigma) {
+    matrix_t I(P.rows(), P.cols());
+    I.setIdentity();
+    const matrix_t RC = rho.asDiagonal() * C;
+    const matrix_t K = P + sigma * I + matrix_t(C.transpose()) * RC;
+    factorization.compute(K);
+    if (factorization.info() != Eigen::Success) throw std::runtime_error("qp_solver : factorization failed");
+  }
+};
+
+/// \class qp_solver.
+/// \brief ADMM solver of \f$ \min_x x^T A x + b^T x \f$ subject to \f$ l \leq C x \leq u \f$.
+/// The bounds may be infinite, and l = u for the equality constraints.
+/// After a call to solve, the next call starts from the previous solution unless reset is called,
+/// so that the cost vector and the bounds can be updated in place for a sequence of similar problems.
+/// \tparam Matrix : Eigen::Matrix<Numeric, Dynamic, Dynamic> or Eigen::SparseMatrix<Numeric>.
+template <typename Numeric = double, typename Matrix = Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> >
+class qp_solver {
+ public:
+  typedef Matrix matrix_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef qp_linear_system<Matrix> linear_system_t;
+  typedef qp_settings<Numeric> qp_settings_t;
+  typedef qp_result<Numeric> qp_result_t;
+
+  /* Constructors - destructors */
+ public:
+  qp_solver(const qp_settings_t& settings = qp_settings_t()) : settings_(settings), rho_(settings.rho) {}
+
+  /// \brief Set the problem, the matrix of the linear system is factorized.
+  /// \param A : symmetric positive semi definite matrix of the cost.
+  /// \param b : linear part of the cost.
+  /// \param C : constraint matrix.
+  /// \param l : lower bounds of C x, may be -infinity.
+  /// \param u : upper bounds of C x, may be +infinity.
+  void setup(const matrix_t& A, const vector_x_t& b, const matrix_t& C, const vector_x_t& l, const vector_x_t& u) {
+    if (A.rows() != A.cols() || b.size() != A.rows() || C.cols() != A.cols() || l.size() != C.rows() ||
+        u.size() != C.rows()) {
+      throw std::invalid_argument("qp_solver : the dimensions of the problem do not match");
+    }
+    P_ = 2. * A;
+    q_ = b;
+    C_ = C;
+    l_ = l;
+    u_ = u;
+    rho_ = settings_.rho;
+    reset();
+    factorize();
+  }
+
+  /// \brief Replace the linear part of the cost, no factorization is needed.
+  void update_linear_cost(const vector_x_t& b) {
+    if (b.size() != q_.size()) throw std::invalid_argument("qp_solver : wrong size of the linear cost");
+    q_ = b;
+  }
+
+  /// \brief Replace the bounds of the constraints. The matrix is factorized again only if the equality constraints
+  /// changed.
+  void update_bounds(const vector_x_t& l, const vector_x_t& u) {
+    if (l.size() != l_.size() || u.size() != u_.size())
+      throw std::invalid_argument("qp_solver : wrong size of the bounds");
+    const vector_x_t old_rho = rho_vec_;
+    l_ = l;
+    u_ = u;
+    compute_rho_vector();
+    if (rho_vec_ != old_rho) factorize();
+  }
+
+  /// \brief Start the next resolution from the given primal and dual solutions.
+  void warm_start(const vector_x_t& x, const vector_x_t& y) {
+    if (x.size() != P_.rows() || y.size() != C_.rows())
+      throw std::invalid_argument("qp_solver : wrong size of the warm start");
+    result_.x = x;
+    result_.y = y;
+    result_.z = C_ * x;
+  }
+
+  /// \brief Start the next resolution from zero.
+  void reset() {
+    result_ = qp_result_t();
+    result_.x = vector_x_t::Zero(P_.rows());
+    result_.y = vector_x_t::Zero(C_.rows());
+    result_.z = vector_x_t::Zero(C_.rows());
+  }
+
+  /// \brief Solve the problem, starting from the previous solution.
+  const qp_result_t& solve() {
+    const std::size_t m = (std::size_t)(C_.rows());
+    vector_x_t& x = result_.x;
+    vector_x_t& y = result_.y;
+    vector_x_t& z = result_.z;
+    vector_x_t x_tilde, z_tilde, z_relaxed, Cx, Px, Cty, delta_y;
+    const Numeric alpha = settings_.alpha, sigma = settings_.sigma;
+    result_.status = QP_MAX_ITER_REACHED;
+    std::size_t iter = 0;
+    for (; iter < settings_.max_iter; ++iter) {
+      // linear system (P + sigma I + C^T rho C) x_tilde = sigma x - q + C^T (rho z - y)
+      x_tilde = factorization_.solve(sigma * x - q_ + C_.transpose() * (rho_vec_.cwiseProduct(z) - y));
+      z_tilde = C_ * x_tilde;
+      x = alpha * x_tilde + (1. - alpha) * x;
+      z_relaxed = alpha * z_tilde + (1. - alpha) * z;
+      z = (z_relaxed + y.cwiseQuotient(rho_vec_)).cwiseMax(l_).cwiseMin(u_);
+      delta_y = rho_vec_.cwiseProduct(z_relaxed - z);
+      y += delta_y;
+
+      // residuals
+      Cx = C_ * x;
+      Px = P_ * x;
+      Cty = C_.transpose() * y;
+      const Numeric prim_res = m ? (Cx - z).template lpNorm<Eigen::Infinity>() : 0.;
+      const Numeric dual_res = (Px + q_ + Cty).template lpNorm<Eigen::Infinity>();
+      const Numeric prim_scale =
+          m ? std::max(Cx.template lpNorm<Eigen::Infinity>(), z.template lpNorm<Eigen::Infinity>()) : 0.;
+      const Numeric dual_scale = std::max(std::max(Px.template lpNorm<Eigen::Infinity>(),
+                                                   Cty.template lpNorm<Eigen::Infinity>()),
+                                          q_.template lpNorm<Eigen::Infinity>());
+      if (prim_res <= settings_.eps_abs + settings_.eps_rel * prim_scale &&
+          dual_res <= settings_.eps_abs + settings_.eps_rel * dual_scale) {
+        result_.status = QP_SOLVED;
+        ++iter;
+        break;
+      }
+      if (m && is_primal_infeasible(delta_y)) {
+        result_.status = QP_PRIMAL_INFEASIBLE;
+        ++iter;
+        break;
+      }
+      if (settings_.adaptive_rho_interval > 0 && (iter + 1) % settings_.adaptive_rho_interval == 0 && m)
+        adapt_rho(prim_res / std::max(prim_scale, tiny()), dual_res / std::max(dual_scale, tiny()));
+    }
+    result_.iterations = iter;
+    result_.cost = x.dot(0.5 * (P_ * x)) + q_.dot(x);
+    return result_;
+  }
+
+  const qp_result_t& result() const { return result_; }
+  const qp_settings_t& settings() const { return settings_; }
+  /// \brief Current step size, kept between two resolutions.
+  Numeric rho() const { return rho_; }
+
+ private:
+  static Numeric tiny() { return (Numeric)1e-12; }
+
+  /// \brief The equality constraints use a larger step size, the rows without bounds a small one.
+  void compute_rho_vector() {
+    const Numeric inf = std::numeric_limits<Numeric>::infinity();
+    rho_vec_.resize(C_.rows());
+    for (long i = 0; i < C_.rows(); ++i) {
+      if (l_[i] == -inf && u_[i] == inf)
+        rho_vec_[i] = 1e-6;
+      else if (u_[i] - l_[i] < 1e-4)
+        rho_vec_[i] = 1e3 * rho_;
+      else
+        rho_vec_[i] = rho_;
+    }
+  }
+
+  void factorize() {
+    compute_rho_vector();
+    linear_system_t::compute(factorization_, P_, C_, rho_vec_, settings_.sigma);
+  }
+
+  void adapt_rho(const Numeric normalized_prim_res, const Numeric normalized_dual_res) {
+    const Numeric new_rho =
+        std::min(std::max(rho_ * std::sqrt(normalized_prim_res / std::max(normalized_dual_res, tiny())),
+                          (Numeric)1e-6),
+                 (Numeric)1e6);
+    if (new_rho > 5. * rho_ || new_rho < 0.2 * rho_) {
+      rho_ = new_rho;
+      factorize();
+    }
+  }
+
+  /// \brief delta_y is a certificate of primal infeasibility if C^T delta_y = 0 and
+  /// u^T max(delta_y, 0) + l^T min(delta_y, 0) < 0.
+  bool is_primal_infeasible(const vector_x_t& delta_y) const {
+    const Numeric norm = delta_y.template lpNorm<Eigen::Infinity>();
+    if (norm <= settings_.eps_prim_inf) return false;
+    const Numeric inf = std::numeric_limits<Numeric>::infinity();
+    const Numeric eps = settings_.eps_prim_inf * norm;
+    Numeric support = 0.;
+    for (long i = 0; i < delta_y.size(); ++i) {
+      if (delta_y[i] > eps) {
+        if (u_[i] == inf) return false;
+        support += u_[i] * delta_y[i];
+      } else if (delta_y[i] < -eps) {
+        if (l_[i] == -inf) return false;
+        support += l_[i] * delta_y[i];
+      }
+    }
+    return support < -eps && vector_x_t(C_.transpose() * delta_y).template lpNorm<Eigen::Infinity>() <= eps;
+  }
+
+  /*Attributes*/
+  qp_settings_t settings_;
+  matrix_t P_;
+  vector_x_t q_;
+  matrix_t C_;
+  vector_x_t l_;
+  vector_x_t u_;
+  Numeric rho_;
+  vector_x_t rho_vec_;
+  typename linear_system_t::factorization_t factorization_;
+  qp_result_t result_;
+  /*Attributes*/
+};
+
+/// \brief Solve a quadratic_problem, the inequality constraints are ineqMatrix x <= ineqVector.
+/// \param prob : problem to solve.
+/// \param settings : parameters of the solver.
+/// \param warm_start : if not null, the resolution starts from this solution of a problem of the same size.
+/// \return the solution, the constant part of the cost is included in the cost of the result.
+template <typename Point, typename Numeric>
+qp_result<Numeric> solve(const quadratic_problem<Point, Numeric>& prob,
+                         const qp_settings<Numeric>& settings = qp_settings<Numeric>(),
+                         const qp_result<Numeric>* warm_start = 0) {
+  typedef qp_solver<Numeric, Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> > solver_t;
+  typedef typename solver_t::vector_x_t vector_x_t;
+  solver_t solver(settings);
+  const vector_x_t l = vector_x_t::Constant(prob.ineqVector.size(), -std::numeric_limits<Numeric>::infinity());
+  solver.setup(prob.cost.A(), prob.cost.b(), prob.ineqMatrix, l, prob.ineqVector);
+  if (warm_start) solver.warm_start(warm_start->x, warm_start->y);
+  qp_result<Numeric> res = solver.solve();
+  res.cost += prob.cost.c();
+  return res;
+}
+
+/// \brief Solve a sparse_quadratic_problem, see solve(quadratic_problem).
+template <typename Point, typename Numeric>
+qp_result<Numeric> solve(const sparse_quadratic_problem<Point, Numeric>& prob,
+                         const qp_settings<Numeric>& settings = qp_settings<Numeric>(),
+                         const qp_result<Numeric>* warm_start = 0) {
+  typedef qp_solver<Numeric, Eigen::SparseMatrix<Numeric> > solver_t;
+  typedef typename solver_t::vector_x_t vector_x_t;
+  solver_t solver(settings);
+  const vector_x_t l = vector_x_t::Constant(prob.ineqVector.size(), -std::numeric_limits<Numeric>::infinity());
+  solver.setup(prob.cost.A().sparseView(), prob.cost.b(), prob.ineqMatrix, l, prob.ineqVector);
+  if (warm_start) solver.warm_start(warm_start->x, warm_start->y);
+  qp_result<Numeric> res = solver.solve();
+  res.cost += prob.cost.c();
+  return res;
+}
+
+/// \brief Generate the problem defined by pDef, solve it and return the optimal bezier curve.
+/// \param pDef : definition of the problem.
+/// \param costFlag : derivative order of the integral cost.
+/// \param settings : parameters of the solver.
+/// \return the optimal curve, defined between 0 and pDef.totalTime.
+template <typename Point, typename Numeric, bool Safe>
+bezier_curve<Numeric, Numeric, true, Point> solve_problem(
+    const problem_definition<Point, Numeric>& pDef, const integral_cost_flag costFlag,
+    const qp_settings<Numeric>& settings = qp_settings<Numeric>()) {
+  typedef bezier_curve<Numeric, Numeric, true, Point> bezier_t;
+  problem_data<Point, Numeric> pData = setup_control_points<Point, Numeric, Safe>(pDef);
+  sparse_quadratic_problem<Point, Numeric> prob;
+  initInequalityMatrix<Point, Numeric>(pDef, pData, prob);
+  prob.cost = compute_integral_cost<Point, Numeric>(pData, costFlag);
+  const qp_result<Numeric> res = solve(prob, settings);
+  if (res.status != QP_SOLVED) throw std::runtime_error("solve_problem : the quadratic problem could not be solved");
+  return evaluateLinear<bezier_t, typename problem_data<Point, Numeric>::bezier_t>(*pData.bezier, res.x);
+}
+
+}  // namespace optimization
+}  // namespace curves
+#endif  //_CLASS_QP_SOLVER
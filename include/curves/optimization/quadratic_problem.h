@@ -12,6 +12,7 @@
 #include "curves/optimization/definitions.h"
 #include "curves/optimization/details.h"
 #include "curves/optimization/integral_cost.h"
+#include "curves/parallel.h"
 
 #include <Eigen/Core>
 
@@ -37,6 +38,70 @@ quadratic_problem<Point, Numeric> generate_problem(const problem_definition<Poin
   prob.cost = compute_integral_cost<Point, Numeric>(pData, costFlag);
   return prob;
 }
+
+/// \brief Same as generate_problem, with a sparse inequality matrix.
+template <typename Point, typename Numeric, bool Safe>
+sparse_quadratic_problem<Point, Numeric> generate_sparse_problem(const problem_definition<Point, Numeric>& pDef,
+                                                                 const quadratic_variable<Numeric>& cost) {
+  sparse_quadratic_problem<Point, Numeric> prob;
+  problem_data<Point, Numeric> pData = setup_control_points<Point, Numeric, Safe>(pDef);
+  initInequalityMatrix<Point, Numeric>(pDef, pData, prob);
+  prob.cost = cost;
+  return prob;
+}
+
+/// \brief Same as generate_problem, with a sparse inequality matrix.
+template <typename Point, typename Numeric, bool Safe>
+sparse_quadratic_problem<Point, Numeric> generate_sparse_problem(const problem_definition<Point, Numeric>& pDef,
+                                                                 const integral_cost_flag costFlag) {
+  sparse_quadratic_problem<Point, Numeric> prob;
+  problem_data<Point, Numeric> pData = setup_control_points<Point, Numeric, Safe>(pDef);
+  initInequalityMatrix<Point, Numeric>(pDef, pData, prob);
+  prob.cost = compute_integral_cost<Point, Numeric>(pData, costFlag);
+  return prob;
+}
+
+/// \brief Generate in parallel the problems of pDef for many split times.
+/// The control points, the curve and the cost do not depend on the split times, they are computed once
+/// and shared by all the threads.
+/// \param pDef : definition of the problems, its split times are ignored.
+/// \param splitTimes : split times of each problem, the number of phases must match the inequality constraints.
+/// \param costFlag : derivative order of the integral cost.
+/// \param problems : output, resized to splitTimes.size(). Either quadratic_problem or sparse_quadratic_problem.
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+template <typename Point, typename Numeric, bool Safe, typename Problem>
+void generate_problems(const problem_definition<Point, Numeric>& pDef, const std::vector<Eigen::VectorXd>& splitTimes,
+                       const integral_cost_flag costFlag, std::vector<Problem>& problems,
+                       const std::size_t num_threads = 0) {
+  typedef typename problem_data<Point, Numeric>::sparse_bezier_t sparse_bezier_t;
+  const problem_data<Point, Numeric> pData = setup_control_points<Point, Numeric, Safe>(pDef);
+  const sparse_bezier_t bezier = compute_sparse_linear_control_points<Point, Numeric>(pData, pDef.totalTime);
+  const quadratic_variable<Numeric> cost = compute_integral_cost<Point, Numeric>(pData, costFlag);
+  problems.resize(splitTimes.size());
+  parallel_for(0, splitTimes.size(),
+               [&](const std::size_t i) {
+                 initInequalityMatrix<Point, Numeric>(pDef, splitTimes[i], pData, bezier, problems[i]);
+                 problems[i].cost = cost;
+               },
+               num_threads);
+}
+
+/// \brief Generate in parallel the problems of several definitions, see generate_problem.
+/// \param problems : output, resized to pDefs.size(). Either quadratic_problem or sparse_quadratic_problem.
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+template <typename Point, typename Numeric, bool Safe, typename Problem>
+void generate_problems(const std::vector<problem_definition<Point, Numeric> >& pDefs,
+                       const integral_cost_flag costFlag, std::vector<Problem>& problems,
+                       const std::size_t num_threads = 0) {
+  problems.resize(pDefs.size());
+  parallel_for(0, pDefs.size(),
+               [&](const std::size_t i) {
+                 problem_data<Point, Numeric> pData = setup_control_points<Point, Numeric, Safe>(pDefs[i]);
+                 initInequalityMatrix<Point, Numeric>(pDefs[i], pData, problems[i]);
+                 problems[i].cost = compute_integral_cost<Point, Numeric>(pData, costFlag);
+               },
+               num_threads);
+}
 }  // namespace optimization
 }  // namespace curves
 #endif  //_CLASS_LINEAR_PROBLEM
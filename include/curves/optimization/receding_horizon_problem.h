@@ -0,0 +1,203 @@
+/**
+ * \file receding_horizon_problem.h
+ * \brief Quadratic problem solved repeatedly with new boundary conditions, for receding horizon control.
+ *
+ * For a given degree, constraint flag, total time, split times and inequality matrices, the inequality matrix
+ * and the quadratic part of the cost of the problem do not depend on the boundary conditions. They are computed
+ * and factorized once; updating the boundary conditions or the inequality vectors then only updates the
+ * vectors of the problem, and the solver starts from the previous primal / dual solution.
+ */
+
+#ifndef _CLASS_RECEDING_HORIZON_PROBLEM
+#define _CLASS_RECEDING_HORIZON_PROBLEM
+
+#include "curves/optimization/definitions.h"
+#include "curves/optimization/details.h"
+#include "curves/optimization/integral_cost.h"
+#include "curves/optimization/qp_solver.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace curves {
+namespace optimization {
+
+/// \class receding_horizon_problem.
+/// \brief Persistent quadratic problem, see receding_horizon_problem.h.
+template <typename Point, typename Numeric = double, bool Safe = true>
+class receding_horizon_problem {
+ public:
+  typedef Point point_t;
+  typedef Numeric num_t;
+  typedef problem_definition<Point, Numeric> problem_definition_t;
+  typedef problem_data<Point, Numeric> problem_data_t;
+  typedef sparse_quadratic_problem<Point, Numeric> sparse_quadratic_problem_t;
+  typedef typename sparse_quadratic_problem_t::sparse_matrix_t sparse_matrix_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef qp_solver<Numeric, sparse_matrix_t> qp_solver_t;
+  typedef qp_result<Numeric> qp_result_t;
+  typedef bezier_curve<Numeric, Numeric, true, Point> bezier_t;
+
+  /* Constructors - destructors */
+ public:
+  /// \brief Constructor, generates the structure of the problem and factorizes it.
+  /// \param pDef : definition of the problem. The degree, flag, total time, split times and inequality matrices
+  /// are fixed for the lifetime of the object.
+  /// \param costFlag : derivative order of the integral cost.
+  /// \param settings : parameters of the solver.
+  receding_horizon_problem(const problem_definition_t& pDef, const integral_cost_flag costFlag,
+                           const qp_settings<Numeric>& settings = qp_settings<Numeric>())
+      : pDef_(pDef),
+        pData_(setup_control_points<Point, Numeric, Safe>(pDef)),
+        variables_(pDef.dim_),
+        structure_(get_integral_cost_structure<Point, Numeric>(pData_, costFlag)),
+        solver_(settings),
+        dirty_(true) {
+    initInequalityMatrix<Point, Numeric>(pDef_, pData_, problem_);
+    init_constant_matrix();
+    update_inequality_vectors();
+    update_problem();
+    const vector_x_t l = vector_x_t::Constant(problem_.ineqVector.size(), -std::numeric_limits<Numeric>::infinity());
+    solver_.setup(structure_.A.sparseView(), problem_.cost.b(), problem_.ineqMatrix, l, problem_.ineqVector);
+  }
+
+ private:
+  receding_horizon_problem(const receding_horizon_problem&);
+  receding_horizon_problem& operator=(const receding_horizon_problem&);
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  void set_init_pos(const point_t& val) {
+    pDef_.init_pos = val;
+    dirty_ = true;
+  }
+  void set_init_vel(const point_t& val) {
+    pDef_.init_vel = val;
+    dirty_ = true;
+  }
+  void set_init_acc(const point_t& val) {
+    pDef_.init_acc = val;
+    dirty_ = true;
+  }
+  void set_end_pos(const point_t& val) {
+    pDef_.end_pos = val;
+    dirty_ = true;
+  }
+  void set_end_vel(const point_t& val) {
+    pDef_.end_vel = val;
+    dirty_ = true;
+  }
+  void set_end_acc(const point_t& val) {
+    pDef_.end_acc = val;
+    dirty_ = true;
+  }
+  /// \brief Replace the inequality vector of the phase i, its size cannot change.
+  void set_inequality_vector(const std::size_t i, const vector_x_t& val) {
+    if (i >= pDef_.inequalityVectors_.size() || val.size() != pDef_.inequalityVectors_[i].size()) {
+      throw std::invalid_argument("receding_horizon_problem : wrong index or size of the inequality vector");
+    }
+    pDef_.inequalityVectors_[i] = val;
+    update_inequality_vectors();
+    dirty_ = true;
+  }
+
+  /// \brief Solve the problem with the current boundary conditions, starting from the previous solution.
+  const qp_result_t& solve() {
+    update_problem();
+    solver_.update_linear_cost(problem_.cost.b());
+    solver_.update_bounds(vector_x_t::Constant(problem_.ineqVector.size(), -std::numeric_limits<Numeric>::infinity()),
+                          problem_.ineqVector);
+    return solver_.solve();
+  }
+
+  /// \brief Optimal curve of the last resolution, defined between 0 and totalTime.
+  bezier_t curve() const {
+    typename bezier_t::t_point_t wps;
+    for (std::size_t i = 0; i < pData_.numControlPoints; ++i)
+      wps.push_back(pData_.bezier->waypointAtIndex(i).B() * solver_.result().x + variables_.variables_[i].c());
+    return bezier_t(wps.begin(), wps.end(), 0., pDef_.totalTime);
+  }
+
+  /// \brief Current problem, for use with another solver.
+  const sparse_quadratic_problem_t& problem() {
+    update_problem();
+    return problem_;
+  }
+  const problem_definition_t& definition() const { return pDef_; }
+  const qp_result_t& result() const { return solver_.result(); }
+  qp_solver_t& solver() { return solver_; }
+  /*Operations*/
+
+ private:
+  /// \brief The constant parts of the control points of the sub-curves are linear in the constant parts c_all of the
+  /// control points of the curve: ineqVector = ineqVectors - constantMatrix c_all.
+  void init_constant_matrix() {
+    typedef typename problem_data_t::sparse_bezier_t sparse_bezier_t;
+    typedef sparse_linear_variable<Numeric> sparse_var_t;
+    const long n = (long)(pData_.numControlPoints), Dim = (long)(pData_.dim_);
+    typename sparse_bezier_t::t_point_t selection;
+    for (long i = 0; i < n; ++i) {
+      typename sparse_var_t::sparse_matrix_t B(Dim, Dim * n);
+      for (long d = 0; d < Dim; ++d) B.insert(d, d * n + i) = 1.;
+      selection.push_back(sparse_var_t(B, vector_x_t::Zero(Dim)));
+    }
+    const std::vector<sparse_bezier_t> beziers =
+        split_bezier(pDef_.splitTimes_, sparse_bezier_t(selection.begin(), selection.end(), 0., pDef_.totalTime));
+    constantMatrix_ = matrix_x_t::Zero(problem_.ineqVector.size(), Dim * n);
+    if (pDef_.inequalityMatrices_.empty()) return;
+    long row = 0;
+    for (std::size_t k = 0; k < beziers.size(); ++k) {
+      const matrix_x_t& ineq = pDef_.inequalityMatrices_[k];
+      for (std::size_t j = 0; j < beziers[k].waypoints().size(); ++j) {
+        constantMatrix_.middleRows(row, ineq.rows()) = ineq * beziers[k].waypoints()[j].B();
+        row += ineq.rows();
+      }
+    }
+  }
+
+  void update_inequality_vectors() {
+    inequalityVectors_.resize(problem_.ineqVector.size());
+    if (pDef_.inequalityVectors_.empty()) return;
+    long row = 0;
+    for (std::size_t k = 0; k < pDef_.inequalityVectors_.size(); ++k) {
+      const vector_x_t& vec = pDef_.inequalityVectors_[k];
+      for (std::size_t j = 0; j < pData_.numControlPoints; ++j) {
+        inequalityVectors_.segment(row, vec.size()) = vec;
+        row += vec.size();
+      }
+    }
+  }
+
+  /// \brief Update the vectors of the problem from the boundary conditions.
+  void update_problem() {
+    if (!dirty_) return;
+    setup_variables<Point, Numeric, Safe>(pDef_, variables_);
+    if (variables_.startVariableIndex != pData_.startVariableIndex || variables_.numVariables != pData_.numVariables) {
+      throw std::logic_error("receding_horizon_problem : the structure of the problem changed");
+    }
+    stack_constant_parts(variables_, c_all_);
+    problem_.ineqVector = inequalityVectors_;
+    problem_.ineqVector.noalias() -= constantMatrix_ * c_all_;
+    problem_.cost = structure_.evaluate(c_all_);
+    dirty_ = false;
+  }
+
+  /*Attributes*/
+  problem_definition_t pDef_;
+  problem_data_t pData_;
+  problem_data_t variables_;  // constant parts of the control points for the current boundary conditions
+  const integral_cost_structure<Numeric>& structure_;
+  sparse_quadratic_problem_t problem_;
+  matrix_x_t constantMatrix_;
+  vector_x_t inequalityVectors_;
+  vector_x_t c_all_;
+  qp_solver_t solver_;
+  bool dirty_;
+  /*Attributes*/
+};
+
+}  // namespace optimization
+}  // namespace curves
+#endif  //_CLASS_RECEDING_HORIZON_PROBLEM
@@ -0,0 +1,205 @@
+/**
+ * \file time_optimal_retiming.h
+ * \brief Time optimal parametrization of a geometric path under velocity and acceleration limits.
+ *
+ * The path q(s) is followed with the time law s(t). With \f$ x = \dot{s}^2 \f$ and \f$ u = \ddot{s} \f$, the
+ * velocity and acceleration of the trajectory are \f$ \dot{q} = q'(s) \dot{s} \f$ and
+ * \f$ \ddot{q} = q'(s) u + q''(s) x \f$, and on a grid \f$ s_0 < ... < s_N \f$ of step \f$ \Delta \f$,
+ * \f$ x_{i+1} = x_i + 2 \Delta u_i \f$ for a piecewise constant u. The limits are linear constraints on (x_i, u_i).
+ * As in TOPP-RA, a backward pass computes the intervals of x_i from which the end of the path can be reached, then a
+ * forward pass chooses the maximal acceleration u_i that stays in these intervals. Each step solves a problem of
+ * two variables in closed form, so that the solver is linear in the number of grid points.
+ */
+
+#ifndef _CLASS_TIME_OPTIMAL_RETIMING
+#define _CLASS_TIME_OPTIMAL_RETIMING
+
+#include "curves/piecewise_curve.h"
+#include "curves/polynomial.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+namespace optimization {
+
+/// \class time_optimal_retiming.
+/// \brief Time optimal parametrization of a path given as a curve of type Curve, see time_optimal_retiming.h.
+/// \tparam Polynomial : type of the segments of the retimed trajectory.
+template <typename Curve, typename Polynomial = polynomial<typename Curve::time_t, typename Curve::num_t, true,
+                                                          typename Curve::point_t> >
+class time_optimal_retiming {
+ public:
+  typedef typename Curve::time_t time_t;
+  typedef typename Curve::num_t num_t;
+  typedef typename Curve::point_t point_t;
+  typedef typename Curve::point_derivate_t point_derivate_t;
+  typedef Eigen::Matrix<num_t, Eigen::Dynamic, 1> vector_x_t;
+  typedef Polynomial polynomial_t;
+  typedef piecewise_curve<time_t, num_t, true, point_t, point_t, typename Polynomial::curve_abc_t> piecewise_curve_t;
+
+  /* Constructors - destructors */
+ public:
+  /// \brief Constructor, computes the time optimal parametrization.
+  /// \param path : the path, its parameter s is its time.
+  /// \param max_vel : maximal absolute velocity along each axis.
+  /// \param max_acc : maximal absolute acceleration along each axis.
+  /// \param num_intervals : number of intervals of the grid of the path parameter.
+  /// \param init_sd : initial value of \f$ \dot{s} \f$, 0 to start at rest.
+  /// \param end_sd : final value of \f$ \dot{s} \f$, 0 to stop at rest.
+  time_optimal_retiming(const Curve& path, const vector_x_t& max_vel, const vector_x_t& max_acc,
+                        const std::size_t num_intervals = 1000, const num_t init_sd = 0., const num_t end_sd = 0.)
+      : max_vel_(max_vel), max_acc_(max_acc) {
+    if ((std::size_t)max_vel.size() != path.dim() || (std::size_t)max_acc.size() != path.dim())
+      throw std::invalid_argument("time_optimal_retiming : the limits must have the dimension of the path");
+    if (!(max_vel.array() > 0).all() || !(max_acc.array() > 0).all())
+      throw std::invalid_argument("time_optimal_retiming : the limits must be positive");
+    if (num_intervals < 1) throw std::invalid_argument("time_optimal_retiming : at least one interval is needed");
+    const std::size_t N = num_intervals;
+    step_ = (path.max() - path.min()) / (num_t)N;
+    grid_ = vector_x_t::LinSpaced((long)N + 1, path.min(), path.max());
+    for (std::size_t i = 0; i <= N; ++i) {
+      positions_.push_back(path(grid_[i]));
+      d1_.push_back(path.derivate(grid_[i], 1));
+      d2_.push_back(path.derivate(grid_[i], 2));
+    }
+    backward_pass(end_sd * end_sd);
+    forward_pass(init_sd * init_sd);
+  }
+  /* Constructors - destructors */
+
+  /*Operations*/
+ public:
+  /// \brief Duration of the retimed trajectory.
+  time_t duration() const { return times_[times_.size() - 1]; }
+
+  /// \brief Grid of the path parameter \f$ s_i \f$.
+  const vector_x_t& grid() const { return grid_; }
+  /// \brief Squared path velocities \f$ \dot{s}_i^2 \f$ on the grid.
+  const vector_x_t& squared_velocities() const { return x_; }
+  /// \brief Path accelerations \f$ \ddot{s} \f$ on each interval of the grid.
+  const vector_x_t& accelerations() const { return u_; }
+  /// \brief Times at which the grid points are reached.
+  const vector_x_t& times() const { return times_; }
+
+  /// \brief Retimed trajectory, defined between 0 and duration(). Each interval of the grid gives a cubic polynomial
+  /// that interpolates the positions and velocities of the trajectory at its ends.
+  piecewise_curve_t compute_curve() const {
+    piecewise_curve_t res;
+    for (long i = 0; i + 1 < grid_.size(); ++i) {
+      const point_t v0 = d1_[i] * std::sqrt(x_[i]);
+      const point_t v1 = d1_[i + 1] * std::sqrt(x_[i + 1]);
+      res.add_curve(polynomial_t(positions_[i], v0, positions_[i + 1], v1, times_[i], times_[i + 1]));
+    }
+    return res;
+  }
+  /*Operations*/
+
+ private:
+  /// \brief Linear bound alpha + beta x on u.
+  struct bound_t {
+    bound_t(const num_t a, const num_t b) : alpha(a), beta(b) {}
+    num_t eval(const num_t x) const { return alpha + beta * x; }
+    num_t alpha, beta;
+  };
+
+  /// \brief Constraints of the step i : the bounds on u, and the maximal value of x given by the velocity limits and
+  /// the axes where q' = 0.
+  /// \param next_min, next_max : interval of the reachable values of x_{i+1}.
+  void constraints(const std::size_t i, const num_t next_min, const num_t next_max, num_t& x_max) {
+    lowers_.clear();
+    uppers_.clear();
+    x_max = std::numeric_limits<num_t>::infinity();
+    for (long j = 0; j < max_vel_.size(); ++j) {
+      const num_t a = d1_[i][j], b = d2_[i][j];
+      if (std::fabs(a) > 1e-12) {
+        x_max = std::min(x_max, (max_vel_[j] / a) * (max_vel_[j] / a));
+        const num_t limit = max_acc_[j] / std::fabs(a);
+        lowers_.push_back(bound_t(-limit, -b / a));
+        uppers_.push_back(bound_t(limit, -b / a));
+      } else if (std::fabs(b) > 0) {
+        x_max = std::min(x_max, max_acc_[j] / std::fabs(b));
+      }
+    }
+    if (i + 1 < (std::size_t)grid_.size()) {
+      lowers_.push_back(bound_t(next_min / (2 * step_), -1 / (2 * step_)));
+      uppers_.push_back(bound_t(next_max / (2 * step_), -1 / (2 * step_)));
+    }
+  }
+
+  /// \brief Interval of the values of x for which an admissible u exists.
+  void feasible_interval(num_t& x_min, num_t& x_max) const {
+    for (std::size_t l = 0; l < lowers_.size(); ++l) {
+      for (std::size_t v = 0; v < uppers_.size(); ++v) {
+        // lower(x) <= upper(x)
+        const num_t beta = lowers_[l].beta - uppers_[v].beta, alpha = uppers_[v].alpha - lowers_[l].alpha;
+        if (beta > 0)
+          x_max = std::min(x_max, alpha / beta);
+        else if (beta < 0)
+          x_min = std::max(x_min, alpha / beta);
+        else if (alpha < 0)
+          x_max = -1;
+      }
+    }
+  }
+
+  void backward_pass(const num_t end_x) {
+    const std::size_t N = (std::size_t)grid_.size() - 1;
+    k_min_ = vector_x_t::Zero(N + 1);
+    k_max_ = vector_x_t::Zero(N + 1);
+    num_t x_max;
+    constraints(N, 0., 0., x_max);
+    if (end_x > x_max) throw std::runtime_error("time_optimal_retiming : the final velocity exceeds the limits");
+    k_min_[N] = k_max_[N] = end_x;
+    for (std::size_t i = N; i-- > 0;) {
+      constraints(i, k_min_[i + 1], k_max_[i + 1], x_max);
+      num_t x_min = 0.;
+      feasible_interval(x_min, x_max);
+      if (x_min > x_max * (1 + 1e-9) + 1e-12)
+        throw std::runtime_error("time_optimal_retiming : the end of the path can not be reached with these limits");
+      k_min_[i] = x_min;
+      k_max_[i] = std::max(x_min, x_max);
+    }
+  }
+
+  void forward_pass(const num_t init_x) {
+    const std::size_t N = (std::size_t)grid_.size() - 1;
+    if (init_x < k_min_[0] * (1 - 1e-9) - 1e-12 || init_x > k_max_[0] * (1 + 1e-9) + 1e-12)
+      throw std::runtime_error(
+          "time_optimal_retiming : the end of the path can not be reached from the initial velocity");
+    x_ = vector_x_t::Zero(N + 1);
+    u_ = vector_x_t::Zero(N);
+    times_ = vector_x_t::Zero(N + 1);
+    x_[0] = init_x;
+    num_t x_max;
+    for (std::size_t i = 0; i < N; ++i) {
+      constraints(i, k_min_[i + 1], k_max_[i + 1], x_max);
+      num_t u = std::numeric_limits<num_t>::infinity();
+      for (std::size_t v = 0; v < uppers_.size(); ++v) u = std::min(u, uppers_[v].eval(x_[i]));
+      u_[i] = u;
+      x_[i + 1] = std::min(std::max(x_[i] + 2 * step_ * u, k_min_[i + 1]), k_max_[i + 1]);
+      const num_t sd = std::sqrt(x_[i]) + std::sqrt(x_[i + 1]);
+      if (!(sd > 0)) throw std::runtime_error("time_optimal_retiming : the path parameter does not progress");
+      times_[i + 1] = times_[i] + 2 * step_ / sd;
+    }
+  }
+
+  /*Attributes*/
+  vector_x_t max_vel_;
+  vector_x_t max_acc_;
+  num_t step_;
+  vector_x_t grid_;
+  std::vector<point_t, Eigen::aligned_allocator<point_t> > positions_;
+  std::vector<point_derivate_t, Eigen::aligned_allocator<point_derivate_t> > d1_, d2_;
+  vector_x_t k_min_, k_max_;  // reachable intervals of x
+  vector_x_t x_, u_, times_;
+  std::vector<bound_t> lowers_, uppers_;
+  /*Attributes*/
+};
+
+}  // namespace optimization
+}  // namespace curves
+#endif  //_CLASS_TIME_OPTIMAL_RETIMING
@@ -0,0 +1,68 @@
+/**
+ * \file parallel.h
+ * \brief Minimal thread based helpers used by the batch functions of the library.
+ */
+
+#ifndef _CURVES_PARALLEL
+#define _CURVES_PARALLEL
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace curves {
+
+/// \brief Number of threads used by the batch functions when none is specified.
+inline std::size_t default_num_threads() {
+  const unsigned int n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/// \brief Call f(i) for all i in [begin, end), splitting the range in contiguous chunks processed by different threads.
+/// The calling thread processes the last chunk. If f throws, the first exception (in chunk order) is rethrown in the
+/// calling thread once all the threads are joined.
+/// \param begin : first index.
+/// \param end : index after the last one.
+/// \param f : function called with each index, must be safe to call concurrently for different indices.
+/// \param num_threads : maximum number of threads used, 0 means default_num_threads().
+///
+template <typename Function>
+void parallel_for(const std::size_t begin, const std::size_t end, Function f, std::size_t num_threads = 0) {
+  if (end <= begin) return;
+  const std::size_t size = end - begin;
+  if (num_threads == 0) num_threads = default_num_threads();
+  num_threads = std::min(num_threads, size);
+  if (num_threads <= 1) {
+    for (std::size_t i = begin; i < end; ++i) f(i);
+    return;
+  }
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  const std::size_t chunk = size / num_threads, remainder = size % num_threads;
+  std::size_t chunk_begin = begin;
+  for (std::size_t id = 0; id < num_threads; ++id) {
+    const std::size_t chunk_end = chunk_begin + chunk + (id < remainder ? 1 : 0);
+    std::exception_ptr& error = errors[id];
+    auto run = [&f, &error, chunk_begin, chunk_end]() {
+      try {
+        for (std::size_t i = chunk_begin; i < chunk_end; ++i) f(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    };
+    if (id + 1 < num_threads)
+      threads.push_back(std::thread(run));
+    else
+      run();
+    chunk_begin = chunk_end;
+  }
+  for (std::size_t id = 0; id < threads.size(); ++id) threads[id].join();
+  for (std::size_t id = 0; id < num_threads; ++id) {
+    if (errors[id]) std::rethrow_exception(errors[id]);
+  }
+}
+
+}  // namespace curves
+#endif  //_CURVES_PARALLEL
@@ -8,6 +8,7 @@
 #ifndef _CLASS_PIECEWISE_CURVE
 #define _CLASS_PIECEWISE_CURVE
 
+#include "fwd.h"
 #include "curve_abc.h"
 #include "curve_conversion.h"
 #include <boost/smart_ptr/shared_ptr.hpp>
@@ -39,6 +40,8 @@ struct piecewise_curve : public curve_abc<Time, Numeric, Safe, Point, Point_deri
   typedef typename std::vector<curve_ptr_t> t_curve_ptr_t;
   typedef typename std::vector<Time> t_time_t;
   typedef piecewise_curve<Time, Numeric, Safe, Point, Point_derivate, CurveType> piecewise_curve_t;
+  typedef bezier_curve<Time, Numeric, Safe, Point> bezier_segment_t;  // segments modified by set_control_point
+  typedef polynomial<Time, Numeric, Safe, Point, t_point_t> polynomial_segment_t;  // and by set_coefficient
 
  public:
   /// \brief Empty constructor. Add at least one curve to call other class functions.
@@ -65,6 +68,17 @@ struct piecewise_curve : public curve_abc<Time, Numeric, Safe, Point, Point_deri
         T_min_(other.T_min_),
         T_max_(other.T_max_) {}
 
+  /// \brief Assignment operator, the segments are shared as in the copy constructor.
+  piecewise_curve& operator=(const piecewise_curve& other) {
+    dim_ = other.dim_;
+    curves_ = other.curves_;
+    time_curves_ = other.time_curves_;
+    size_ = other.size_;
+    T_min_ = other.T_min_;
+    T_max_ = other.T_max_;
+    return *this;
+  }
+
   virtual ~piecewise_curve() {}
 
   virtual point_t operator()(const Time t) const {
@@ -222,6 +236,48 @@ struct piecewise_curve : public curve_abc<Time, Numeric, Safe, Point, Point_deri
     return curves_[idx];
   }
 
+  /// \brief Set a control point of a bezier segment, see bezier_curve::set_control_point. The other segments are not
+  /// modified. A segment shared with another piecewise curve, for instance after a copy, is copied before being
+  /// modified so that the other curve is unchanged.
+  /// \param curve_index : index of the segment, which must be a bezier curve.
+  /// \param point_index : index of the control point in the segment.
+  /// \param point : new value of the control point.
+  ///
+  void set_control_point(const std::size_t curve_index, const std::size_t point_index, const point_t& point) {
+    mutable_segment<bezier_segment_t>(curve_index)->set_control_point(point_index, point);
+  }
+
+  /// \brief Set a control point of a bezier segment, then modify the neighbouring segments so that the curve is
+  /// continuous up to the given order at both ends of the segment. Only the control points or coefficients of the
+  /// neighbours that define their derivatives at the junction are modified, the neighbours must be bezier curves or
+  /// polynomials of degree at least 2 * order + 1 so that their other end is unchanged.
+  /// \param order : order of the derivatives made continuous.
+  ///
+  void set_control_point(const std::size_t curve_index, const std::size_t point_index, const point_t& point,
+                         const std::size_t order) {
+    set_control_point(curve_index, point_index, point);
+    enforce_continuity(curve_index, order);
+  }
+
+  /// \brief Set a coefficient of a polynomial segment, see polynomial::set_coefficient. As for set_control_point, the
+  /// other segments are not modified and a shared segment is copied.
+  /// \param curve_index : index of the segment, which must be a polynomial.
+  /// \param degree : degree of the coefficient.
+  /// \param value : new value of the coefficient.
+  ///
+  void set_coefficient(const std::size_t curve_index, const std::size_t degree, const point_t& value) {
+    mutable_segment<polynomial_segment_t>(curve_index)->set_coefficient(degree, value);
+  }
+
+  /// \brief Set a coefficient of a polynomial segment, then make the curve continuous up to the given order at both
+  /// ends of the segment, see set_control_point.
+  ///
+  void set_coefficient(const std::size_t curve_index, const std::size_t degree, const point_t& value,
+                       const std::size_t order) {
+    set_coefficient(curve_index, degree, value);
+    enforce_continuity(curve_index, order);
+  }
+
   template <typename Bezier>
   piecewise_curve_t convert_piecewise_curve_to_bezier() {
     check_if_not_empty();
@@ -395,6 +451,82 @@ struct piecewise_curve : public curve_abc<Time, Numeric, Safe, Point, Point_deri
     }
   }
 
+  /// \brief Segment of index curve_index cast to Segment, copied first if it is shared with another curve.
+  /// The copy is the derivative of order 0 of the segment, which keeps its type.
+  template <typename Segment>
+  Segment* mutable_segment(const std::size_t curve_index) {
+    check_if_not_empty();
+    if (curve_index >= size_) throw std::out_of_range("piecewise curve : index greater than the number of curves");
+    if (!dynamic_cast<Segment*>(curves_[curve_index].get()))
+      throw std::invalid_argument("piecewise curve : the segment does not have the type of the modification");
+    if (curves_[curve_index].use_count() > 1) curves_[curve_index].reset(curves_[curve_index]->compute_derivate_ptr(0));
+    return dynamic_cast<Segment*>(curves_[curve_index].get());
+  }
+
+  /// \brief Give to the neighbours of the segment curve_index its derivatives up to order at their junctions.
+  void enforce_continuity(const std::size_t curve_index, const std::size_t order) {
+    const curve_t& segment = *curves_[curve_index];
+    if (curve_index > 0) match_derivatives(curve_index - 1, segment, segment.min(), order, true);
+    if (curve_index + 1 < size_) match_derivatives(curve_index + 1, segment, segment.max(), order, false);
+  }
+
+  /// \brief Modify the segment index so that its derivatives up to order at its end (or start) are the ones of
+  /// reference at time t.
+  void match_derivatives(const std::size_t index, const curve_t& reference, const time_t t, const std::size_t order,
+                         const bool at_end) {
+    const curve_t& neighbour = *curves_[index];
+    if (neighbour.degree() < 2 * order + 1)
+      throw std::invalid_argument("piecewise curve : the degree of the neighbouring segments is too low");
+    t_point_t targets(1, reference(t));
+    for (std::size_t k = 1; k <= order; ++k) targets.push_back(reference.derivate(t, k));
+    if (dynamic_cast<const bezier_segment_t*>(&neighbour)) {
+      // the derivative of order k at the start is mult_T * n! / (n - k)! / T^k * sum_i (-1)^(k - i) C(k, i) P_i, and
+      // the same at the end with P_{n - i} and the opposite sign for odd k : P_k (or P_{n - k}) is found from P_{i<k}
+      bezier_segment_t* bezier = mutable_segment<bezier_segment_t>(index);
+      const std::size_t n = bezier->degree();
+      const time_t duration = bezier->max() - bezier->min();
+      for (std::size_t k = 0; k <= order; ++k) {
+        num_t scale = bezier->mult_T_;
+        for (std::size_t j = 0; j < k; ++j) scale *= (num_t)(n - j) / duration;
+        point_t point = (at_end && k % 2 == 1 ? point_t(-targets[k]) : targets[k]) / scale;
+        for (std::size_t i = 0; i < k; ++i)
+          point -= ((k - i) % 2 == 0 ? 1. : -1.) * (num_t)bin((unsigned int)k, (unsigned int)i) *
+                   bezier->waypoints()[at_end ? n - i : i];
+        bezier->set_control_point(at_end ? n - k : k, point);
+      }
+    } else if (dynamic_cast<const polynomial_segment_t*>(&neighbour)) {
+      polynomial_segment_t* pol = mutable_segment<polynomial_segment_t>(index);
+      const std::size_t n = pol->degree();
+      if (!at_end) {
+        // the derivative of order k at the start is k! c_k
+        num_t factorial = 1.;
+        for (std::size_t k = 0; k <= order; factorial *= (num_t)(++k)) pol->set_coefficient(k, targets[k] / factorial);
+        return;
+      }
+      // corrections of the coefficients of degree n - order, ..., n, which do not change the start of the segment
+      const time_t duration = pol->max() - pol->min();
+      typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+      matrix_x_t system = matrix_x_t::Zero(order + 1, order + 1), rhs(order + 1, dim_);
+      for (std::size_t k = 0; k <= order; ++k) {
+        rhs.row(k) = (targets[k] - (k == 0 ? point_t((*pol)(pol->max())) : point_t(pol->derivate(pol->max(), k))))
+                         .transpose();
+        for (std::size_t j = 0; j <= order; ++j) {
+          const std::size_t m = n - order + j;
+          num_t coefficient = std::pow(duration, (num_t)(m - k));
+          for (std::size_t i = 0; i < k; ++i) coefficient *= (num_t)(m - i);
+          system(k, j) = coefficient;
+        }
+      }
+      const matrix_x_t corrections = system.fullPivLu().solve(rhs);
+      for (std::size_t j = 0; j <= order; ++j) {
+        const std::size_t m = n - order + j;
+        pol->set_coefficient(m, point_t(pol->coeffAtDegree(m) + corrections.row(j).transpose()));
+      }
+    } else {
+      throw std::invalid_argument("piecewise curve : the neighbouring segments must be bezier curves or polynomials");
+    }
+  }
+
   /*Helpers*/
  public:
   /// \brief Get dimension of curve.
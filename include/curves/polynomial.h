@@ -329,6 +329,30 @@ struct polynomial : public curve_abc<Time, Numeric, Safe, Point> {
     return res;
   }
 
+  /// \brief Set the coefficient of the given degree without rebuilding the curve. The polynomial does not cache any
+  /// data computed from its coefficients, so that nothing else is updated.
+  /// \param degree : degree of the coefficient, at most the degree of the curve.
+  /// \param value : new value of the coefficient, of the dimension of the curve.
+  ///
+  void set_coefficient(const std::size_t degree, const point_t& value) {
+    check_if_not_empty();
+    if (degree > degree_) throw std::out_of_range("set_coefficient : degree greater than the degree of the curve");
+    if ((std::size_t)value.size() != dim_)
+      throw std::invalid_argument("set_coefficient : the value does not have the dimension of the curve");
+    coefficients_.col(degree) = value;
+  }
+
+  /// \brief Set all the coefficients, the degree of the curve being the number of columns minus one.
+  /// \param coefficients : matrix of the coefficients, with one row per dimension of the curve.
+  ///
+  void set_coefficients(const coeff_t& coefficients) {
+    check_if_not_empty();
+    if ((std::size_t)coefficients.rows() != dim_ || coefficients.cols() == 0)
+      throw std::invalid_argument("set_coefficients : the coefficients do not have the dimension of the curve");
+    coefficients_ = coefficients;
+    degree_ = coefficients_.cols() - 1;
+  }
+
  private:
   num_t fact(const std::size_t n, const std::size_t order) const {
     num_t res(1);
@@ -50,7 +50,7 @@ struct quadratic_variable {
     if (isZero()) {
       throw std::runtime_error("Not initialized! (isZero)");
     }
-    return val.transpose() * A() * val + b().transpose() * val + c();
+    return val.dot(A() * val) + b().dot(val) + c();
   }
 
   quadratic_variable& operator+=(const quadratic_variable& w1) {
@@ -0,0 +1,173 @@
+/**
+ * \file root_finding.h
+ * \brief Times at which a component of a curve crosses a given value.
+ *
+ * For a polynomial, the roots are the real eigenvalues of the companion matrix of the component, polished with Newton
+ * iterations. For a bezier curve, the control points of the component are subdivided until they do not change sign,
+ * see bernstein_roots. For a cubic hermite spline, each interval is solved as a polynomial.
+ */
+
+#ifndef _CLASS_ROOT_FINDING
+#define _CLASS_ROOT_FINDING
+
+#include "bezier_curve.h"
+#include "cubic_hermite_spline.h"
+#include "polynomial.h"
+#include "piecewise_curve.h"
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+namespace internal {
+/// \brief Real roots in [0, 1] of \f$ \sum_i c_i u^i \f$, appended in increasing order.
+template <typename Numeric>
+void power_basis_roots(std::vector<Numeric> coeffs, const Numeric prec, std::vector<Numeric>& roots) {
+  Numeric scale = 0.;
+  for (std::size_t i = 0; i < coeffs.size(); ++i) scale = std::max(scale, std::fabs(coeffs[i]));
+  if (!(scale > 0)) return;
+  // the leading coefficients that are negligible would give huge eigenvalues
+  while (std::fabs(coeffs.back()) <= scale * std::numeric_limits<Numeric>::epsilon()) coeffs.pop_back();
+  const long degree = (long)coeffs.size() - 1;
+  if (degree == 0) return;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_t;
+  matrix_t companion = matrix_t::Zero(degree, degree);
+  companion.bottomLeftCorner(degree - 1, degree - 1).setIdentity();
+  for (long i = 0; i < degree; ++i) companion(i, degree - 1) = -coeffs[i] / coeffs[degree];
+  const Eigen::EigenSolver<matrix_t> solver(companion, false);
+  std::vector<Numeric> found;
+  for (long i = 0; i < degree; ++i) {
+    // the roots of even multiplicity give pairs of eigenvalues with a small imaginary part
+    const std::complex<Numeric> eigenvalue = solver.eigenvalues()[i];
+    if (std::fabs(eigenvalue.imag()) > 1e-6 || eigenvalue.real() < -1e-6 || eigenvalue.real() > 1 + 1e-6) continue;
+    Numeric u = std::min(std::max(eigenvalue.real(), Numeric(0)), Numeric(1)), f = 0.;
+    for (int iter = 0; iter < 5; ++iter) {
+      Numeric df = 0.;
+      f = coeffs[degree];
+      for (long j = degree - 1; j >= 0; --j) {
+        df = df * u + f;
+        f = f * u + coeffs[j];
+      }
+      if (df == 0) break;
+      u = std::min(std::max(u - f / df, Numeric(0)), Numeric(1));
+    }
+    f = coeffs[degree];
+    for (long j = degree - 1; j >= 0; --j) f = f * u + coeffs[j];
+    if (std::fabs(f) <= scale * 1e-10) found.push_back(u);
+  }
+  std::sort(found.begin(), found.end());
+  std::vector<Numeric> unique;
+  for (std::size_t i = 0; i < found.size(); ++i) push_root(found[i], prec, unique);
+  roots.insert(roots.end(), unique.begin(), unique.end());
+}
+
+template <typename Numeric>
+void check_crossing_arguments(const std::size_t component, const std::size_t dim, const Numeric prec) {
+  if (component >= dim)
+    throw std::invalid_argument("crossing_times : the component exceeds the dimension of the curve");
+  if (!(prec > 0)) throw std::invalid_argument("crossing_times : the precision must be positive");
+}
+}  // namespace internal
+
+/// \brief Times at which the component of a polynomial is equal to value, found with the eigenvalues of the companion
+/// matrix of the component. Unlike bernstein_roots, the roots of even multiplicity are found.
+/// If the component is constant, no time is returned.
+/// \param curve : the polynomial.
+/// \param component : index of the component.
+/// \param value : the value crossed.
+/// \param times : output, the times are appended in increasing order.
+/// \param prec : precision of the times.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point, typename T_Point>
+void crossing_times(const polynomial<Time, Numeric, Safe, Point, T_Point>& curve, const std::size_t component,
+                    const Numeric value, std::vector<Time>& times, const Numeric prec = 1e-10) {
+  internal::check_crossing_arguments(component, curve.dim(), prec);
+  const Time duration = curve.max() - curve.min();
+  const typename polynomial<Time, Numeric, Safe, Point, T_Point>::coeff_t coefficients = curve.coeff();
+  // coefficients of the component in the variable u = (t - t_min) / duration
+  std::vector<Numeric> coeffs;
+  Numeric power = 1.;
+  for (long i = 0; i < coefficients.cols(); ++i, power *= duration)
+    coeffs.push_back(coefficients(component, i) * power);
+  coeffs[0] -= value;
+  std::vector<Numeric> roots;
+  internal::power_basis_roots(coeffs, prec / duration, roots);
+  for (std::size_t i = 0; i < roots.size(); ++i) times.push_back(curve.min() + roots[i] * duration);
+}
+
+/// \brief Times at which the component of a bezier curve is equal to value, found with bernstein_roots.
+/// See crossing_times(const polynomial&, ...) for the parameters.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point>
+void crossing_times(const bezier_curve<Time, Numeric, Safe, Point>& curve, const std::size_t component,
+                    const Numeric value, std::vector<Time>& times, const Numeric prec = 1e-10) {
+  internal::check_crossing_arguments(component, curve.dim(), prec);
+  const Time duration = curve.max() - curve.min();
+  std::vector<Numeric> coeffs;
+  for (std::size_t i = 0; i < curve.waypoints().size(); ++i)
+    coeffs.push_back(curve.mult_T_ * curve.waypoints()[i][component] - value);
+  std::vector<Numeric> roots;
+  bernstein_roots(coeffs, prec / duration, roots);
+  for (std::size_t i = 0; i < roots.size(); ++i) times.push_back(curve.min() + roots[i] * duration);
+}
+
+/// \brief Times at which the component of a cubic hermite spline is equal to value. Each interval of the spline is
+/// the cubic polynomial interpolating the positions and tangents of its ends. A time shared by two intervals is
+/// returned once. See crossing_times(const polynomial&, ...) for the parameters.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point>
+void crossing_times(const cubic_hermite_spline<Time, Numeric, Safe, Point>& curve, const std::size_t component,
+                    const Numeric value, std::vector<Time>& times, const Numeric prec = 1e-10) {
+  typedef polynomial<Time, Numeric, Safe, Point> polynomial_t;
+  internal::check_crossing_arguments(component, curve.dim(), prec);
+  const typename cubic_hermite_spline<Time, Numeric, Safe, Point>::vector_time_t knots = curve.getTime();
+  std::vector<Time> roots, found;
+  for (std::size_t i = 0; i + 1 < knots.size(); ++i) {
+    roots.clear();
+    const polynomial_t segment(curve(knots[i]), curve.derivate(knots[i], 1), curve(knots[i + 1]),
+                               curve.derivate(knots[i + 1], 1), knots[i], knots[i + 1]);
+    crossing_times(segment, component, value, roots, prec);
+    for (std::size_t j = 0; j < roots.size(); ++j) internal::push_root(roots[j], prec, found);
+  }
+  times.insert(times.end(), found.begin(), found.end());
+}
+
+/// \brief Times at which the component of a piecewise curve is equal to value. The bezier, polynomial and cubic
+/// hermite segments are handled by the functions above, the other segments can not be solved exactly and raise an
+/// invalid_argument error. A time shared by two segments is returned once.
+/// See crossing_times(const polynomial&, ...) for the parameters.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point, typename Point_derivate, typename CurveType>
+void crossing_times(const piecewise_curve<Time, Numeric, Safe, Point, Point_derivate, CurveType>& curve,
+                    const std::size_t component, const Numeric value, std::vector<Time>& times,
+                    const Numeric prec = 1e-10) {
+  typedef bezier_curve<Time, Numeric, Safe, Point> bezier_t;
+  typedef polynomial<Time, Numeric, Safe, Point> polynomial_t;
+  typedef cubic_hermite_spline<Time, Numeric, Safe, Point> cubic_hermite_spline_t;
+  internal::check_crossing_arguments(component, curve.dim(), prec);
+  std::vector<Time> roots, found;
+  for (std::size_t i = 0; i < curve.num_curves(); ++i) {
+    roots.clear();
+    const CurveType* segment = curve.curve_at_index(i).get();
+    if (const bezier_t* bezier = dynamic_cast<const bezier_t*>(segment))
+      crossing_times(*bezier, component, value, roots, prec);
+    else if (const polynomial_t* pol = dynamic_cast<const polynomial_t*>(segment))
+      crossing_times(*pol, component, value, roots, prec);
+    else if (const cubic_hermite_spline_t* hermite = dynamic_cast<const cubic_hermite_spline_t*>(segment))
+      crossing_times(*hermite, component, value, roots, prec);
+    else
+      throw std::invalid_argument("crossing_times : the segments must be bezier curves, polynomials or cubic hermite "
+                                  "splines");
+    for (std::size_t j = 0; j < roots.size(); ++j) internal::push_root(roots[j], prec, found);
+  }
+  times.insert(times.end(), found.begin(), found.end());
+}
+
+}  // namespace curves
+#endif  //_CLASS_ROOT_FINDING
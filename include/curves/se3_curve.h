@@ -37,6 +37,8 @@ struct SE3Curve : public curve_abc<Time, Numeric, Safe, Eigen::Transform<Numeric
   typedef SO3Linear<Time, Numeric, Safe> SO3Linear_t;
   typedef polynomial<Time, Numeric, Safe, pointX_t> polynomial_t;
   typedef SE3Curve<Time, Numeric, Safe> SE3Curve_t;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
 
  public:
   /* Constructors - destructors */
@@ -142,12 +144,61 @@ struct SE3Curve : public curve_abc<Time, Numeric, Safe, Eigen::Transform<Numeric
     if (translation_curve_->dim() != 3) {
       throw std::invalid_argument("Translation curve should always be of dimension 3");
     }
-    point_t res = point_t::Identity();
-    res.translate(point3_t((*translation_curve_)(t)));
-    res.rotate((*rotation_curve_)(t));
+    point_t res;
+    res.linear() = (*rotation_curve_)(t);
+    res.translation() = (*translation_curve_)(t);
+    res.makeAffine();
     return res;
   }
 
+  ///  \brief Evaluation of the translation and rotation of the SE3Curve at time t, without building the transform.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param translation : output, position at time t.
+  ///  \param rotation : output, rotation matrix at time t.
+  void evaluate(const time_t t, Eigen::Ref<point3_t> translation, Eigen::Ref<matrix3_t> rotation) const {
+    if (translation_curve_->dim() != 3) {
+      throw std::invalid_argument("Translation curve should always be of dimension 3");
+    }
+    translation = (*translation_curve_)(t);
+    rotation = (*rotation_curve_)(t);
+  }
+
+  ///  \brief Evaluation of the translation and rotation of the SE3Curve at time t, without building the transform.
+  ///  If the rotation curve is a SO3Linear, the quaternion is directly obtained from the slerp.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param translation : output, position at time t.
+  ///  \param rotation : output, rotation at time t.
+  void evaluate(const time_t t, Eigen::Ref<point3_t> translation, Quaternion& rotation) const {
+    if (translation_curve_->dim() != 3) {
+      throw std::invalid_argument("Translation curve should always be of dimension 3");
+    }
+    translation = (*translation_curve_)(t);
+    rotation = rotationAsQuaternion(t, dynamic_cast<const SO3Linear_t*>(rotation_curve_.get()));
+  }
+
+  ///  \brief Evaluation of the translation and rotation of the SE3Curve for several times.
+  ///  \param times : vector of size N of the times when to evaluate the curve.
+  ///  \param translations : output, matrix of size 3xN, column i is the position at time times[i].
+  ///  \param rotations : output, matrix of size 4xN, column i contains the coefficients (x,y,z,w) of the quaternion
+  ///  at time times[i].
+  void evaluate(const Eigen::Ref<const vector_x_t>& times, Eigen::Ref<matrix_x_t> translations,
+                Eigen::Ref<matrix_x_t> rotations) const {
+    if (translation_curve_->dim() != 3) {
+      throw std::invalid_argument("Translation curve should always be of dimension 3");
+    }
+    if (translations.rows() != 3 || translations.cols() != times.size()) {
+      throw std::invalid_argument("SE3Curve::evaluate : translations should be of size 3 x number of times");
+    }
+    if (rotations.rows() != 4 || rotations.cols() != times.size()) {
+      throw std::invalid_argument("SE3Curve::evaluate : rotations should be of size 4 x number of times");
+    }
+    const SO3Linear_t* so3 = dynamic_cast<const SO3Linear_t*>(rotation_curve_.get());
+    for (Eigen::Index i = 0; i < times.size(); ++i) {
+      translations.col(i) = (*translation_curve_)(times[i]);
+      rotations.col(i) = rotationAsQuaternion(times[i], so3).coeffs();
+    }
+  }
+
   /**
    * @brief isApprox check if other and *this are approximately equals.
    * Only two curves of the same class can be approximately equals, for comparison between different type of curves see
@@ -242,6 +293,14 @@ struct SE3Curve : public curve_abc<Time, Numeric, Safe, Eigen::Transform<Numeric
   }
 
  private:
+  /// \brief Evaluate the rotation as a quaternion, using the slerp directly when the rotation curve is a SO3Linear.
+  Quaternion rotationAsQuaternion(const time_t t, const SO3Linear_t* so3) const {
+    if (so3) {
+      return so3->computeAsQuaternion(t);
+    }
+    return Quaternion((*rotation_curve_)(t));
+  }
+
   void safe_check() {
     if (Safe) {
       if (T_min_ > T_max_) {
@@ -0,0 +1,266 @@
+#ifndef _STRUCT_SE3_CURVE_TYPED_H
+#define _STRUCT_SE3_CURVE_TYPED_H
+
+#include "MathDefs.h"
+#include "curve_abc.h"
+#include "so3_linear.h"
+#include "bezier_curve.h"
+#include <Eigen/Dense>
+
+namespace curves {
+
+/// \class SE3CurveTyped.
+/// \brief Composition of a translation curve and a rotation curve whose concrete types are known at compile time.
+/// Contrary to SE3Curve, the translation and rotation curves are stored by value: the evaluation does not go
+/// through virtual calls on the curves, and the translation curve is expected to return a fixed size point of
+/// dimension 3 (e.g. bezier3_t or polynomial3_t) so that no dynamic allocation occurs when sampling the curve.
+/// The class still derives from the same abstract class as SE3Curve and can thus be used in a piecewise_SE3_t.
+///
+template <typename Time = double, typename Numeric = Time, bool Safe = false,
+          typename TranslationCurve = bezier_curve<Time, Numeric, Safe, Eigen::Matrix<Numeric, 3, 1> >,
+          typename RotationCurve = SO3Linear<Time, Numeric, Safe> >
+struct SE3CurveTyped : public curve_abc<Time, Numeric, Safe, Eigen::Transform<Numeric, 3, Eigen::Affine>,
+                                        Eigen::Matrix<Numeric, 6, 1> > {
+  typedef Numeric Scalar;
+  typedef Eigen::Transform<Numeric, 3, Eigen::Affine> transform_t;
+  typedef transform_t point_t;
+  typedef Eigen::Matrix<Scalar, 6, 1> point_derivate_t;
+  typedef Eigen::Matrix<Scalar, 3, 1> translation_t;
+  typedef Eigen::Matrix<Scalar, 3, 3> rotation_t;
+  typedef Eigen::Quaternion<Scalar> Quaternion;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef Time time_t;
+  typedef TranslationCurve translation_curve_t;
+  typedef RotationCurve rotation_curve_t;
+  typedef curve_abc<Time, Numeric, Safe, point_t, point_derivate_t> curve_abc_t;  // parent class
+  typedef SE3CurveTyped<Time, Numeric, Safe, TranslationCurve, RotationCurve> SE3CurveTyped_t;
+
+ public:
+  /* Constructors - destructors */
+  /// \brief Empty constructor. Curve obtained this way can not perform other class functions.
+  ///
+  SE3CurveTyped() : curve_abc_t(), translation_curve_(), rotation_curve_(), T_min_(0), T_max_(0) {}
+
+  /// \brief Constructor from translation and rotation curves.
+  SE3CurveTyped(const translation_curve_t& translation_curve, const rotation_curve_t& rotation_curve)
+      : curve_abc_t(),
+        translation_curve_(translation_curve),
+        rotation_curve_(rotation_curve),
+        T_min_(translation_curve.min()),
+        T_max_(translation_curve.max()) {
+    if (translation_curve.dim() != 3) {
+      throw std::invalid_argument("The translation curve should be of dimension 3.");
+    }
+    if (rotation_curve.min() != T_min_) {
+      throw std::invalid_argument("Min bounds of translation and rotation curve are not the same.");
+    }
+    if (rotation_curve.max() != T_max_) {
+      throw std::invalid_argument("Max bounds of translation and rotation curve are not the same.");
+    }
+    safe_check();
+  }
+
+  /// \brief Constructor from curve for the translation and init/end rotation, with quaternion.
+  /// The rotation curve is built from the init/end rotation with the same time bounds as the translation curve.
+  SE3CurveTyped(const translation_curve_t& translation_curve, const Quaternion& init_rot, const Quaternion& end_rot)
+      : curve_abc_t(),
+        translation_curve_(translation_curve),
+        rotation_curve_(init_rot, end_rot, translation_curve.min(), translation_curve.max()),
+        T_min_(translation_curve.min()),
+        T_max_(translation_curve.max()) {
+    if (translation_curve.dim() != 3) {
+      throw std::invalid_argument("The translation curve should be of dimension 3.");
+    }
+    safe_check();
+  }
+
+  /// \brief Constructor from curve for the translation and init/end rotation, with rotation matrix.
+  /// The rotation curve is built from the init/end rotation with the same time bounds as the translation curve.
+  SE3CurveTyped(const translation_curve_t& translation_curve, const rotation_t& init_rot, const rotation_t& end_rot)
+      : curve_abc_t(),
+        translation_curve_(translation_curve),
+        rotation_curve_(init_rot, end_rot, translation_curve.min(), translation_curve.max()),
+        T_min_(translation_curve.min()),
+        T_max_(translation_curve.max()) {
+    if (translation_curve.dim() != 3) {
+      throw std::invalid_argument("The translation curve should be of dimension 3.");
+    }
+    safe_check();
+  }
+
+  /// \brief Destructor
+  ~SE3CurveTyped() {}
+  /* Constructors - destructors */
+
+  /*Operations*/
+  ///  \brief Evaluation of the SE3CurveTyped at time t
+  ///  \param t : time when to evaluate the curve.
+  ///  \return \f$x(t)\f$ transform corresponding on the curve at time t.
+  virtual point_t operator()(const time_t t) const {
+    point_t res;
+    res.linear() = rotation_curve_(t);
+    res.translation() = translation_curve_(t);
+    res.makeAffine();
+    return res;
+  }
+
+  ///  \brief Evaluation of the translation at time t.
+  translation_t translation(const time_t t) const { return translation_curve_(t); }
+
+  ///  \brief Evaluation of the rotation at time t.
+  rotation_t rotation(const time_t t) const { return rotation_curve_(t); }
+
+  ///  \brief Evaluation of the translation and rotation at time t, without building the transform.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param translation : output, position at time t.
+  ///  \param rotation : output, rotation matrix at time t.
+  void evaluate(const time_t t, Eigen::Ref<translation_t> translation, Eigen::Ref<rotation_t> rotation) const {
+    translation = translation_curve_(t);
+    rotation = rotation_curve_(t);
+  }
+
+  ///  \brief Evaluation of the translation and rotation at time t, without building the transform.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param translation : output, position at time t.
+  ///  \param rotation : output, rotation at time t.
+  void evaluate(const time_t t, Eigen::Ref<translation_t> translation, Quaternion& rotation) const {
+    translation = translation_curve_(t);
+    rotation = rotationAsQuaternion(rotation_curve_, t);
+  }
+
+  ///  \brief Evaluation of the translation and rotation for several times.
+  ///  \param times : vector of size N of the times when to evaluate the curve.
+  ///  \param translations : output, matrix of size 3xN, column i is the position at time times[i].
+  ///  \param rotations : output, matrix of size 4xN, column i contains the coefficients (x,y,z,w) of the quaternion
+  ///  at time times[i].
+  void evaluate(const Eigen::Ref<const vector_x_t>& times, Eigen::Ref<matrix_x_t> translations,
+                Eigen::Ref<matrix_x_t> rotations) const {
+    if (translations.rows() != 3 || translations.cols() != times.size()) {
+      throw std::invalid_argument("SE3CurveTyped::evaluate : translations should be of size 3 x number of times");
+    }
+    if (rotations.rows() != 4 || rotations.cols() != times.size()) {
+      throw std::invalid_argument("SE3CurveTyped::evaluate : rotations should be of size 4 x number of times");
+    }
+    for (Eigen::Index i = 0; i < times.size(); ++i) {
+      translations.col(i) = translation_curve_(times[i]);
+      rotations.col(i) = rotationAsQuaternion(rotation_curve_, times[i]).coeffs();
+    }
+  }
+
+  /**
+   * @brief isApprox check if other and *this are approximately equals.
+   * Only two curves of the same class can be approximately equals, for comparison between different type of curves see
+   * isEquivalent
+   * @param other the other curve to check
+   * @param prec the precision treshold, default Eigen::NumTraits<Numeric>::dummy_precision()
+   * @return true is the two curves are approximately equals
+   */
+  bool isApprox(const SE3CurveTyped_t& other,
+                const Numeric prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    return curves::isApprox<Numeric>(T_min_, other.min()) && curves::isApprox<Numeric>(T_max_, other.max()) &&
+           translation_curve_.isApprox(other.translation_curve_, prec) &&
+           rotation_curve_.isApprox(other.rotation_curve_, prec);
+  }
+
+  virtual bool isApprox(const curve_abc_t* other,
+                        const Numeric prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    const SE3CurveTyped_t* other_cast = dynamic_cast<const SE3CurveTyped_t*>(other);
+    if (other_cast)
+      return isApprox(*other_cast, prec);
+    else
+      return false;
+  }
+
+  virtual bool operator==(const SE3CurveTyped_t& other) const { return isApprox(other); }
+
+  virtual bool operator!=(const SE3CurveTyped_t& other) const { return !(*this == other); }
+
+  ///  \brief Evaluation of the derivative of order N of the curve at time t.
+  ///  \param t : the time when to evaluate the curve.
+  ///  \param order : order of derivative.
+  ///  \return \f$\frac{d^Nx(t)}{dt^N}\f$ (linear_x,linear_y,linear_z,angular_x,angular_y,angular_z) at time t.
+  virtual point_derivate_t derivate(const time_t t, const std::size_t order) const {
+    point_derivate_t res;
+    res.template head<3>() = translation_curve_.derivate(t, order);
+    res.template tail<3>() = rotation_curve_.derivate(t, order);
+    return res;
+  }
+
+  SE3CurveTyped_t compute_derivate(const std::size_t /*order*/) const {
+    throw std::logic_error("Compute derivate for SE3 is not implemented yet.");
+  }
+
+  ///  \brief Compute the derived curve at order N.
+  ///  \param order : order of derivative.
+  ///  \return A pointer to \f$\frac{d^Nx(t)}{dt^N}\f$ derivative order N of the curve.
+  SE3CurveTyped_t* compute_derivate_ptr(const std::size_t order) const {
+    return new SE3CurveTyped_t(compute_derivate(order));
+  }
+  /*Operations*/
+
+  /*Helpers*/
+  /// \brief Get dimension of curve.
+  /// \return dimension of curve.
+  std::size_t virtual dim() const { return 6; };
+  /// \brief Get the minimum time for which the curve is defined
+  /// \return \f$t_{min}\f$ lower bound of time range.
+  time_t min() const { return T_min_; }
+  /// \brief Get the maximum time for which the curve is defined.
+  /// \return \f$t_{max}\f$ upper bound of time range.
+  time_t max() const { return T_max_; }
+  /// \brief Get the degree of the curve.
+  /// \return \f$degree\f$, the degree of the curve.
+  virtual std::size_t degree() const { return translation_curve_.degree(); }
+  /// \brief const accessor to the translation curve
+  const translation_curve_t& translation_curve() const { return translation_curve_; }
+  /// \brief const accessor to the rotation curve
+  const rotation_curve_t& rotation_curve() const { return rotation_curve_; }
+  /*Helpers*/
+
+  /*Attributes*/
+  translation_curve_t translation_curve_;
+  rotation_curve_t rotation_curve_;
+  time_t T_min_, T_max_;
+  /*Attributes*/
+
+  // Serialization of the class
+  friend class boost::serialization::access;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    if (version) {
+      // Do something depending on version ?
+    }
+    ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(curve_abc_t);
+    ar& boost::serialization::make_nvp("translation_curve", translation_curve_);
+    ar& boost::serialization::make_nvp("rotation_curve", rotation_curve_);
+    ar& boost::serialization::make_nvp("T_min", T_min_);
+    ar& boost::serialization::make_nvp("T_max", T_max_);
+  }
+
+ private:
+  /// \brief Evaluate a SO3Linear as a quaternion directly from the slerp.
+  static Quaternion rotationAsQuaternion(const SO3Linear<Time, Numeric, Safe>& rotation_curve, const time_t t) {
+    return rotation_curve.computeAsQuaternion(t);
+  }
+
+  /// \brief Evaluate any other rotation curve as a quaternion from its rotation matrix.
+  template <typename OtherRotationCurve>
+  static Quaternion rotationAsQuaternion(const OtherRotationCurve& rotation_curve, const time_t t) {
+    return Quaternion(rotation_t(rotation_curve(t)));
+  }
+
+  void safe_check() {
+    if (Safe) {
+      if (T_min_ > T_max_) {
+        throw std::invalid_argument("Tmin should be inferior to Tmax");
+      }
+    }
+  }
+
+};  // SE3CurveTyped
+
+}  // namespace curves
+
+#endif  // _STRUCT_SE3_CURVE_TYPED_H
@@ -16,11 +16,13 @@
 #include "curves/curve_abc.h"
 #include "curves/so3_linear.h"
 #include "curves/se3_curve.h"
+#include "curves/se3_curve_typed.h"
 #include "curves/polynomial.h"
 #include "curves/bezier_curve.h"
 #include "curves/piecewise_curve.h"
 #include "curves/exact_cubic.h"
 #include "curves/cubic_hermite_spline.h"
+#include "curves/bspline_curve.h"
 
 
 #endif  // ifndef CURVES_SERIALIZAION
@@ -0,0 +1,397 @@
+/**
+ * \file flat-binary.hpp
+ * \brief Flat binary format of piecewise curves, that can be memory mapped and evaluated without deserialization.
+ *
+ * The file is made of a header, the times of the junctions of the segments, one record per segment and the
+ * coefficients of all the segments, each array being contiguous and aligned on 8 bytes :
+ *
+ * | flat_header | double times[num_segments + 1] | flat_segment segments[num_segments] | double data[dim * columns] |
+ *
+ * Each segment is a bezier curve, whose control points are already multiplied by its mult_T_, or a polynomial
+ * in \f$ t - t_{min} \f$, and its degree + 1 points or coefficients are consecutive columns of data. The numbers are
+ * stored in the byte order of the machine that wrote the file, which is checked when the file is read.
+ */
+
+#ifndef __curves_serialization_flat_binary_hpp__
+#define __curves_serialization_flat_binary_hpp__
+
+#include "curves/bezier_curve.h"
+#include "curves/cubic_hermite_spline.h"
+#include "curves/piecewise_curve.h"
+#include "curves/polynomial.h"
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace curves {
+namespace serialization {
+
+/// \brief Version of the format written by to_flat_binary. Files with a greater version are rejected.
+static const boost::uint32_t FLAT_BINARY_VERSION = 1;
+
+/// \brief Basis of the coefficients of a segment.
+enum flat_basis { FLAT_BEZIER = 0, FLAT_POLYNOMIAL = 1 };
+
+/// \struct flat_header.
+/// \brief Header of the flat binary format. The offsets are in bytes from the beginning of the header.
+struct flat_header {
+  char magic[8];                // "CURVFLAT"
+  boost::uint32_t version;      // FLAT_BINARY_VERSION of the writer
+  boost::uint32_t byte_order;   // 0x01020304 in the byte order of the writer
+  boost::uint64_t dim;          // dimension of the points
+  boost::uint64_t num_segments;
+  boost::uint64_t num_columns;  // total number of points or coefficients
+  boost::uint64_t times_offset;
+  boost::uint64_t segments_offset;
+  boost::uint64_t data_offset;
+  boost::uint64_t size;         // size of the whole file
+};
+
+/// \struct flat_segment.
+/// \brief Record of a segment of the flat binary format.
+struct flat_segment {
+  boost::uint64_t column;  // index of the first point or coefficient of the segment in data
+  boost::uint32_t degree;
+  boost::uint32_t basis;   // flat_basis
+};
+
+namespace internal {
+static const char FLAT_MAGIC[8] = {'C', 'U', 'R', 'V', 'F', 'L', 'A', 'T'};
+static const boost::uint32_t FLAT_BYTE_ORDER = 0x01020304;
+
+inline boost::uint64_t align_8(const boost::uint64_t offset) { return (offset + 7) / 8 * 8; }
+
+/// \brief Append a segment ending at time max, whose points or coefficients are the columns of coefficients.
+inline void append_flat_segment(const Eigen::MatrixXd& coefficients, const flat_basis basis, const double max,
+                                std::vector<double>& times, std::vector<flat_segment>& segments,
+                                std::vector<double>& data) {
+  flat_segment record;
+  record.column = data.size() / coefficients.rows();
+  record.degree = (boost::uint32_t)(coefficients.cols() - 1);
+  record.basis = basis;
+  data.insert(data.end(), coefficients.data(), coefficients.data() + coefficients.size());
+  segments.push_back(record);
+  times.push_back(max);
+}
+}  // namespace internal
+
+/// \class flat_curve_view.
+/// \brief Piecewise curve read in place in a buffer of the flat binary format, for instance a memory mapped file.
+/// The view does not own the buffer, which must outlive it. Only the header is read at construction, and each segment
+/// record is checked when it is used : the evaluation finds the segment by binary search in the times and evaluates
+/// it on the stored coefficients.
+///
+class flat_curve_view {
+ public:
+  typedef double time_t;
+  typedef double num_t;
+  typedef Eigen::VectorXd point_t;
+  typedef Eigen::Map<const Eigen::MatrixXd> coefficients_t;
+
+  /// \brief Empty view, that can not be evaluated.
+  flat_curve_view() : header_(NULL), times_(NULL), segments_(NULL), data_(NULL) {}
+
+  /// \brief Constructor, checks the header and the sizes of the arrays.
+  /// \param buffer : beginning of the buffer, aligned on 8 bytes.
+  /// \param size : size of the buffer in bytes.
+  ///
+  flat_curve_view(const char* buffer, const std::size_t size) {
+    if (reinterpret_cast<std::size_t>(buffer) % 8 != 0)
+      throw std::invalid_argument("flat_curve_view : the buffer must be aligned on 8 bytes");
+    if (size < sizeof(flat_header)) throw std::invalid_argument("flat_curve_view : the buffer is too small");
+    header_ = reinterpret_cast<const flat_header*>(buffer);
+    if (std::memcmp(header_->magic, internal::FLAT_MAGIC, 8) != 0)
+      throw std::invalid_argument("flat_curve_view : the buffer is not in the flat binary format");
+    if (header_->byte_order != internal::FLAT_BYTE_ORDER)
+      throw std::runtime_error("flat_curve_view : the buffer was written with another byte order");
+    if (header_->version > FLAT_BINARY_VERSION)
+      throw std::runtime_error("flat_curve_view : the version of the buffer is not supported");
+    // the sizes are compared by divisions, so that corrupted headers can not make them overflow
+    const boost::uint64_t n = header_->num_segments;
+    if (n == 0 || header_->dim == 0 || header_->size > size || header_->times_offset < sizeof(flat_header) ||
+        header_->segments_offset < header_->times_offset || header_->data_offset < header_->segments_offset ||
+        header_->size < header_->data_offset ||
+        (header_->segments_offset - header_->times_offset) / sizeof(double) <= n ||
+        (header_->data_offset - header_->segments_offset) / sizeof(flat_segment) < n ||
+        (header_->size - header_->data_offset) / sizeof(double) / header_->dim < header_->num_columns ||
+        header_->times_offset % 8 != 0 || header_->segments_offset % 8 != 0 || header_->data_offset % 8 != 0)
+      throw std::invalid_argument("flat_curve_view : the sizes of the buffer are not consistent");
+    times_ = reinterpret_cast<const double*>(buffer + header_->times_offset);
+    segments_ = reinterpret_cast<const flat_segment*>(buffer + header_->segments_offset);
+    data_ = reinterpret_cast<const double*>(buffer + header_->data_offset);
+  }
+
+  ///  \brief Evaluation of the curve at time t.
+  ///  \param t : time when to evaluate the curve.
+  ///  \return \f$x(t)\f$ point corresponding on curve at time t.
+  point_t operator()(const time_t t) const { return derivate(t, 0); }
+
+  ///  \brief Evaluate the derivative of order N of curve at time t.
+  ///  \param t : time when to evaluate the curve.
+  ///  \param order : order of derivative.
+  ///  \return \f$\frac{d^Nx(t)}{dt^N}\f$ point corresponding on derivative curve of order N at time t.
+  point_t derivate(const time_t t, const std::size_t order) const {
+    check_if_not_empty();
+    if (t < min() || t > max()) throw std::invalid_argument("flat_curve_view : time t is out of range");
+    const std::size_t i = find_interval(t);
+    const flat_segment& segment = segments_[i];
+    const coefficients_t coefficients = segment_coefficients(i);
+    const std::size_t degree = segment.degree;
+    point_t res = point_t::Zero(dim());
+    if (order > degree) return res;
+    if (segment.basis == FLAT_POLYNOMIAL) {
+      // Horner scheme on the derivatives of the monomials
+      const time_t dt = t - times_[i];
+      for (std::size_t j = degree + 1; j-- > order;) {
+        num_t factor = 1.;
+        for (std::size_t k = 0; k < order; ++k) factor *= (num_t)(j - k);
+        res = dt * res + factor * coefficients.col(j);
+      }
+      return res;
+    }
+    // de Casteljau algorithm on the finite differences of the control points
+    const time_t duration = times_[i + 1] - times_[i];
+    const num_t u = (t - times_[i]) / duration;
+    Eigen::MatrixXd points = coefficients;
+    num_t factor = 1.;
+    for (std::size_t k = 0; k < order; ++k) {
+      factor *= (num_t)(degree - k) / duration;
+      for (std::size_t j = 0; j + k < degree; ++j) points.col(j) = points.col(j + 1) - points.col(j);
+    }
+    for (std::size_t m = degree - order; m > 0; --m) {
+      for (std::size_t j = 0; j < m; ++j) points.col(j) = (1 - u) * points.col(j) + u * points.col(j + 1);
+    }
+    return factor * points.col(0);
+  }
+
+  /// \brief Points or coefficients of the segment i, mapped on the buffer.
+  coefficients_t segment_coefficients(const std::size_t i) const {
+    check_segment(i);
+    return coefficients_t(data_ + segments_[i].column * header_->dim, (long)header_->dim, segments_[i].degree + 1);
+  }
+  /// \brief Basis of the coefficients of the segment i, see flat_basis.
+  flat_basis segment_basis(const std::size_t i) const {
+    check_segment(i);
+    return (flat_basis)segments_[i].basis;
+  }
+  /// \brief Degree of the segment i.
+  std::size_t segment_degree(const std::size_t i) const {
+    check_index(i);
+    return segments_[i].degree;
+  }
+  /// \brief Time range \f$[t_i, t_{i+1}]\f$ of the segment i.
+  time_t segment_min(const std::size_t i) const {
+    check_index(i);
+    return times_[i];
+  }
+  time_t segment_max(const std::size_t i) const {
+    check_index(i);
+    return times_[i + 1];
+  }
+
+  /// \brief Piecewise curve with the same segments, for instance to save it with the boost archives.
+  /// \tparam Piecewise : piecewise curve whose segments can be bezier curves and polynomials.
+  ///
+  template <typename Piecewise>
+  Piecewise to_piecewise() const {
+    typedef typename Piecewise::bezier_segment_t bezier_t;
+    typedef typename Piecewise::polynomial_segment_t polynomial_t;
+    check_if_not_empty();
+    Piecewise res;
+    for (std::size_t i = 0; i < num_segments(); ++i) {
+      const Eigen::MatrixXd coefficients = segment_coefficients(i);
+      if (segments_[i].basis == FLAT_POLYNOMIAL) {
+        res.add_curve(polynomial_t(coefficients, times_[i], times_[i + 1]));
+      } else {
+        typename bezier_t::t_point_t points;
+        for (long j = 0; j < coefficients.cols(); ++j) points.push_back(coefficients.col(j));
+        res.add_curve(bezier_t(points.begin(), points.end(), times_[i], times_[i + 1]));
+      }
+    }
+    return res;
+  }
+
+  /*Helpers*/
+  /// \brief Get dimension of curve.
+  /// \return dimension of curve.
+  std::size_t dim() const { return header_ ? header_->dim : 0; }
+  /// \brief Get the minimum time for which the curve is defined
+  /// \return \f$t_{min}\f$, lower bound of time range.
+  time_t min() const { return header_ ? times_[0] : 0.; }
+  /// \brief Get the maximum time for which the curve is defined.
+  /// \return \f$t_{max}\f$, upper bound of time range.
+  time_t max() const { return header_ ? times_[header_->num_segments] : 0.; }
+  /// \brief Number of segments of the curve.
+  std::size_t num_segments() const { return header_ ? header_->num_segments : 0; }
+  /// \brief Version of the format of the buffer.
+  boost::uint32_t version() const { return header_ ? header_->version : 0; }
+  /*Helpers*/
+
+ private:
+  std::size_t find_interval(const time_t t) const {
+    const double* it = std::upper_bound(times_ + 1, times_ + header_->num_segments, t);
+    return it - times_ - 1;
+  }
+
+  void check_index(const std::size_t i) const {
+    check_if_not_empty();
+    if (i >= num_segments()) throw std::out_of_range("flat_curve_view : index greater than the number of segments");
+  }
+
+  /// \brief Check that the record of the segment i is in the data and has a known basis.
+  void check_segment(const std::size_t i) const {
+    check_index(i);
+    const flat_segment& segment = segments_[i];
+    if (segment.column > header_->num_columns ||
+        header_->num_columns - segment.column < (boost::uint64_t)segment.degree + 1 ||
+        (segment.basis != FLAT_BEZIER && segment.basis != FLAT_POLYNOMIAL))
+      throw std::invalid_argument("flat_curve_view : the record of the segment is not consistent");
+  }
+
+  void check_if_not_empty() const {
+    if (!header_) throw std::runtime_error("Error in flat_curve_view : no buffer / did you use empty constructor ?");
+  }
+
+  const flat_header* header_;
+  const double* times_;
+  const flat_segment* segments_;
+  const double* data_;
+};  // End class flat_curve_view
+
+/// \class flat_curve_file.
+/// \brief File of the flat binary format mapped in memory, read only. The pages of the file are loaded by the system
+/// when the curve is evaluated, so that opening the file does not depend on its size.
+///
+class flat_curve_file : private boost::noncopyable {
+ public:
+  /// \brief Map the file and check its header.
+  /// \param filename : path of a file written by save_flat_binary.
+  ///
+  explicit flat_curve_file(const std::string& filename) : data_(MAP_FAILED), size_(0) {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::invalid_argument(filename + " does not seem to be a valid file.");
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+      size_ = (std::size_t)status.st_size;
+      data_ = ::mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data_ == MAP_FAILED) throw std::runtime_error(filename + " can not be mapped in memory.");
+    try {
+      view_ = flat_curve_view(static_cast<const char*>(data_), size_);
+    } catch (...) {
+      ::munmap(data_, size_);
+      throw;
+    }
+  }
+
+  ~flat_curve_file() { ::munmap(data_, size_); }
+
+  /// \brief View of the curve, valid while the file is mapped.
+  const flat_curve_view& view() const { return view_; }
+
+ private:
+  void* data_;
+  std::size_t size_;
+  flat_curve_view view_;
+};  // End class flat_curve_file
+
+/// \brief Write a piecewise curve in the flat binary format. The bezier and polynomial segments are stored as they
+/// are, each interval of the cubic hermite splines is stored as a polynomial. The other segments can not be stored
+/// exactly and raise an invalid_argument error.
+/// \param curve : the piecewise curve.
+/// \return the buffer, to be written in a file or read with flat_curve_view.
+///
+template <typename Time, typename Numeric, bool Safe, typename Point, typename Point_derivate, typename CurveType>
+std::vector<char> to_flat_binary(const piecewise_curve<Time, Numeric, Safe, Point, Point_derivate, CurveType>& curve) {
+  typedef bezier_curve<Time, Numeric, Safe, Point> bezier_t;
+  typedef polynomial<Time, Numeric, Safe, Point> polynomial_t;
+  typedef cubic_hermite_spline<Time, Numeric, Safe, Point> cubic_hermite_spline_t;
+  if (curve.num_curves() == 0) throw std::invalid_argument("to_flat_binary : the curve is empty");
+  std::vector<double> times(1, curve.min());
+  std::vector<flat_segment> segments;
+  std::vector<double> data;
+  for (std::size_t i = 0; i < curve.num_curves(); ++i) {
+    const CurveType* segment = curve.curve_at_index(i).get();
+    if (const bezier_t* bezier = dynamic_cast<const bezier_t*>(segment)) {
+      Eigen::MatrixXd points(curve.dim(), bezier->waypoints().size());
+      for (std::size_t j = 0; j < bezier->waypoints().size(); ++j)
+        points.col(j) = bezier->mult_T_ * bezier->waypoints()[j];
+      internal::append_flat_segment(points, FLAT_BEZIER, segment->max(), times, segments, data);
+    } else if (const polynomial_t* pol = dynamic_cast<const polynomial_t*>(segment)) {
+      internal::append_flat_segment(pol->coeff(), FLAT_POLYNOMIAL, segment->max(), times, segments, data);
+    } else if (const cubic_hermite_spline_t* hermite = dynamic_cast<const cubic_hermite_spline_t*>(segment)) {
+      // each interval is the cubic polynomial interpolating the positions and tangents of its ends
+      const typename cubic_hermite_spline_t::vector_time_t knots = hermite->getTime();
+      for (std::size_t j = 0; j + 1 < knots.size(); ++j) {
+        const polynomial_t interval((*hermite)(knots[j]), hermite->derivate(knots[j], 1), (*hermite)(knots[j + 1]),
+                                    hermite->derivate(knots[j + 1], 1), knots[j], knots[j + 1]);
+        internal::append_flat_segment(interval.coeff(), FLAT_POLYNOMIAL, knots[j + 1], times, segments, data);
+      }
+    } else {
+      throw std::invalid_argument(
+          "to_flat_binary : the segments must be bezier curves, polynomials or cubic hermite splines");
+    }
+  }
+  flat_header header;
+  std::memcpy(header.magic, internal::FLAT_MAGIC, 8);
+  header.version = FLAT_BINARY_VERSION;
+  header.byte_order = internal::FLAT_BYTE_ORDER;
+  header.dim = curve.dim();
+  header.num_segments = segments.size();
+  header.num_columns = data.size() / curve.dim();
+  header.times_offset = internal::align_8(sizeof(flat_header));
+  header.segments_offset = internal::align_8(header.times_offset + times.size() * sizeof(double));
+  header.data_offset = internal::align_8(header.segments_offset + segments.size() * sizeof(flat_segment));
+  header.size = header.data_offset + data.size() * sizeof(double);
+  std::vector<char> buffer(header.size, 0);
+  std::memcpy(&buffer[0], &header, sizeof(flat_header));
+  std::memcpy(&buffer[header.times_offset], &times[0], times.size() * sizeof(double));
+  std::memcpy(&buffer[header.segments_offset], &segments[0], segments.size() * sizeof(flat_segment));
+  std::memcpy(&buffer[header.data_offset], &data[0], data.size() * sizeof(double));
+  return buffer;
+}
+
+/// \brief Save a piecewise curve in a file of the flat binary format, see to_flat_binary.
+template <typename Piecewise>
+void save_flat_binary(const Piecewise& curve, const std::string& filename) {
+  const std::vector<char> buffer = to_flat_binary(curve);
+  std::ofstream ofs(filename.c_str(), std::ios::binary);
+  if (!ofs) throw std::invalid_argument(filename + " does not seem to be a valid file.");
+  ofs.write(&buffer[0], buffer.size());
+}
+
+/// \brief Convert a piecewise curve saved with saveAsBinary in a file of the flat binary format.
+/// \tparam Piecewise : type of the saved curve.
+///
+template <typename Piecewise>
+void convert_binary_to_flat(const std::string& binary_filename, const std::string& flat_filename) {
+  Piecewise curve;
+  curve.template loadFromBinary<Piecewise>(binary_filename);
+  save_flat_binary(curve, flat_filename);
+}
+
+/// \brief Convert a file of the flat binary format in a piecewise curve saved with saveAsBinary.
+/// \tparam Piecewise : type of the saved curve, see flat_curve_view::to_piecewise.
+///
+template <typename Piecewise>
+void convert_flat_to_binary(const std::string& flat_filename, const std::string& binary_filename) {
+  const flat_curve_file file(flat_filename);
+  file.view().template to_piecewise<Piecewise>().template saveAsBinary<Piecewise>(binary_filename);
+}
+
+}  // namespace serialization
+}  // namespace curves
+#endif  // __curves_serialization_flat_binary_hpp__
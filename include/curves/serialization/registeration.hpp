@@ -45,6 +45,10 @@ void register_types(Archive& ar) {
   ar.template register_type<SO3Linear_t>();
   ar.template register_type<SE3Curve_t>();
   ar.template register_type<piecewise_SE3_t>();
+  ar.template register_type<SE3CurveBezier3_t>();
+  ar.template register_type<SE3CurvePolynomial3_t>();
+  ar.template register_type<bspline_t>();
+  ar.template register_type<bspline3_t>();
 }
 
 }  // namespace serialization
@@ -0,0 +1,183 @@
+/**
+ * \file simplification.h
+ * \brief Approximation of a curve by a piecewise bezier curve with few segments, under a maximal deviation.
+ *
+ * The segments are built from the start of the curve. Each segment is a bezier curve interpolating the curve at its
+ * ends, and its tangents if the approximation must be C1, the other control points being fitted in the least squares
+ * sense to samples of the curve. The deviation is checked on the samples and on the midpoints between them, so that
+ * the oscillations of the curve between the samples are seen. The length of each segment is the longest one for which
+ * this deviation stays under the tolerance : it is doubled while the fit succeeds, then refined by bisection, so that
+ * the number of fits is logarithmic in the ratio of the lengths of the segments.
+ */
+
+#ifndef _CLASS_SIMPLIFICATION
+#define _CLASS_SIMPLIFICATION
+
+#include "bezier_curve.h"
+
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace curves {
+/// \struct simplification_settings.
+/// \brief Parameters of simplify.
+template <typename Numeric = double>
+struct simplification_settings {
+  simplification_settings()
+      : tolerance(1e-3),
+        velocity_tolerance(std::numeric_limits<Numeric>::infinity()),
+        degree(3),
+        continuity(1),
+        samples(32),
+        min_duration(1e-6) {}
+
+  Numeric tolerance;           // maximal distance between the curve and its approximation
+  Numeric velocity_tolerance;  // maximal distance between their velocities, infinity to ignore the velocities
+  std::size_t degree;          // degree of the segments
+  std::size_t continuity;      // 0 or 1, order of the derivatives interpolated at the ends, 0 if degree < 3
+  std::size_t samples;         // number of samples of the curve used to fit each segment
+  Numeric min_duration;        // duration of the segments under which the tolerance is not enforced
+};
+
+/// \struct simplification_result.
+/// \brief Approximation computed by simplify, and its maximal deviations on the samples and their midpoints.
+template <typename Bezier>
+struct simplification_result {
+  typedef typename Bezier::piecewise_curve_t piecewise_curve_t;
+  typedef typename Bezier::num_t num_t;
+
+  piecewise_curve_t curve;
+  num_t position_error;  // maximal distance between the curve and its approximation on the checked times
+  num_t velocity_error;  // maximal distance between their velocities, 0 if the velocities are ignored
+};
+
+namespace internal {
+/// \brief Bezier curve of degree settings.degree approximating curve between t0 and t1.
+/// \param position_error, velocity_error : output, deviations on the samples and on the midpoints between them.
+template <typename Bezier, typename Curve>
+Bezier fit_segment(const Curve& curve, const typename Bezier::time_t t0, const typename Bezier::time_t t1,
+                   const simplification_settings<typename Bezier::num_t>& settings,
+                   typename Bezier::num_t& position_error, typename Bezier::num_t& velocity_error) {
+  typedef typename Bezier::num_t num_t;
+  typedef typename Bezier::point_t point_t;
+  typedef typename Bezier::t_point_t t_point_t;
+  typedef Eigen::Matrix<num_t, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  const std::size_t n = settings.degree, k = settings.samples;
+  const num_t duration = t1 - t0;
+  t_point_t control_points(n + 1);
+  control_points.front() = curve(t0);
+  control_points.back() = curve(t1);
+  std::size_t first = 1, last = n - 1;  // free control points
+  if (settings.continuity > 0 && n >= 3) {
+    control_points[1] = control_points.front() + curve.derivate(t0, 1) * duration / (num_t)n;
+    control_points[n - 1] = control_points.back() - curve.derivate(t1, 1) * duration / (num_t)n;
+    first = 2;
+    last = n - 2;
+  }
+  // samples and Bernstein basis at the samples
+  matrix_x_t basis(k, n + 1), targets(k, curve.dim());
+  for (std::size_t j = 0; j < k; ++j) {
+    const num_t u = (num_t)j / (num_t)(k - 1);
+    targets.row(j) = curve(t0 + u * duration).transpose();
+    for (std::size_t i = 0; i <= n; ++i)
+      basis(j, i) = bin((unsigned int)n, (unsigned int)i) * std::pow(u, (num_t)i) * std::pow(1 - u, (num_t)(n - i));
+  }
+  if (first <= last) {
+    for (std::size_t i = 0; i <= n; ++i) {
+      if (i < first || i > last) targets -= basis.col(i) * control_points[i].transpose();
+    }
+    const matrix_x_t free_basis = basis.middleCols(first, last - first + 1);
+    const matrix_x_t x = (free_basis.transpose() * free_basis).ldlt().solve(free_basis.transpose() * targets);
+    for (std::size_t i = first; i <= last; ++i) control_points[i] = x.row(i - first).transpose();
+  }
+  const Bezier res(control_points.begin(), control_points.end(), t0, t1);
+  position_error = 0.;
+  velocity_error = 0.;
+  const bool check_velocity = settings.velocity_tolerance < std::numeric_limits<num_t>::infinity();
+  // the odd indices are the midpoints between the samples of the fit
+  for (std::size_t j = 0; j <= 2 * (k - 1); ++j) {
+    const num_t t = t0 + duration * (num_t)j / (num_t)(2 * (k - 1));
+    position_error = std::max(position_error, (res(t) - point_t(curve(t))).norm());
+    if (check_velocity)
+      velocity_error = std::max(velocity_error, (res.derivate(t, 1) - point_t(curve.derivate(t, 1))).norm());
+  }
+  return res;
+}
+}  // namespace internal
+
+/// \brief Approximate a curve by a piecewise bezier curve with as few segments as the greedy construction of the
+/// segments allows, such that the deviations on the samples and their midpoints stay under the tolerances of settings.
+/// \param curve : any curve_abc, of which the points can be converted to Bezier::point_t.
+/// \param settings : tolerances and parameters of the segments.
+/// \return the approximation and its deviations. The deviations exceed the tolerances if a segment of duration
+/// settings.min_duration does not satisfy them.
+///
+template <typename Bezier, typename Curve>
+simplification_result<Bezier> simplify(const Curve& curve,
+                                       const simplification_settings<typename Bezier::num_t>& settings) {
+  typedef typename Bezier::time_t time_t;
+  typedef typename Bezier::num_t num_t;
+  if (settings.degree < 1) throw std::invalid_argument("simplify : the degree must be at least 1");
+  if (settings.samples < settings.degree + 1)
+    throw std::invalid_argument("simplify : the number of samples must exceed the degree");
+  if (!(settings.tolerance > 0) || !(settings.velocity_tolerance > 0))
+    throw std::invalid_argument("simplify : the tolerances must be positive");
+  const time_t t_min = curve.min(), t_max = curve.max();
+  if (!(t_max > t_min)) throw std::invalid_argument("simplify : the curve must have a positive duration");
+  simplification_result<Bezier> res;
+  res.position_error = 0.;
+  res.velocity_error = 0.;
+  const time_t min_duration = std::max(settings.min_duration, (t_max - t_min) * 1e-12);
+  time_t t = t_min, step = (t_max - t_min) / 16;
+  num_t position_error, velocity_error;
+  while (t < t_max) {
+    // lo is a valid length or min_duration, hi an invalid length
+    time_t lo = 0., hi = std::numeric_limits<time_t>::infinity();
+    step = std::max(std::min(step, t_max - t), std::min(min_duration, t_max - t));
+    for (;;) {
+      internal::fit_segment<Bezier>(curve, t, t + step, settings, position_error, velocity_error);
+      if (position_error <= settings.tolerance && velocity_error <= settings.velocity_tolerance) {
+        lo = step;
+        if (t + step >= t_max || hi < std::numeric_limits<time_t>::infinity()) break;
+        step = std::min(2 * step, t_max - t);
+      } else {
+        hi = step;
+        if (lo > 0 || step <= min_duration) break;
+        step = std::max(step / 2, min_duration);
+      }
+    }
+    if (lo > 0 && hi < std::numeric_limits<time_t>::infinity()) {
+      // bisection between the valid and invalid lengths, up to 1% of the length
+      while (hi - lo > 0.01 * lo) {
+        const time_t middle = (lo + hi) / 2;
+        internal::fit_segment<Bezier>(curve, t, t + middle, settings, position_error, velocity_error);
+        if (position_error <= settings.tolerance && velocity_error <= settings.velocity_tolerance)
+          lo = middle;
+        else
+          hi = middle;
+      }
+    }
+    step = lo > 0 ? lo : step;
+    const time_t end = t_max - (t + step) < min_duration ? t_max : t + step;
+    res.curve.add_curve(internal::fit_segment<Bezier>(curve, t, end, settings, position_error, velocity_error));
+    res.position_error = std::max(res.position_error, position_error);
+    res.velocity_error = std::max(res.velocity_error, velocity_error);
+    step = end - t;
+    t = end;
+  }
+  return res;
+}
+
+/// \brief Same as simplify(curve, settings), with the default settings.
+template <typename Bezier, typename Curve>
+simplification_result<Bezier> simplify(const Curve& curve) {
+  return simplify<Bezier>(curve, simplification_settings<typename Bezier::num_t>());
+}
+
+}  // namespace curves
+#endif  //_CLASS_SIMPLIFICATION
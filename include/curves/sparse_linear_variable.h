@@ -0,0 +1,219 @@
+/**
+ * \file sparse_linear_variable.h
+ * \brief storage for variable points of the form p_i = B_i x + c_i, with B_i a sparse matrix
+ * \version 0.1
+ *
+ * In the optimization problems, each control point only depends on a few variables
+ * (or on none of them for the constant control points), and B_i has only Dim non zero
+ * coefficients per variable block. This class stores B_i as a sparse matrix and is used
+ * internally to build the problems; it is converted to dense matrices when filling the
+ * quadratic_problem.
+ */
+
+#ifndef _CLASS_SPARSE_LINEAR_VARIABLE
+#define _CLASS_SPARSE_LINEAR_VARIABLE
+
+#include "curves/linear_variable.h"
+#include "curves/quadratic_variable.h"
+
+#include <Eigen/Sparse>
+#include <vector>
+#include <stdexcept>
+
+namespace curves {
+template <typename Numeric = double, bool Safe = true>
+struct sparse_linear_variable {
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, 1> vector_x_t;
+  typedef Eigen::Matrix<Numeric, Eigen::Dynamic, Eigen::Dynamic> matrix_x_t;
+  typedef Eigen::SparseMatrix<Numeric> sparse_matrix_t;
+  typedef Eigen::Triplet<Numeric> triplet_t;
+  typedef sparse_linear_variable<Numeric, Safe> sparse_linear_variable_t;
+  typedef linear_variable<Numeric, Safe> linear_variable_t;
+
+  sparse_linear_variable() : B_(0, 0), c_(vector_x_t::Zero(0)), zero(true) {}                        // variable
+  sparse_linear_variable(const vector_x_t& c) : B_(c.size(), c.size()), c_(c), zero(false) {}        // constant
+  sparse_linear_variable(const sparse_matrix_t& B, const vector_x_t& c) : B_(B), c_(c), zero(false) {}  // mixed
+  /// \brief Conversion from a dense linear variable, only the non zero coefficients of B are stored.
+  explicit sparse_linear_variable(const linear_variable_t& other)
+      : B_(other.B().sparseView()), c_(other.c()), zero(other.isZero()) {}
+
+  // linear evaluation
+  vector_x_t operator()(const Eigen::Ref<const vector_x_t>& val) const {
+    if (isZero()) return c();
+    if (Safe && B().cols() != val.rows())
+      throw std::length_error("Cannot evaluate linear variable, variable value does not have the correct dimension");
+    return B() * val + c();
+  }
+
+  sparse_linear_variable_t& operator+=(const sparse_linear_variable_t& w1) {
+    if (w1.isZero()) return *this;
+    if (isZero()) {
+      this->B_ = w1.B_;
+      zero = w1.isZero();
+    } else {
+      this->B_ += w1.B_;
+    }
+    this->c_ += w1.c_;
+    return *this;
+  }
+  sparse_linear_variable_t& operator-=(const sparse_linear_variable_t& w1) {
+    if (w1.isZero()) return *this;
+    if (isZero()) {
+      this->B_ = -w1.B_;
+      zero = w1.isZero();
+    } else {
+      this->B_ -= w1.B_;
+    }
+    this->c_ -= w1.c_;
+    return *this;
+  }
+  sparse_linear_variable_t& operator/=(const double d) {
+    B_ /= d;
+    c_ /= d;
+    return *this;
+  }
+  sparse_linear_variable_t& operator*=(const double d) {
+    B_ *= d;
+    c_ *= d;
+    return *this;
+  }
+
+  /// \brief In place fused operation *this += a * x, see linear_variable::axpy.
+  sparse_linear_variable_t& axpy(const Numeric a, const sparse_linear_variable_t& x) {
+    if (x.isZero()) return *this;
+    if (isZero()) {
+      this->B_ = a * x.B_;
+      this->c_ = a * x.c_;
+      zero = false;
+    } else {
+      this->B_ += a * x.B_;
+      this->c_ += a * x.c_;
+    }
+    return *this;
+  }
+
+  /// \brief Set *this to a * x + b * y, see linear_variable::set_linear_combination.
+  sparse_linear_variable_t& set_linear_combination(const Numeric a, const sparse_linear_variable_t& x,
+                                                   const Numeric b, const sparse_linear_variable_t& y) {
+    if (x.isZero()) {
+      if (y.isZero()) {
+        *this = sparse_linear_variable_t();
+        return *this;
+      }
+      this->B_ = b * y.B_;
+      this->c_ = b * y.c_;
+    } else if (y.isZero()) {
+      this->B_ = a * x.B_;
+      this->c_ = a * x.c_;
+    } else {
+      if (Safe && (x.B_.rows() != y.B_.rows() || x.B_.cols() != y.B_.cols() || x.c_.size() != y.c_.size()))
+        throw std::length_error("Cannot combine linear variables, dimensions do not match");
+      this->B_ = a * x.B_ + b * y.B_;
+      this->c_ = a * x.c_ + b * y.c_;
+    }
+    zero = false;
+    return *this;
+  }
+
+  static sparse_linear_variable_t Zero(size_t dim = 0) {
+    sparse_matrix_t B(dim, dim);
+    B.setIdentity();
+    return sparse_linear_variable_t(B, vector_x_t::Zero(dim));
+  }
+
+  std::size_t size() const { return zero ? 0 : std::max(B_.cols(), c_.size()); }
+
+  Numeric norm() const { return isZero() ? 0 : (B_.norm() + c_.norm()); }
+
+  bool isApprox(const sparse_linear_variable_t& other,
+                const double prec = Eigen::NumTraits<Numeric>::dummy_precision()) const {
+    return (*this - other).norm() < prec;
+  }
+
+  /// \brief Conversion to a dense linear variable.
+  linear_variable_t to_dense() const {
+    if (isZero()) return linear_variable_t();
+    return linear_variable_t(matrix_x_t(B_), c_);
+  }
+
+  const sparse_matrix_t& B() const { return B_; }
+  const vector_x_t& c() const { return c_; }
+  bool isZero() const { return zero; }
+
+ private:
+  sparse_matrix_t B_;
+  vector_x_t c_;
+  bool zero;
+};
+
+template <typename N, bool S>
+inline sparse_linear_variable<N, S> operator+(const sparse_linear_variable<N, S>& w1,
+                                              const sparse_linear_variable<N, S>& w2) {
+  if (w2.isZero()) return w1;
+  sparse_linear_variable<N, S> res;
+  return res.set_linear_combination(1., w1, 1., w2);
+}
+
+template <typename N, bool S>
+inline sparse_linear_variable<N, S> operator+(sparse_linear_variable<N, S>&& w1,
+                                              const sparse_linear_variable<N, S>& w2) {
+  w1 += w2;
+  return std::move(w1);
+}
+
+template <typename N, bool S>
+sparse_linear_variable<N, S> operator-(const sparse_linear_variable<N, S>& w1, const sparse_linear_variable<N, S>& w2) {
+  if (w2.isZero()) return w1;
+  sparse_linear_variable<N, S> res;
+  return res.set_linear_combination(1., w1, -1., w2);
+}
+
+template <typename N, bool S>
+inline sparse_linear_variable<N, S> operator-(sparse_linear_variable<N, S>&& w1,
+                                              const sparse_linear_variable<N, S>& w2) {
+  w1 -= w2;
+  return std::move(w1);
+}
+
+template <typename N, bool S>
+sparse_linear_variable<N, S> operator*(const double k, const sparse_linear_variable<N, S>& w) {
+  sparse_linear_variable<N, S> res(w);
+  return res *= k;
+}
+
+template <typename N, bool S>
+sparse_linear_variable<N, S> operator*(const sparse_linear_variable<N, S>& w, const double k) {
+  sparse_linear_variable<N, S> res(w);
+  return res *= k;
+}
+
+template <typename N, bool S>
+sparse_linear_variable<N, S> operator/(const sparse_linear_variable<N, S>& w, const double k) {
+  sparse_linear_variable<N, S> res(w);
+  return res /= k;
+}
+
+/// \brief res = a * x + b * y, see linear_variable::set_linear_combination.
+template <typename N, bool S>
+inline void linear_combination(sparse_linear_variable<N, S>& res, const N a, const sparse_linear_variable<N, S>& x,
+                               const N b, const sparse_linear_variable<N, S>& y) {
+  res.set_linear_combination(a, x, b, y);
+}
+
+// same computation as the product of dense linear variables, only works with diagonal linear variables
+template <typename N, bool S>
+inline quadratic_variable<N> operator*(const sparse_linear_variable<N, S>& w1, const sparse_linear_variable<N, S>& w2) {
+  typedef quadratic_variable<N> quad_var_t;
+  typedef typename quad_var_t::matrix_x_t matrix_x_t;
+  typedef typename quad_var_t::point_t point_t;
+  point_t ones = point_t::Ones(w1.c().size());
+  point_t b1 = w1.B().transpose() * ones, b2 = w2.B().transpose() * ones;
+  // omitting all transposes since A matrices are diagonals
+  matrix_x_t A = (b1.array() * b2.array()).matrix().asDiagonal();
+  point_t b = w2.B().transpose() * w1.c() + w1.B().transpose() * w2.c();
+  N c = w1.c().transpose() * w2.c();
+  return quad_var_t(A, b, c);
+}
+
+}  // namespace curves
+#endif  //_CLASS_SPARSE_LINEAR_VARIABLE
@@ -15,6 +15,7 @@ static const bool safe = true;
 typedef problem_definition<pointX_t, real> problem_definition_t;
 typedef problem_data<pointX_t, real> problem_data_t;
 typedef quadratic_problem<pointX_t, real> quadratic_problem_t;
+typedef sparse_quadratic_problem<pointX_t, real> sparse_quadratic_problem_t;
 
 problem_data_t setup_control_points_t(problem_definition_t& pDef) {
   problem_data_t pData = setup_control_points<pointX_t, real, safe>(pDef);
@@ -27,6 +28,35 @@ Eigen::Matrix<real, Eigen::Dynamic, Eigen::Dynamic> problem_t_ineqMatrix(const q
 }
 Eigen::Matrix<real, Eigen::Dynamic, 1> problem_t_ineqVector(const quadratic_problem_t& p) { return p.ineqVector; }
 
+// the sparse inequality matrix is exposed in compressed sparse column format, so that
+// scipy.sparse.csc_matrix((A_data, A_indices, A_indptr), shape=A_shape) rebuilds it.
+// Each of these properties copies and compresses the matrix : read them once per problem.
+quadratic_variable_t sparse_problem_t_cost(const sparse_quadratic_problem_t& p) { return p.cost; }
+Eigen::Matrix<real, Eigen::Dynamic, 1> sparse_problem_t_ineqVector(const sparse_quadratic_problem_t& p) {
+  return p.ineqVector;
+}
+Eigen::Matrix<real, Eigen::Dynamic, 1> sparse_problem_t_data(const sparse_quadratic_problem_t& p) {
+  sparse_quadratic_problem_t::sparse_matrix_t A(p.ineqMatrix);
+  A.makeCompressed();
+  return Eigen::Map<const Eigen::Matrix<real, Eigen::Dynamic, 1> >(A.valuePtr(), A.nonZeros());
+}
+Eigen::VectorXi sparse_problem_t_indices(const sparse_quadratic_problem_t& p) {
+  sparse_quadratic_problem_t::sparse_matrix_t A(p.ineqMatrix);
+  A.makeCompressed();
+  return Eigen::Map<const Eigen::VectorXi>(A.innerIndexPtr(), A.nonZeros());
+}
+Eigen::VectorXi sparse_problem_t_indptr(const sparse_quadratic_problem_t& p) {
+  sparse_quadratic_problem_t::sparse_matrix_t A(p.ineqMatrix);
+  A.makeCompressed();
+  return Eigen::Map<const Eigen::VectorXi>(A.outerIndexPtr(), A.outerSize() + 1);
+}
+bp::tuple sparse_problem_t_shape(const sparse_quadratic_problem_t& p) {
+  return bp::make_tuple(p.ineqMatrix.rows(), p.ineqMatrix.cols());
+}
+Eigen::Matrix<real, Eigen::Dynamic, Eigen::Dynamic> sparse_problem_t_dense(const sparse_quadratic_problem_t& p) {
+  return p.ineqMatrix;
+}
+
 Eigen::Matrix<real, Eigen::Dynamic, Eigen::Dynamic> cost_t_quad(const quadratic_variable_t& p) {
   Eigen::Matrix<real, Eigen::Dynamic, Eigen::Dynamic> A = p.A();
   return A;
@@ -45,6 +75,15 @@ quadratic_problem_t generate_integral_problem_t(const problem_definition_t& pDef
   return generate_problem<problem_definition_t::point_t, real, true>(pDef, c);
 }
 
+sparse_quadratic_problem_t generate_sparse_problem_t(const problem_definition_t& pDef, const quadratic_variable_t& c) {
+  return generate_sparse_problem<pointX_t, real, true>(pDef, c);
+}
+
+sparse_quadratic_problem_t generate_sparse_integral_problem_t(const problem_definition_t& pDef,
+                                                              const integral_cost_flag c) {
+  return generate_sparse_problem<problem_definition_t::point_t, real, true>(pDef, c);
+}
+
 void set_pd_flag(problem_definition_t* pDef, const int flag) { pDef->flag = (constraint_flag)(flag); }
 void set_start(problem_definition_t* pDef, const pointX_t& val) { pDef->init_pos = val; }
 void set_end(problem_definition_t* pDef, const pointX_t& val) { pDef->end_pos = val; }
@@ -126,6 +165,18 @@ void exposeOptimization() {
   bp::def("generate_problem", &generate_problem_t);
   bp::def("generate_integral_problem", &generate_integral_problem_t);
 
+  bp::class_<sparse_quadratic_problem_t>("sparse_quadratic_problem", bp::init<>())
+      .add_property("cost", &sparse_problem_t_cost)
+      .add_property("A_data", &sparse_problem_t_data)
+      .add_property("A_indices", &sparse_problem_t_indices)
+      .add_property("A_indptr", &sparse_problem_t_indptr)
+      .add_property("A_shape", &sparse_problem_t_shape)
+      .add_property("b", &sparse_problem_t_ineqVector)
+      .def("A_dense", &sparse_problem_t_dense);
+
+  bp::def("generate_sparse_problem", &generate_sparse_problem_t);
+  bp::def("generate_sparse_integral_problem", &generate_sparse_integral_problem_t);
+
   bp::class_<problem_data_t>("problem_data", bp::no_init)
       .def("bezier", &pDataBezier, bp::return_value_policy<bp::manage_new_object>())
       .def_readonly("numControlPoints", &problem_data_t::numControlPoints)
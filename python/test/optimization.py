@@ -4,8 +4,8 @@ import eigenpy
 from numpy import array, matrix, zeros
 from numpy.linalg import norm
 
-from curves.optimization import (constraint_flag, generate_integral_problem, integral_cost_flag, problem_definition,
-                                 setup_control_points)
+from curves.optimization import (constraint_flag, generate_integral_problem, generate_sparse_integral_problem,
+                                 integral_cost_flag, problem_definition, setup_control_points)
 
 eigenpy.switchToNumpyArray()
 
@@ -34,6 +34,28 @@ class TestProblemDefinition(unittest.TestCase):
         self.assertTrue(norm(bezierFixed(0.) - pD.init_pos) <= 0.001)
         self.assertTrue(norm(bezierFixed.derivate(0.0, 1) - pD.init_vel) <= 0.001)
 
+    def test_sparse_problem(self):
+        pD = problem_definition(3)
+        pD.init_pos = array([[0., 0., 0.]]).T
+        pD.end_pos = array([[1., 1., 1.]]).T
+        pD.flag = constraint_flag.INIT_POS | constraint_flag.END_POS
+        pD.splits = array([[0.4, 0.8]]).T
+        for _ in range(3):
+            pD.addInequality(array([[1., 0., 0.], [0., 1., 0.]]), array([[2.], [2.]]))
+        dense = generate_integral_problem(pD, integral_cost_flag.ACCELERATION)
+        sparse = generate_sparse_integral_problem(pD, integral_cost_flag.ACCELERATION)
+        self.assertEqual(sparse.A_shape, dense.A.shape)
+        # rebuild the dense matrix from the compressed sparse column format
+        A = zeros(sparse.A_shape)
+        data, indices, indptr = sparse.A_data, sparse.A_indices, sparse.A_indptr
+        for col in range(sparse.A_shape[1]):
+            for k in range(indptr[col], indptr[col + 1]):
+                A[indices[k], col] = data[k]
+        self.assertTrue(norm(A - dense.A) <= 1e-9)
+        self.assertTrue(norm(sparse.A_dense() - dense.A) <= 1e-9)
+        self.assertTrue(norm(sparse.b - dense.b) <= 1e-9)
+        self.assertTrue(norm(sparse.cost.A - dense.cost.A) <= 1e-9)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -4,13 +4,29 @@
 #include "curves/polynomial.h"
 #include "curves/helpers/effector_spline.h"
 #include "curves/helpers/effector_spline_rotation.h"
+#include "curves/helpers/effector_spline_batch.h"
 #include "curves/curve_conversion.h"
 #include "curves/cubic_hermite_spline.h"
 #include "curves/piecewise_curve.h"
+#include "curves/bounding_volume_hierarchy.h"
+#include "curves/closest_point.h"
+#include "curves/arc_length.h"
+#include "curves/root_finding.h"
+#include "curves/extrema.h"
+#include "curves/simplification.h"
+#include "curves/bspline_curve.h"
+#include "curves/serialization/flat-binary.hpp"
 #include "curves/optimization/definitions.h"
+#include "curves/optimization/qp_solver.h"
+#include "curves/optimization/receding_horizon_problem.h"
+#include "curves/optimization/problem_derivatives.h"
+#include "curves/optimization/OptimizeSpline.h"
+#include "curves/optimization/time_optimal_retiming.h"
+#include "curves/optimization/least_squares_fitting.h"
 #include "load_problem.h"
 #include "curves/so3_linear.h"
 #include "curves/se3_curve.h"
+#include "curves/se3_curve_typed.h"
 #include <string>
 #include <iostream>
 #include <cmath>
@@ -91,6 +107,18 @@ void CompareCurves(const curve1& c1, const curve2& c2, const std::string& errMsg
   }
 }
 
+/// \brief Control points of an arbitrary curve in 3D, used by the tests of the geometric queries.
+/// \param num_points : number of control points, at most 7.
+template <typename PointList>
+PointList ControlPolygon(const std::size_t num_points) {
+  static const double coordinates[7][3] = {{0., 0., 0.},   {3., -1., 2.}, {-1., 4., 1.}, {2., 2., -3.},
+                                           {1., -2., 0.5}, {-2., 1., 3.}, {4., 0., -1.}};
+  PointList points;
+  for (std::size_t i = 0; i < num_points; ++i)
+    points.push_back(point3_t(coordinates[i][0], coordinates[i][1], coordinates[i][2]));
+  return points;
+}
+
 /*Cubic Function tests*/
 void PolynomialCubicFunctionTest(bool& error) {
   std::string errMsg("In test CubicFunctionTest ; unexpected result for x ");
@@ -796,9 +824,63 @@ void EffectorSplineRotationWayPointRotationTest(bool& error) {
   ComparePoints(q_end, eff_traj(10), errmsg, error);
 }
 
+void EffectorSplineBatchTest(bool& error) {
+  std::string errmsg("Error in EffectorSplineBatchTest; ");
+  const std::size_t N = 13, num_samples = 7;
+  helpers::effector_batch batch;
+  batch.lift_positions = Eigen::Matrix3Xd::Random(3, N);
+  batch.land_positions = Eigen::Matrix3Xd::Random(3, N);
+  batch.lift_times = Eigen::VectorXd::LinSpaced(N, 0., 12.);
+  batch.land_times = batch.lift_times + Eigen::VectorXd::Constant(N, 0.8);
+  batch.land_normals = Eigen::Matrix3Xd::Random(3, N);
+  batch.lift_quats = Eigen::Matrix4Xd::Random(4, N);
+  batch.lift_quats.colwise().normalize();
+  batch.land_quats = Eigen::Matrix4Xd::Random(4, N);
+  batch.land_quats.colwise().normalize();
+  batch.lift_offset = 0.05;
+  std::vector<helpers::exact_cubic_t> splines;
+  helpers::effector_splines(batch, splines, 4);
+  Eigen::MatrixXd positions(3, N * num_samples), configs(7, N * num_samples);
+  helpers::sample_effector_splines(batch, num_samples, positions, 4);
+  helpers::sample_effector_splines_rotation(batch, num_samples, configs, 3);
+  if (splines.size() != N) {
+    std::cout << errmsg << "wrong number of splines" << std::endl;
+    error = true;
+    return;
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    helpers::T_Waypoint waypoints;
+    waypoints.push_back(std::make_pair(batch.lift_times[i], pointX_t(batch.lift_positions.col(i))));
+    waypoints.push_back(std::make_pair(batch.land_times[i], pointX_t(batch.land_positions.col(i))));
+    helpers::exact_cubic_t* expected = helpers::effector_spline(
+        waypoints.begin(), waypoints.end(), Eigen::Vector3d::UnitZ(), batch.land_normals.col(i), batch.lift_offset);
+    const helpers::quat_t lift_quat(batch.lift_quats.col(i)), land_quat(batch.land_quats.col(i));
+    const helpers::quat_ref_const_t to_quat(lift_quat), to_land(land_quat);
+    helpers::effector_spline_rotation expected_rotation(waypoints.begin(), waypoints.end(), to_quat, to_land,
+                                                        Eigen::Vector3d::UnitZ(), batch.land_normals.col(i),
+                                                        batch.lift_offset);
+    const double dt = (batch.land_times[i] - batch.lift_times[i]) / (num_samples - 1);
+    for (std::size_t j = 0; j < num_samples; ++j) {
+      const double t = j + 1 < num_samples ? batch.lift_times[i] + dt * j : batch.land_times[i];
+      ComparePoints((*expected)(t), splines[i](t), errmsg + "spline", error);
+      ComparePoints((*expected)(t), positions.col(i * num_samples + j), errmsg + "sampled position", error);
+      ComparePoints(expected_rotation(t), configs.col(i * num_samples + j), errmsg + "sampled configuration", error);
+    }
+    delete expected;
+  }
+  // wrong output size
+  try {
+    Eigen::MatrixXd wrong(3, N);
+    helpers::sample_effector_splines(batch, num_samples, wrong);
+    std::cout << errmsg << "output of wrong size should raise an invalid_argument error" << std::endl;
+    error = true;
+  } catch (std::invalid_argument&) {
+  }
+}
+
 void TestReparametrization(bool& error) {
   helpers::rotation_spline s;
-  const helpers::exact_cubic_constraint_one_dim& sp = s.time_reparam_;
+  const helpers::polynomial_one_dim_t& sp = s.time_reparam();
   if (!QuasiEqual(sp.min(), 0.0)) {
     std::cout << "in TestReparametrization; min value is not 0, got " << sp.min() << std::endl;
     error = true;
@@ -823,6 +905,76 @@ void TestReparametrization(bool& error) {
   }
 }
 
+void RotationSplineDerivateTest(bool& error) {
+  std::string errmsg("Error in RotationSplineDerivateTest; ");
+  Eigen::Quaterniond q_from(Eigen::AngleAxisd(0.3, Eigen::Vector3d(1, 2, 3).normalized()));
+  Eigen::Quaterniond q_to(Eigen::AngleAxisd(1.2, Eigen::Vector3d(-1, 0, 2).normalized()));
+  helpers::rotation_spline s(q_from.coeffs(), q_to.coeffs(), 1., 3.);
+  helpers::rotation_spline s2(q_to.coeffs(), q_from.coeffs(), 0., 2.);
+  if (&s.time_reparam() != &s2.time_reparam()) {
+    std::cout << errmsg << "time reparametrization is not shared between instances" << std::endl;
+    error = true;
+  }
+  const double eps = 1e-6;
+  for (double t = 1.1; t < 2.95; t += 0.15) {
+    // finite differences of the quaternion coefficients
+    helpers::quat_t d1 = (s(t + eps) - s(t - eps)) / (2 * eps);
+    helpers::quat_t d2 = (s(t + eps) - 2 * s(t) + s(t - eps)) / (eps * eps);
+    if (!d1.isApprox(s.derivate(t, 1), 1e-5)) {
+      std::cout << errmsg << "first derivative is not correct at t = " << t << std::endl;
+      error = true;
+    }
+    if ((d2 - s.derivate(t, 2)).norm() > 1e-3) {
+      std::cout << errmsg << "second derivative is not correct at t = " << t << std::endl;
+      error = true;
+    }
+    // angular velocity from the quaternion derivative
+    Eigen::Quaterniond q(s(t)), dq(s.derivate(t, 1));
+    ComparePoints(2. * (dq * q.conjugate()).vec(), s.angular_velocity(t), errmsg + "angular velocity", error);
+  }
+  ComparePoints(Eigen::Vector3d::Zero(), s.angular_velocity(0.5), errmsg + "angular velocity outside bounds", error);
+  // the second derivative is not null at the bounds, and continuous inside them
+  ComparePoints(s.derivate(1. + 1e-9, 2), s.derivate(1., 2), errmsg + "second derivative at the lower bound", error,
+                1e-6);
+  ComparePoints(s.derivate(3. - 1e-9, 2), s.derivate(3., 2), errmsg + "second derivative at the upper bound", error,
+                1e-6);
+  if (s.derivate(1., 2).norm() < 1e-3) {
+    std::cout << errmsg << "second derivative at the lower bound should not be null" << std::endl;
+    error = true;
+  }
+  ComparePoints(helpers::quat_t::Zero(), s.derivate(0.5, 2), errmsg + "derivative outside bounds", error);
+  // batch evaluation
+  const Eigen::Index N = 11;
+  Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(N, 0.5, 3.5);
+  Eigen::MatrixXd quats(4, N);
+  s.evaluate(times, quats);
+  for (Eigen::Index i = 0; i < N; ++i) {
+    ComparePoints(s(times[i]), quats.col(i), errmsg + "batch evaluation", error);
+  }
+  try {
+    s.derivate(2., 0);
+    std::cout << errmsg << "derivate with order 0 should raise an invalid_argument error" << std::endl;
+    error = true;
+  } catch (std::invalid_argument&) {
+  }
+  // angular velocity of an effector trajectory
+  T_Waypoint waypoints;
+  waypoints.push_back(std::make_pair(0, point3_t(0, 0, 0)));
+  waypoints.push_back(std::make_pair(5, point3_t(1, 1, 1)));
+  waypoints.push_back(std::make_pair(10, point3_t(2, 2, 2)));
+  helpers::t_waypoint_quat_t quat_waypoints;
+  quat_waypoints.push_back(std::make_pair(3., q_from.coeffs()));
+  quat_waypoints.push_back(std::make_pair(7., q_to.coeffs()));
+  helpers::effector_spline_rotation eff_traj(waypoints.begin(), waypoints.end(), quat_waypoints.begin(),
+                                             quat_waypoints.end());
+  for (double t = 0.5; t < 9.5; t += 0.5) {
+    Eigen::Quaterniond q_plus(eff_traj.interpolate_quat(t + eps)), q_minus(eff_traj.interpolate_quat(t - eps));
+    Eigen::Quaterniond dq((q_plus.coeffs() - q_minus.coeffs()) / (2 * eps));
+    Eigen::Vector3d omega = 2. * (dq * Eigen::Quaterniond(eff_traj.interpolate_quat(t)).conjugate()).vec();
+    ComparePoints(omega, eff_traj.angular_velocity(t), errmsg + "effector angular velocity", error, 1e-5);
+  }
+}
+
 point3_t randomPoint(const double min, const double max) {
   point3_t p;
   for (size_t i = 0; i < 3; ++i) {
@@ -1906,6 +2058,145 @@ void se3CurveTest(bool& error) {
   }
 }
 
+void se3CurveEvaluationTest(bool& error) {
+  quaternion_t q0(1, 0, 0, 0);
+  quaternion_t q1(0., 1., 0, 0);
+  double min = 0.5, max = 2.;
+  std::vector<point3_t> params;
+  params.push_back(point3_t(1, 2, 3));
+  params.push_back(point3_t(2, 3, 4));
+  params.push_back(point3_t(3, 4, 5));
+  params.push_back(point3_t(3, 6, 7));
+  boost::shared_ptr<bezier_t> translation_bezier(new bezier_t(params.begin(), params.end(), min, max));
+  SE3Curve_t cBezier(translation_bezier, q0.toRotationMatrix(), q1.toRotationMatrix());
+  point3_t translation;
+  matrix3_t rotation;
+  quaternion_t quat;
+  for (double t = min; t <= max; t += 0.1) {
+    transform_t transform = cBezier(t);
+    cBezier.evaluate(t, translation, rotation);
+    ComparePoints(transform.translation(), translation, "SE3 evaluate: translation is not correct", error);
+    ComparePoints(transform.rotation(), rotation, "SE3 evaluate: rotation matrix is not correct", error);
+    cBezier.evaluate(t, translation, quat);
+    ComparePoints(transform.translation(), translation, "SE3 evaluate: translation is not correct", error);
+    ComparePoints(transform.rotation(), quat.toRotationMatrix(), "SE3 evaluate: quaternion is not correct", error);
+  }
+  // batch evaluation
+  const Eigen::Index N = 16;
+  Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(N, min, max);
+  Eigen::MatrixXd translations(3, N), rotations(4, N);
+  cBezier.evaluate(times, translations, rotations);
+  for (Eigen::Index i = 0; i < N; ++i) {
+    transform_t transform = cBezier(times[i]);
+    ComparePoints(transform.translation(), translations.col(i), "SE3 batch evaluate: translation is not correct",
+                  error);
+    quat.coeffs() = rotations.col(i);
+    ComparePoints(transform.rotation(), quat.toRotationMatrix(), "SE3 batch evaluate: rotation is not correct", error);
+  }
+  // rotation curve which is not a SO3Linear: quaternion are obtained from the rotation matrix
+  curve_rotation_ptr_t rotation_curve(new SO3Linear_t(q0, q1, min, max));
+  piecewise_curve<double, double, true, matrix3_t, point3_t, curve_rotation_t> rotation_piecewise(rotation_curve);
+  curve_rotation_ptr_t rotation_piecewise_ptr(
+      new piecewise_curve<double, double, true, matrix3_t, point3_t, curve_rotation_t>(rotation_piecewise));
+  SE3Curve_t cPiecewise(translation_bezier, rotation_piecewise_ptr);
+  cPiecewise.evaluate(times, translations, rotations);
+  for (Eigen::Index i = 0; i < N; ++i) {
+    quat.coeffs() = rotations.col(i);
+    ComparePoints(cBezier(times[i]).rotation(), quat.toRotationMatrix(),
+                  "SE3 batch evaluate with generic rotation curve: rotation is not correct", error);
+  }
+  try {
+    Eigen::MatrixXd wrong_size(3, N - 1);
+    cBezier.evaluate(times, wrong_size, rotations);
+    error = true;
+    std::cout << "SE3 batch evaluate: output of wrong size should raise an invalid_argument error" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  // a translation curve of dimension 2 is rejected at construction in safe mode, and by evaluate otherwise
+  t_pointX_t params2;
+  params2.push_back(Eigen::Vector2d(1, 2));
+  params2.push_back(Eigen::Vector2d(2, 3));
+  boost::shared_ptr<bezier_t> translation_2d(new bezier_t(params2.begin(), params2.end(), min, max));
+  try {
+    SE3Curve_t c2d(translation_2d, q0.toRotationMatrix(), q1.toRotationMatrix());
+    c2d.evaluate(min, translation, quat);
+    error = true;
+    std::cout << "SE3 evaluate: a translation curve of dimension 2 should raise an invalid_argument error" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+void se3CurveTypedTest(bool& error) {
+  std::string errmsg("SE3CurveTyped : ");
+  quaternion_t q0(1, 0, 0, 0);
+  quaternion_t q1(0., 1., 0, 0);
+  double min = 0.5, max = 2.;
+  std::vector<point3_t> params;
+  params.push_back(point3_t(1, 2, 3));
+  params.push_back(point3_t(2, 3, 4));
+  params.push_back(point3_t(3, 4, 5));
+  params.push_back(point3_t(3, 6, 7));
+  bezier3_t translation(params.begin(), params.end(), min, max);
+  SE3CurveBezier3_t cTyped(translation, q0, q1);
+  boost::shared_ptr<bezier_t> translation_bezier(new bezier_t(params.begin(), params.end(), min, max));
+  SE3Curve_t cBezier(translation_bezier, q0, q1);
+  if (cTyped.min() != min || cTyped.max() != max || cTyped.dim() != 6 || cTyped.degree() != 3) {
+    error = true;
+    std::cout << errmsg << "wrong time bounds, dimension or degree" << std::endl;
+  }
+  point3_t p;
+  quaternion_t quat;
+  for (double t = min; t <= max; t += 0.1) {
+    transform_t transform = cBezier(t);
+    ComparePoints(transform.matrix(), cTyped(t).matrix(), errmsg + "evaluation is not correct", error);
+    ComparePoints(transform.translation(), cTyped.translation(t), errmsg + "translation is not correct", error);
+    ComparePoints(transform.rotation(), cTyped.rotation(t), errmsg + "rotation is not correct", error);
+    cTyped.evaluate(t, p, quat);
+    ComparePoints(transform.translation(), p, errmsg + "evaluate: translation is not correct", error);
+    ComparePoints(transform.rotation(), quat.toRotationMatrix(), errmsg + "evaluate: rotation is not correct", error);
+    ComparePoints(cBezier.derivate(t, 1), cTyped.derivate(t, 1), errmsg + "derivate is not correct", error);
+  }
+  const Eigen::Index N = 16;
+  Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(N, min, max);
+  Eigen::MatrixXd translations(3, N), rotations(4, N);
+  cTyped.evaluate(times, translations, rotations);
+  for (Eigen::Index i = 0; i < N; ++i) {
+    ComparePoints(cBezier(times[i]).translation(), translations.col(i), errmsg + "batch translation is not correct",
+                  error);
+    quat.coeffs() = rotations.col(i);
+    ComparePoints(cBezier(times[i]).rotation(), quat.toRotationMatrix(), errmsg + "batch rotation is not correct",
+                  error);
+  }
+  // translation and rotation with different time bounds
+  try {
+    SE3CurveBezier3_t cWrong(translation, SO3Linear_t(q0, q1, min, max + 1.));
+    error = true;
+    std::cout << errmsg << "different time bounds should raise an invalid_argument error" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  // the typed curve can be used in a piecewise SE3 curve, along with generic SE3Curve
+  polynomial3_t translation_pol(point3_t(3, 6, 7), point3_t(0, 0, 1), max, max + 1.);
+  SE3CurvePolynomial3_t cTypedPol(translation_pol, q1, q0);
+  piecewise_SE3_t pc_se3(boost::make_shared<SE3CurveBezier3_t>(cTyped));
+  pc_se3.add_curve_ptr(boost::make_shared<SE3CurvePolynomial3_t>(cTypedPol));
+  ComparePoints(cTyped(min).matrix(), pc_se3(min).matrix(), errmsg + "piecewise evaluation is not correct", error);
+  ComparePoints(cTypedPol(max + 0.5).matrix(), pc_se3(max + 0.5).matrix(),
+                errmsg + "piecewise evaluation is not correct", error);
+  // serialization
+  std::string fileName("fileTest");
+  cTyped.saveAsText<SE3CurveBezier3_t>(fileName + ".txt");
+  SE3CurveBezier3_t typed_from_txt;
+  typed_from_txt.loadFromText<SE3CurveBezier3_t>(fileName + ".txt");
+  CompareCurves<SE3CurveBezier3_t, SE3CurveBezier3_t>(cTyped, typed_from_txt, errmsg + "text serialization", error);
+  pc_se3.saveAsBinary<piecewise_SE3_t>(fileName);
+  piecewise_SE3_t pc_from_binary;
+  pc_from_binary.loadFromBinary<piecewise_SE3_t>(fileName);
+  if (!pc_se3.isApprox(pc_from_binary)) {
+    error = true;
+    std::cout << errmsg << "binary serialization of piecewise curve failed" << std::endl;
+  }
+}
+
 void Se3serializationTest(bool& error) {
   std::string fileName("fileTest");
   std::string errmsg("SE3serializationTest : curve serialized is not equivalent to the original curve.");
@@ -2050,6 +2341,52 @@ void checkPair(const pair_size_t pair, const std::size_t start_index, const std:
   }
 }
 
+void linearVariableFusedOperationsTest(bool& error) {
+  std::string errmsg("linearVariableFusedOperationsTest: ");
+  typedef linear_variable<double, true> var_t;
+  var_t x(Eigen::MatrixXd::Random(3, 6), Eigen::VectorXd::Random(3));
+  var_t y(Eigen::MatrixXd::Random(3, 6), Eigen::VectorXd::Random(3));
+  var_t z(Eigen::MatrixXd::Random(3, 6), Eigen::VectorXd::Random(3));
+  Eigen::VectorXd val = Eigen::VectorXd::Random(6);
+  var_t res;
+  res.set_linear_combination(0.3, x, -2., y);
+  ComparePoints(0.3 * x(val) - 2. * y(val), res(val), errmsg + "set_linear_combination", error);
+  // in place, aliasing one of the operands
+  res.set_linear_combination(0.5, res, 1.5, z);
+  ComparePoints(0.5 * (0.3 * x(val) - 2. * y(val)) + 1.5 * z(val), res(val), errmsg + "aliased linear combination",
+                error);
+  res = x;
+  res.axpy(-0.7, y);
+  ComparePoints(x(val) - 0.7 * y(val), res(val), errmsg + "axpy", error);
+  var_t zero_var;
+  res = zero_var;
+  res.axpy(2., x);
+  ComparePoints(2. * x(val), res(val), errmsg + "axpy on zero variable", error);
+  ComparePoints(x(val) + y(val) - z(val) * 2., (x + y - z * 2.)(val), errmsg + "composite expression", error);
+  try {
+    res.set_linear_combination(1., x, 1., var_t(Eigen::MatrixXd::Random(3, 5), Eigen::VectorXd::Random(3)));
+    error = true;
+    std::cout << errmsg << "combination of variables of different sizes should raise a length_error" << std::endl;
+  } catch (std::length_error&) {
+  }
+  // bezier operations on linear variables against the fixed points evaluation
+  typedef bezier_curve<double, double, true, var_t> bezier_linear_t;
+  std::vector<var_t> wps;
+  for (int i = 0; i < 5; ++i) wps.push_back(var_t(Eigen::MatrixXd::Random(3, 6), Eigen::VectorXd::Random(3)));
+  bezier_linear_t b(wps.begin(), wps.end(), 0.5, 2.);
+  bezier_t b_fixed = evaluateLinear<bezier_t, bezier_linear_t>(b, val);
+  bezier_linear_t b_deriv = b.compute_derivate(2);
+  bezier_t b_deriv_fixed = evaluateLinear<bezier_t, bezier_linear_t>(b_deriv, val);
+  std::pair<bezier_linear_t, bezier_linear_t> split = b.split(1.2);
+  bezier_t first = evaluateLinear<bezier_t, bezier_linear_t>(split.first, val);
+  bezier_t second = evaluateLinear<bezier_t, bezier_linear_t>(split.second, val);
+  for (double t = 0.5; t <= 2.; t += 0.1) {
+    ComparePoints(b_fixed.derivate(t, 2), b_deriv_fixed(t) * b_deriv.mult_T_, errmsg + "compute_derivate", error);
+    ComparePoints(b_fixed(t), t < 1.2 ? first(t) : second(t), errmsg + "split", error);
+    ComparePoints(b_fixed(t), b.evalDeCasteljau(t)(val), errmsg + "evalDeCasteljau", error);
+  }
+}
+
 void BezierLinearProblemsetup_control_pointsNoConstraint(bool& error) {
   constraint_flag flag = optimization::NONE;
   var_pair_t res_no_constraints = setup_control_points(5, flag);
@@ -2340,6 +2677,1355 @@ void BezierLinearProblemsetupLoadProblem(bool& /*error*/) {
   // initInequalityMatrix<point_t,3,double>(pDef,pData,prob);
 }
 
+void BezierLinearProblemSparseTest(bool& error) {
+  problem_definition_t pDef = loadproblem(TEST_DATA_PATH "test.pb");
+  problem_data_t pData = setup_control_points<point3_t, double, true>(pDef);
+  // sparse and dense linear variables
+  typedef sparse_linear_variable<double, true> sparse_linear_variable_t;
+  typedef problem_data_t::sparse_bezier_t sparse_bezier_t;
+  sparse_bezier_t sparse_bezier = compute_sparse_linear_control_points<point3_t, double>(pData, pDef.totalTime);
+  for (std::size_t i = 0; i < pData.numControlPoints; ++i) {
+    const sparse_linear_variable_t& sparse_var = sparse_bezier.waypointAtIndex(i);
+    const linear_variable_t& dense_var = pData.bezier->waypointAtIndex(i);
+    if (!sparse_var.to_dense().isApprox(dense_var) || !sparse_var.isApprox(sparse_linear_variable_t(dense_var))) {
+      error = true;
+      std::cout << "BezierLinearProblemSparseTest: sparse control point " << i << " is not correct" << std::endl;
+    }
+    if (sparse_var.B().nonZeros() > (long)pData.dim_) {
+      error = true;
+      std::cout << "BezierLinearProblemSparseTest: too many non zeros in control point " << i << std::endl;
+    }
+  }
+  // inequality matrix against the dense computation
+  problem_t prob;
+  initInequalityMatrix<point3_t, double>(pDef, pData, prob);
+  problem_data_t pDataDense = setup_control_points<point3_t, double, true>(pDef);
+  std::vector<problem_data_t::bezier_t> beziers = split<point3_t, double>(pDef, pDataDense);
+  long row = 0;
+  for (std::size_t i = 0; i < beziers.size(); ++i) {
+    const Eigen::MatrixXd& A = pDef.inequalityMatrices_[i];
+    const Eigen::VectorXd& b = pDef.inequalityVectors_[i];
+    for (std::size_t j = 0; j < beziers[i].waypoints().size(); ++j) {
+      const linear_variable_t& var = beziers[i].waypoints()[j];
+      ComparePoints(A * var.B(), prob.ineqMatrix.block(row, 0, A.rows(), prob.ineqMatrix.cols()),
+                    "BezierLinearProblemSparseTest: inequality matrix is not correct", error);
+      ComparePoints(b - A * var.c(), prob.ineqVector.segment(row, A.rows()),
+                    "BezierLinearProblemSparseTest: inequality vector is not correct", error);
+      row += A.rows();
+    }
+  }
+  // integral cost against the dense computation
+  quadratic_variable<double> cost = compute_integral_cost<point3_t, double>(pData, ACCELERATION);
+  problem_data_t::bezier_t acc = pData.bezier->compute_derivate(2);
+  quadratic_variable<double> cost_dense = bezier_product<point3_t, double>(
+      acc.waypoints().begin(), acc.waypoints().end(), acc.waypoints().begin(), acc.waypoints().end(), pData.dim_);
+  ComparePoints(cost_dense.A(), cost.A(), "BezierLinearProblemSparseTest: cost A is not correct", error);
+  ComparePoints(cost_dense.b(), cost.b(), "BezierLinearProblemSparseTest: cost b is not correct", error);
+  if (!QuasiEqual(cost_dense.c(), cost.c())) {
+    error = true;
+    std::cout << "BezierLinearProblemSparseTest: cost c is not correct" << std::endl;
+  }
+}
+
+void BezierLinearProblemSplitTest(bool& error) {
+  // the split times of a problem with four phases are absolute times
+  problem_definition_t pDef(3);
+  pDef.degree = 5;
+  pDef.totalTime = 3.;
+  pDef.splitTimes_ = Eigen::Vector3d(0.5, 1.2, 2.);
+  problem_data_t pData = setup_control_points<point3_t, double, true>(pDef);
+  const problem_data_t::bezier_t bezier(*pData.bezier);
+  const std::vector<problem_data_t::bezier_t> beziers = split<point3_t, double>(pDef, pData);
+  const problem_data_t::sparse_bezier_t sparse_bezier =
+      compute_sparse_linear_control_points<point3_t, double>(pData, pDef.totalTime);
+  const std::vector<problem_data_t::sparse_bezier_t> sparse_beziers = split_bezier(pDef.splitTimes_, sparse_bezier);
+  const double bounds[] = {0., 0.5, 1.2, 2., 3.};
+  if (beziers.size() != 4 || sparse_beziers.size() != 4) {
+    error = true;
+    std::cout << "BezierLinearProblemSplitTest: wrong number of phases" << std::endl;
+    return;
+  }
+  for (std::size_t i = 0; i < 4; ++i) {
+    if (!QuasiEqual(beziers[i].min(), bounds[i]) || !QuasiEqual(beziers[i].max(), bounds[i + 1]) ||
+        !QuasiEqual(sparse_beziers[i].min(), bounds[i]) || !QuasiEqual(sparse_beziers[i].max(), bounds[i + 1])) {
+      error = true;
+      std::cout << "BezierLinearProblemSplitTest: wrong time range of the phase " << i << std::endl;
+    }
+    const double t = (bounds[i] + bounds[i + 1]) / 2.;
+    if (!beziers[i](t).isApprox(bezier(t)) || !sparse_beziers[i](t).to_dense().isApprox(bezier(t))) {
+      error = true;
+      std::cout << "BezierLinearProblemSplitTest: wrong curve of the phase " << i << std::endl;
+    }
+  }
+}
+
+// integral over [0, 1] of the product of two bezier curves, computed with the Simpson rule
+template <typename Bezier>
+double integrate_product(const Bezier& b1, const Bezier& b2, const std::size_t num_intervals = 200) {
+  const double h = 1. / (double)num_intervals;
+  double res = 0.;
+  for (std::size_t i = 0; i <= num_intervals; ++i) {
+    const double u = (double)i * h;
+    const double w = (i == 0 || i == num_intervals) ? 1. : (i % 2 ? 4. : 2.);
+    res += w * b1(b1.min() + u * (b1.max() - b1.min())).dot(b2(b2.min() + u * (b2.max() - b2.min())));
+  }
+  return res * h / 3.;
+}
+
+void BezierProductTest(bool& error) {
+  typedef problem_data_t::bezier_t bezier_linear_t;
+  // Gram matrix of the Bernstein polynomials
+  const Eigen::MatrixXd& G = bernstein_gram_matrix<double>(3, 2);
+  if (G.rows() != 4 || G.cols() != 3 || !QuasiEqual(G.sum(), 1.) || !QuasiEqual(G(0, 0), 1. / 6.) ||
+      &G != &bernstein_gram_matrix<double>(3, 2)) {
+    error = true;
+    std::cout << "BezierProductTest: Gram matrix is not correct" << std::endl;
+  }
+  problem_definition_t pDef = loadproblem(TEST_DATA_PATH "test.pb");
+  problem_data_t pData = setup_control_points<point3_t, double, true>(pDef);
+  const bezier_linear_t vel = pData.bezier->compute_derivate(1);
+  const bezier_linear_t acc = pData.bezier->compute_derivate(2);
+  const long numVariables = (long)(pData.numVariables * pData.dim_);
+  quadratic_variable<double> cost_acc = bezier_product<point3_t, double>(
+      acc.waypoints().begin(), acc.waypoints().end(), acc.waypoints().begin(), acc.waypoints().end(), pData.dim_);
+  quadratic_variable<double> cost_vel_acc = bezier_product<point3_t, double>(
+      vel.waypoints().begin(), vel.waypoints().end(), acc.waypoints().begin(), acc.waypoints().end(), pData.dim_);
+  ComparePoints(cost_acc.A(), cost_acc.A().transpose(), "BezierProductTest: cost matrix is not symmetric", error);
+  ComparePoints(cost_vel_acc.A(), cost_vel_acc.A().transpose(), "BezierProductTest: cost matrix is not symmetric",
+                error);
+  // the quadratic variables must give the exact value of the integral for any value of the variables
+  for (int i = 0; i < 5; ++i) {
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(numVariables);
+    const bezier_t vel_x = evaluateLinear<bezier_t, bezier_linear_t>(vel, x);
+    const bezier_t acc_x = evaluateLinear<bezier_t, bezier_linear_t>(acc, x);
+    const double expected_acc = integrate_product(acc_x, acc_x), expected_vel_acc = integrate_product(vel_x, acc_x);
+    if (std::fabs(cost_acc(x) - expected_acc) > 1e-6 * std::max(1., std::fabs(expected_acc))) {
+      error = true;
+      std::cout << "BezierProductTest: wrong value of the integral, expected " << expected_acc << " got "
+                << cost_acc(x) << std::endl;
+    }
+    if (std::fabs(cost_vel_acc(x) - expected_vel_acc) > 1e-6 * std::max(1., std::fabs(expected_vel_acc))) {
+      error = true;
+      std::cout << "BezierProductTest: wrong value of the integral, expected " << expected_vel_acc << " got "
+                << cost_vel_acc(x) << std::endl;
+    }
+  }
+}
+
+void IntegralCostCacheTest(bool& error) {
+  problem_definition_t pDef = loadproblem(TEST_DATA_PATH "test.pb");
+  problem_definition_t pDef2 = pDef;
+  pDef2.init_pos = point3_t(0.5, -1., 2.);
+  pDef2.end_pos = point3_t(3., 1., -0.5);
+  pDef2.totalTime = 2.5 * pDef.totalTime;
+  const integral_cost_flag flags[] = {DISTANCE, VELOCITY, ACCELERATION, JERK};
+  for (int i = 0; i < 4; ++i) {
+    // same structure, different boundary conditions and total time
+    problem_data_t pData = setup_control_points<point3_t, double, true>(pDef);
+    problem_data_t pData2 = setup_control_points<point3_t, double, true>(pDef2);
+    const integral_cost_structure<double>& structure = get_integral_cost_structure<point3_t, double>(pData, flags[i]);
+    if (&structure != &get_integral_cost_structure<point3_t, double>(pData2, flags[i])) {
+      error = true;
+      std::cout << "IntegralCostCacheTest: the structure of the cost should be shared" << std::endl;
+    }
+    const problem_data_t* datas[] = {&pData, &pData2};
+    for (int j = 0; j < 2; ++j) {
+      quadratic_variable<double> cost = compute_integral_cost<point3_t, double>(*datas[j], flags[i]);
+      problem_data_t::bezier_t deriv = datas[j]->bezier->compute_derivate(flags[i]);
+      quadratic_variable<double> expected = bezier_product<point3_t, double>(
+          deriv.waypoints().begin(), deriv.waypoints().end(), deriv.waypoints().begin(), deriv.waypoints().end(),
+          pData.dim_);
+      ComparePoints(expected.A(), cost.A(), "IntegralCostCacheTest: cost A is not correct", error);
+      ComparePoints(expected.b(), cost.b(), "IntegralCostCacheTest: cost b is not correct", error);
+      if (std::fabs(expected.c() - cost.c()) > 1e-8 * std::max(1., std::fabs(expected.c()))) {
+        error = true;
+        std::cout << "IntegralCostCacheTest: cost c is not correct" << std::endl;
+      }
+    }
+  }
+}
+
+void SparseQuadraticProblemTest(bool& error) {
+  typedef sparse_quadratic_problem<point3_t, double> sparse_problem_t;
+  problem_definition_t pDef = loadproblem(TEST_DATA_PATH "test.pb");
+  problem_t prob = generate_problem<point3_t, double, true>(pDef, ACCELERATION);
+  sparse_problem_t sparse_prob = generate_sparse_problem<point3_t, double, true>(pDef, ACCELERATION);
+  const Eigen::MatrixXd ineqMatrix(sparse_prob.ineqMatrix);
+  ComparePoints(prob.ineqMatrix, ineqMatrix, "SparseQuadraticProblemTest: inequality matrix is not correct", error);
+  ComparePoints(prob.ineqVector, sparse_prob.ineqVector, "SparseQuadraticProblemTest: inequality vector is not correct",
+                error);
+  ComparePoints(prob.cost.A(), sparse_prob.cost.A(), "SparseQuadraticProblemTest: cost is not correct", error);
+  ComparePoints(prob.cost.b(), sparse_prob.cost.b(), "SparseQuadraticProblemTest: cost is not correct", error);
+  long nonZeros = 0;
+  for (long i = 0; i < prob.ineqMatrix.rows(); ++i)
+    for (long j = 0; j < prob.ineqMatrix.cols(); ++j)
+      if (prob.ineqMatrix(i, j) != 0) ++nonZeros;
+  if (sparse_prob.ineqMatrix.nonZeros() != nonZeros) {
+    error = true;
+    std::cout << "SparseQuadraticProblemTest: only the non zero coefficients should be stored, expected " << nonZeros
+              << " got " << sparse_prob.ineqMatrix.nonZeros() << std::endl;
+  }
+  // without inequality constraints
+  pDef.inequalityMatrices_.clear();
+  pDef.inequalityVectors_.clear();
+  sparse_prob = generate_sparse_problem<point3_t, double, true>(pDef, sparse_prob.cost);
+  if (sparse_prob.ineqMatrix.rows() != 0 || sparse_prob.ineqMatrix.nonZeros() != 0) {
+    error = true;
+    std::cout << "SparseQuadraticProblemTest: the inequality matrix should be empty" << std::endl;
+  }
+}
+
+void QPSolverTest(bool& error) {
+  typedef qp_solver<double> dense_solver_t;
+  typedef Eigen::SparseMatrix<double> sparse_matrix_t;
+  const double inf = std::numeric_limits<double>::infinity();
+  // equality constrained problem, compared to the solution of the KKT system
+  const long n = 6, m = 2;
+  Eigen::MatrixXd M = Eigen::MatrixXd::Random(n, n);
+  const Eigen::MatrixXd A = M.transpose() * M + Eigen::MatrixXd::Identity(n, n);
+  const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+  const Eigen::MatrixXd C = Eigen::MatrixXd::Random(m, n);
+  const Eigen::VectorXd d = Eigen::VectorXd::Random(m);
+  Eigen::MatrixXd KKT(Eigen::MatrixXd::Zero(n + m, n + m));
+  KKT.topLeftCorner(n, n) = 2. * A;
+  KKT.topRightCorner(n, m) = C.transpose();
+  KKT.bottomLeftCorner(m, n) = C;
+  Eigen::VectorXd rhs(n + m);
+  rhs << -b, d;
+  const Eigen::VectorXd expected = KKT.fullPivLu().solve(rhs).head(n);
+  dense_solver_t solver;
+  solver.setup(A, b, C, d, d);
+  qp_result<double> res = solver.solve();
+  if (res.status != QP_SOLVED || !res.x.isApprox(expected, 1e-5)) {
+    error = true;
+    std::cout << "QPSolverTest: wrong solution of the equality constrained problem" << std::endl;
+  }
+  qp_solver<double, sparse_matrix_t> sparse_solver;
+  sparse_solver.setup(A.sparseView(), b, C.sparseView(), d, d);
+  res = sparse_solver.solve();
+  if (res.status != QP_SOLVED || !res.x.isApprox(expected, 1e-5)) {
+    error = true;
+    std::cout << "QPSolverTest: wrong solution of the sparse equality constrained problem" << std::endl;
+  }
+  // projection on a box : min ||x - p||^2 subject to x <= 1
+  const Eigen::VectorXd p = 2. * Eigen::VectorXd::Random(n);
+  solver.setup(Eigen::MatrixXd::Identity(n, n), -2. * p, Eigen::MatrixXd::Identity(n, n),
+               Eigen::VectorXd::Constant(n, -inf), Eigen::VectorXd::Ones(n));
+  res = solver.solve();
+  if (res.status != QP_SOLVED || !res.x.isApprox(p.cwiseMin(1.), 1e-5)) {
+    error = true;
+    std::cout << "QPSolverTest: wrong solution of the box constrained problem" << std::endl;
+  }
+  // infeasible problem : x_0 <= -1 and x_0 >= 1
+  Eigen::MatrixXd C_infeasible(Eigen::MatrixXd::Zero(2, n));
+  C_infeasible(0, 0) = 1.;
+  C_infeasible(1, 0) = -1.;
+  solver.setup(A, b, C_infeasible, Eigen::VectorXd::Constant(2, -inf), -Eigen::VectorXd::Ones(2));
+  if (solver.solve().status != QP_PRIMAL_INFEASIBLE) {
+    error = true;
+    std::cout << "QPSolverTest: the problem should be infeasible" << std::endl;
+  }
+  // problems generated from a problem definition, dense and sparse
+  problem_definition_t pDef = loadproblem(TEST_DATA_PATH "test.pb");
+  problem_t prob = generate_problem<point3_t, double, true>(pDef, ACCELERATION);
+  sparse_quadratic_problem<point3_t, double> sparse_prob =
+      generate_sparse_problem<point3_t, double, true>(pDef, ACCELERATION);
+  const qp_result<double> res_dense = solve(prob), res_sparse = solve(sparse_prob);
+  if (res_dense.status != QP_SOLVED || res_sparse.status != QP_SOLVED) {
+    error = true;
+    std::cout << "QPSolverTest: the generated problem should be solved" << std::endl;
+  }
+  if (!res_dense.x.isApprox(res_sparse.x, 1e-4)) {
+    error = true;
+    std::cout << "QPSolverTest: dense and sparse solutions differ" << std::endl;
+  }
+  if ((prob.ineqMatrix * res_dense.x - prob.ineqVector).maxCoeff() > 1e-5) {
+    error = true;
+    std::cout << "QPSolverTest: the solution does not satisfy the constraints" << std::endl;
+  }
+  if (std::fabs(prob.cost(res_dense.x) - res_dense.cost) > 1e-6 * std::max(1., std::fabs(res_dense.cost))) {
+    error = true;
+    std::cout << "QPSolverTest: wrong cost of the solution" << std::endl;
+  }
+  // warm start from the solution of a slightly different problem
+  pDef.end_pos += point3_t(0.01, -0.01, 0.01);
+  prob = generate_problem<point3_t, double, true>(pDef, ACCELERATION);
+  const qp_result<double> res_cold = solve(prob);
+  const qp_settings<double> settings;
+  const qp_result<double> res_warm = solve(prob, settings, &res_dense);
+  if (res_warm.status != QP_SOLVED || !res_warm.x.isApprox(res_cold.x, 1e-4) ||
+      res_warm.iterations > res_cold.iterations) {
+    error = true;
+    std::cout << "QPSolverTest: warm start should not need more iterations, cold " << res_cold.iterations
+              << " warm " << res_warm.iterations << std::endl;
+  }
+  // end to end, from the problem definition to the curve
+  const bezier_curve<double, double, true, point3_t> curve = solve_problem<point3_t, double, true>(pDef, ACCELERATION);
+  problem_data_t pData = setup_control_points<point3_t, double, true>(pDef);
+  bool same_waypoints = curve.waypoints().size() == pData.numControlPoints;
+  for (std::size_t k = 0; same_waypoints && k < pData.numControlPoints; ++k)
+    same_waypoints = curve.waypoints()[k].isApprox(pData.bezier->waypointAtIndex(k)(res_cold.x), 1e-4);
+  if (!curve(0.).isApprox(pDef.init_pos, 1e-6) || std::fabs(curve.max() - pDef.totalTime) > 1e-9 ||
+      !same_waypoints) {
+    error = true;
+    std::cout << "QPSolverTest: the optimal curve is not correct" << std::endl;
+  }
+}
+
+void QPSolverBenchmark(bool& error) {
+  // time to solve problems of increasing degree and number of phases, each phase being constrained in a box
+  const std::size_t degrees[] = {5, 7, 9};
+  const std::size_t phases[] = {1, 5, 20};
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      problem_definition_t pDef(3);
+      pDef.flag = constraint_flag(INIT_POS | INIT_VEL | END_POS | END_VEL);
+      pDef.init_pos = point3_t(0., 0., 0.);
+      pDef.end_pos = point3_t(1., 1.5, 0.5);
+      pDef.degree = degrees[i];
+      pDef.totalTime = 2.;
+      pDef.splitTimes_ = Eigen::VectorXd::LinSpaced(phases[j] + 1, 0., pDef.totalTime).segment(1, phases[j] - 1);
+      Eigen::MatrixXd box(6, 3);
+      box << Eigen::Matrix3d::Identity(), -Eigen::Matrix3d::Identity();
+      for (std::size_t k = 0; k < phases[j]; ++k) {
+        pDef.inequalityMatrices_.push_back(box);
+        pDef.inequalityVectors_.push_back(Eigen::VectorXd::Constant(6, 2.));
+      }
+      const problem_t prob = generate_problem<point3_t, double, true>(pDef, ACCELERATION);
+      const sparse_quadratic_problem<point3_t, double> sparse_prob =
+          generate_sparse_problem<point3_t, double, true>(pDef, ACCELERATION);
+      clock_t s0, e0, s1, e1;
+      s0 = clock();
+      const qp_result<double> res_dense = solve(prob);
+      e0 = clock();
+      s1 = clock();
+      const qp_result<double> res_sparse = solve(sparse_prob);
+      e1 = clock();
+      if (res_dense.status != QP_SOLVED || res_sparse.status != QP_SOLVED) {
+        error = true;
+        std::cout << "QPSolverBenchmark: problem not solved for degree " << degrees[i] << " and " << phases[j]
+                  << " phases" << std::endl;
+      }
+      std::cout << "time to solve qp, degree " << degrees[i] << ", " << prob.ineqMatrix.rows()
+                << " constraints : dense " << double(e0 - s0) / CLOCKS_PER_SEC << " (" << res_dense.iterations
+                << " it), sparse " << double(e1 - s1) / CLOCKS_PER_SEC << " (" << res_sparse.iterations << " it)"
+                << std::endl;
+    }
+  }
+}
+
+void RecedingHorizonProblemTest(bool& error) {
+  problem_definition_t pDef(3);
+  pDef.flag = constraint_flag(INIT_POS | INIT_VEL | END_POS);
+  pDef.init_pos = point3_t(0., 0., 0.);
+  pDef.init_vel = point3_t(0.5, 0., 0.);
+  pDef.end_pos = point3_t(1., 1.5, 0.5);
+  pDef.degree = 7;
+  pDef.totalTime = 2.;
+  pDef.splitTimes_ = Eigen::Vector2d(0.7, 1.4);
+  Eigen::MatrixXd box(6, 3);
+  box << Eigen::Matrix3d::Identity(), -Eigen::Matrix3d::Identity();
+  for (std::size_t k = 0; k < 3; ++k) {
+    pDef.inequalityMatrices_.push_back(box);
+    pDef.inequalityVectors_.push_back(Eigen::VectorXd::Constant(6, 1.6));
+  }
+  receding_horizon_problem<point3_t> rhp(pDef, ACCELERATION);
+  for (int i = 0; i < 5; ++i) {
+    // shift the start state, as in a receding horizon loop
+    pDef.init_pos += point3_t(0.05, 0.02, 0.);
+    pDef.init_vel += point3_t(0., 0.1, 0.);
+    rhp.set_init_pos(pDef.init_pos);
+    rhp.set_init_vel(pDef.init_vel);
+    if (i == 3) {
+      pDef.inequalityVectors_[1] = Eigen::VectorXd::Constant(6, 1.5);
+      rhp.set_inequality_vector(1, pDef.inequalityVectors_[1]);
+    }
+    const sparse_quadratic_problem<point3_t, double> expected =
+        generate_sparse_problem<point3_t, double, true>(pDef, ACCELERATION);
+    const sparse_quadratic_problem<point3_t, double>& prob = rhp.problem();
+    ComparePoints(expected.ineqVector, prob.ineqVector, "RecedingHorizonProblemTest: wrong inequality vector", error);
+    ComparePoints(expected.cost.b(), prob.cost.b(), "RecedingHorizonProblemTest: wrong cost", error);
+    if (!QuasiEqual(expected.cost.c(), prob.cost.c())) {
+      error = true;
+      std::cout << "RecedingHorizonProblemTest: wrong constant cost" << std::endl;
+    }
+    const qp_result<double> res_cold = solve(expected);
+    const qp_result<double>& res = rhp.solve();
+    if (res.status != QP_SOLVED || !res.x.isApprox(res_cold.x, 1e-4) || res.iterations > res_cold.iterations) {
+      error = true;
+      std::cout << "RecedingHorizonProblemTest: wrong solution, or more iterations than without warm start ("
+                << res.iterations << " / " << res_cold.iterations << ")" << std::endl;
+    }
+    if (!rhp.curve()(0.).isApprox(pDef.init_pos, 1e-6) || !rhp.curve()(pDef.totalTime).isApprox(pDef.end_pos, 1e-6)) {
+      error = true;
+      std::cout << "RecedingHorizonProblemTest: the curve does not satisfy the boundary conditions" << std::endl;
+    }
+  }
+  try {
+    rhp.set_inequality_vector(3, Eigen::VectorXd::Zero(6));
+    error = true;
+    std::cout << "RecedingHorizonProblemTest: an exception should be raised for a wrong phase" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+void BatchGenerateProblemsTest(bool& error) {
+  problem_definition_t pDef(3);
+  pDef.flag = constraint_flag(INIT_POS | INIT_VEL | END_POS);
+  pDef.init_pos = point3_t(0., 0., 0.);
+  pDef.init_vel = point3_t(0.5, 0., 0.);
+  pDef.end_pos = point3_t(1., 1.5, 0.5);
+  pDef.degree = 6;
+  pDef.totalTime = 2.;
+  for (int k = 0; k < 3; ++k) {
+    pDef.inequalityMatrices_.push_back(Eigen::MatrixXd::Random(4, 3));
+    pDef.inequalityVectors_.push_back(Eigen::VectorXd::Random(4));
+  }
+  // candidate timings of the phases
+  std::vector<Eigen::VectorXd> splitTimes;
+  std::vector<problem_definition_t> pDefs;
+  for (int i = 0; i < 40; ++i) {
+    const double t0 = 0.1 + 0.8 * (double)(i) / 40., t1 = t0 + 0.2 + 0.02 * i;
+    splitTimes.push_back(Eigen::Vector2d(t0, t1));
+    pDefs.push_back(pDef);
+    pDefs.back().splitTimes_ = splitTimes.back();
+    pDefs.back().init_pos = point3_t::Random();
+  }
+  std::vector<problem_t> problems;
+  std::vector<sparse_quadratic_problem<point3_t, double> > sparse_problems, problems_definitions;
+  generate_problems<point3_t, double, true>(pDef, splitTimes, ACCELERATION, problems, 4);
+  generate_problems<point3_t, double, true>(pDef, splitTimes, ACCELERATION, sparse_problems, 3);
+  generate_problems<point3_t, double, true>(pDefs, ACCELERATION, problems_definitions, 4);
+  if (problems.size() != splitTimes.size() || sparse_problems.size() != splitTimes.size() ||
+      problems_definitions.size() != pDefs.size()) {
+    error = true;
+    std::cout << "BatchGenerateProblemsTest: wrong number of problems" << std::endl;
+    return;
+  }
+  for (std::size_t i = 0; i < splitTimes.size(); ++i) {
+    problem_definition_t pDef_i(pDef);
+    pDef_i.splitTimes_ = splitTimes[i];
+    const problem_t expected = generate_problem<point3_t, double, true>(pDef_i, ACCELERATION);
+    const problem_t expected_def = generate_problem<point3_t, double, true>(pDefs[i], ACCELERATION);
+    ComparePoints(expected.ineqMatrix, problems[i].ineqMatrix, "BatchGenerateProblemsTest: wrong inequality matrix",
+                  error);
+    ComparePoints(expected.ineqVector, problems[i].ineqVector, "BatchGenerateProblemsTest: wrong inequality vector",
+                  error);
+    ComparePoints(expected.cost.A(), problems[i].cost.A(), "BatchGenerateProblemsTest: wrong cost", error);
+    ComparePoints(expected.ineqMatrix, Eigen::MatrixXd(sparse_problems[i].ineqMatrix),
+                  "BatchGenerateProblemsTest: wrong sparse inequality matrix", error);
+    ComparePoints(expected.ineqVector, sparse_problems[i].ineqVector,
+                  "BatchGenerateProblemsTest: wrong sparse inequality vector", error);
+    ComparePoints(expected_def.ineqMatrix, Eigen::MatrixXd(problems_definitions[i].ineqMatrix),
+                  "BatchGenerateProblemsTest: wrong inequality matrix", error);
+    ComparePoints(expected_def.ineqVector, problems_definitions[i].ineqVector,
+                  "BatchGenerateProblemsTest: wrong inequality vector", error);
+    ComparePoints(expected_def.cost.b(), problems_definitions[i].cost.b(), "BatchGenerateProblemsTest: wrong cost",
+                  error);
+  }
+}
+
+void ProblemDerivativesTest(bool& error) {
+  const constraint_flag flags[] = {constraint_flag(INIT_POS | INIT_VEL | END_POS), ALL,
+                                   constraint_flag(INIT_POS | INIT_VEL | INIT_ACC | END_POS | END_VEL | END_ACC)};
+  const std::size_t degrees[] = {5, 9, 8};
+  for (int f = 0; f < 3; ++f) {
+    problem_definition_t pDef(3);
+    pDef.flag = flags[f];
+    pDef.init_pos = point3_t(0., 0., 0.);
+    pDef.init_vel = point3_t(0.5, 0.2, -0.1);
+    pDef.init_acc = point3_t(0.1, -0.3, 0.2);
+    pDef.init_jerk = point3_t(0.4, 0.1, 0.3);
+    pDef.end_pos = point3_t(1., 1.5, 0.5);
+    pDef.end_vel = point3_t(-0.2, 0.3, 0.1);
+    pDef.end_acc = point3_t(0.2, 0.1, -0.4);
+    pDef.end_jerk = point3_t(-0.1, 0.2, 0.5);
+    pDef.degree = degrees[f];
+    pDef.totalTime = 1.7;
+    pDef.splitTimes_ = Eigen::Vector2d(0.4, 1.1);
+    for (int k = 0; k < 3; ++k) {
+      pDef.inequalityMatrices_.push_back(Eigen::MatrixXd::Random(4, 3));
+      pDef.inequalityVectors_.push_back(Eigen::VectorXd::Random(4));
+    }
+    std::vector<problem_t> derivatives;
+    compute_problem_derivatives<point3_t, double, true>(pDef, JERK, derivatives);
+    if (derivatives.size() != 3) {
+      error = true;
+      std::cout << "ProblemDerivativesTest: wrong number of derivatives" << std::endl;
+      continue;
+    }
+    // central finite differences
+    const double h = 1e-6;
+    for (int i = 0; i < 3; ++i) {
+      problem_definition_t pDef_plus(pDef), pDef_minus(pDef);
+      if (i < 2) {
+        pDef_plus.splitTimes_[i] += h;
+        pDef_minus.splitTimes_[i] -= h;
+      } else {
+        pDef_plus.totalTime += h;
+        pDef_minus.totalTime -= h;
+      }
+      const problem_t plus = generate_problem<point3_t, double, true>(pDef_plus, JERK);
+      const problem_t minus = generate_problem<point3_t, double, true>(pDef_minus, JERK);
+      const Eigen::MatrixXd dM = (plus.ineqMatrix - minus.ineqMatrix) / (2 * h);
+      const Eigen::VectorXd dv = (plus.ineqVector - minus.ineqVector) / (2 * h);
+      const Eigen::VectorXd db = (plus.cost.b() - minus.cost.b()) / (2 * h);
+      const double dc = (plus.cost.c() - minus.cost.c()) / (2 * h);
+      if ((dM - derivatives[i].ineqMatrix).norm() > 1e-5 * std::max(1., dM.norm()) ||
+          (dv - derivatives[i].ineqVector).norm() > 1e-5 * std::max(1., dv.norm())) {
+        error = true;
+        std::cout << "ProblemDerivativesTest: wrong derivative of the inequalities for parameter " << i << " and flag "
+                  << pDef.flag << std::endl;
+      }
+      if ((db - derivatives[i].cost.b()).norm() > 1e-5 * std::max(1., db.norm()) ||
+          std::fabs(dc - derivatives[i].cost.c()) > 1e-5 * std::max(1., std::fabs(dc)) ||
+          derivatives[i].cost.A().norm() > 0.) {
+        error = true;
+        std::cout << "ProblemDerivativesTest: wrong derivative of the cost for parameter " << i << " and flag "
+                  << pDef.flag << std::endl;
+      }
+    }
+  }
+}
+
+void SplineOptimizerTest(bool& error) {
+  typedef SplineOptimizer<double, double, 3, true, pointX_t> spline_optimizer_t;
+  T_Waypoint waypoints;
+  waypoints.push_back(std::make_pair(0., point3_t(0., 0., 0.)));
+  waypoints.push_back(std::make_pair(0.5, point3_t(3., 1., 0.)));
+  waypoints.push_back(std::make_pair(1.2, point3_t(1., 4., 2.)));
+  waypoints.push_back(std::make_pair(2., point3_t(2., 2., 1.)));
+  spline_optimizer_t optimizer;
+  spline_optimizer_t::exact_cubic_t* curve = optimizer.GenerateOptimizedCurve(waypoints.begin(), waypoints.end());
+  if (!curve) {
+    error = true;
+    std::cout << "SplineOptimizerTest: the problem was not solved" << std::endl;
+    return;
+  }
+  ComparePoints(waypoints.front().second, (*curve)(0.), "SplineOptimizerTest: wrong initial position", error, 1e-5);
+  ComparePoints(waypoints.back().second, (*curve)(2.), "SplineOptimizerTest: wrong final position", error, 1e-5);
+  // the problem is linear in the end points and the same for each dimension :
+  // the optimized waypoints are on the segment between the end points
+  const pointX_t dir = waypoints.back().second.normalized();
+  for (std::size_t i = 1; i + 1 < waypoints.size(); ++i) {
+    const pointX_t p = (*curve)(waypoints[i].first);
+    if ((p - p.dot(dir) * dir).norm() > 1e-5) {
+      error = true;
+      std::cout << "SplineOptimizerTest: the optimized waypoint " << i << " is not on the segment" << std::endl;
+    }
+  }
+  delete curve;
+  // the solver can be configured through the constructor
+  qp_settings<double> settings;
+  settings.max_iter = 1;
+  spline_optimizer_t limited(settings);
+  if (limited.GenerateOptimizedCurve(waypoints.begin(), waypoints.end()) != 0 ||
+      limited.solver().result().status != QP_MAX_ITER_REACHED) {
+    error = true;
+    std::cout << "SplineOptimizerTest: a null curve should be returned when the solver fails" << std::endl;
+  }
+}
+
+void BoundingBoxTest(bool& error) {
+  // (u - 1/4)(u - 3/4) in the Bernstein basis
+  std::vector<double> coeffs, roots;
+  coeffs.push_back(3. / 16.);
+  coeffs.push_back(-5. / 16.);
+  coeffs.push_back(3. / 16.);
+  bernstein_roots(coeffs, 1e-12, roots);
+  if (roots.size() != 2 || std::fabs(roots[0] - 0.25) > 1e-10 || std::fabs(roots[1] - 0.75) > 1e-10) {
+    error = true;
+    std::cout << "BoundingBoxTest: wrong roots of the bernstein polynomial" << std::endl;
+  }
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  const bezier_t bc(params.begin(), params.end(), 0.5, 2.);
+  bounding_box<double> sampled;
+  for (int i = 0; i <= 10000; ++i) sampled.extend(bc(0.5 + 1.5 * i / 10000.));
+  const bounding_box<double>& hull = bc.bounds();
+  const bounding_box<double> tight = bc.tight_bounds();
+  if (!hull.contains(tight) || !tight.contains(sampled, 1e-12) || !tight.isApprox(sampled, 1e-6)) {
+    error = true;
+    std::cout << "BoundingBoxTest: wrong bounds of the bezier curve " << tight.min_.transpose() << " / "
+              << tight.max_.transpose() << " ; " << sampled.min_.transpose() << " / " << sampled.max_.transpose()
+              << std::endl;
+  }
+  if (&bc.bounds() != &hull || !bezier_t(bc).bounds().isApprox(hull)) {
+    error = true;
+    std::cout << "BoundingBoxTest: the bounds of the control points should be cached" << std::endl;
+  }
+
+  // hierarchy over the segments of a piecewise curve
+  piecewise_t pc;
+  for (int k = 0; k < 5; ++k) {
+    t_pointX_t wps;
+    for (std::size_t i = 0; i < params.size(); ++i) wps.push_back(params[i] + point3_t(2. * k, 0.5 * k, 0.));
+    if (k > 0) wps.front() = pc(pc.max());
+    pc.add_curve(bezier_t(wps.begin(), wps.end(), (double)k, k + 1.));
+  }
+  const bounding_volume_hierarchy<bezier_t> bvh(pc);
+  bounding_box<double> pc_sampled;
+  for (int i = 0; i <= 50000; ++i) pc_sampled.extend(pc(5. * i / 50000.));
+  if (!bvh.bounds().contains(pc_sampled) || bvh.nodes().size() != 9) {
+    error = true;
+    std::cout << "BoundingBoxTest: wrong bounds of the piecewise curve" << std::endl;
+  }
+  bounding_box<double> box(pc_sampled);
+  box.min_ -= point3_t::Constant(1e-6);
+  box.max_ += point3_t::Constant(1e-6);
+  if (!bvh.is_inside(box)) {
+    error = true;
+    std::cout << "BoundingBoxTest: the curve should be inside the box" << std::endl;
+  }
+  box.max_[1] = pc_sampled.max_[1] - 1e-3;
+  if (bvh.is_inside(box)) {
+    error = true;
+    std::cout << "BoundingBoxTest: the curve should leave the box" << std::endl;
+  }
+  std::vector<std::size_t> segments;
+  const pointX_t pt = pc(3.3) + point3_t(0.1, 0., 0.);
+  bvh.segments_near(pt, 0.2, segments);
+  if (std::find(segments.begin(), segments.end(), 3) == segments.end() || segments.size() == 5) {
+    error = true;
+    std::cout << "BoundingBoxTest: wrong segments near the point" << std::endl;
+  }
+  bvh.segments_intersecting(bounding_box<double>(point3_t::Constant(-100.), point3_t::Constant(100.)), segments);
+  if (segments.size() != 5) {
+    error = true;
+    std::cout << "BoundingBoxTest: all the segments should intersect the box" << std::endl;
+  }
+  piecewise_t pc_polynomial;
+  pc_polynomial.add_curve(polynomial_t(params.begin(), params.end(), 0., 1.));
+  try {
+    bounding_volume_hierarchy<bezier_t> bvh_polynomial(pc_polynomial);
+    error = true;
+    std::cout << "BoundingBoxTest: an exception should be raised for segments that are not bezier curves"
+              << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+void ClosestPointTest(bool& error) {
+  t_point3_t params = ControlPolygon<t_point3_t>(5);
+  piecewise3_t pc;
+  for (int k = 0; k < 6; ++k) {
+    t_point3_t wps;
+    for (std::size_t i = 0; i < params.size(); ++i) wps.push_back(params[i] + point3_t(1.5 * k, 0.5 * k, 0.));
+    if (k > 0) wps.front() = pc(pc.max());
+    pc.add_curve(bezier3_t(wps.begin(), wps.end(), (double)k, k + 1.));
+  }
+  const closest_point_query<bezier3_t> query(pc);
+  closest_point_query<bezier3_t>::result_t res;
+  const int num_samples = 60000;
+  srand(0);
+  for (int i = 0; i < 20; ++i) {
+    const point3_t pt = point3_t::Random() * 4. + point3_t(4., 1., 0.);
+    double brute = std::numeric_limits<double>::infinity();
+    for (int j = 0; j <= num_samples; ++j) brute = std::min(brute, (pc(6. * j / num_samples) - pt).norm());
+    query.closest_point(pt, res);
+    if (res.distance > brute + 1e-9 || brute - res.distance > 1e-3 || (pc(res.time) - res.point).norm() > 1e-12 ||
+        std::fabs((res.point - pt).norm() - res.distance) > 1e-12) {
+      error = true;
+      std::cout << "ClosestPointTest: wrong closest point " << res.distance << " ; " << brute << std::endl;
+    }
+  }
+  // tracking a point moving along the curve, starting from the previous result
+  double previous = 0.;
+  for (int i = 1; i <= 60; ++i) {
+    const double t = 0.1 * i - 0.05;
+    const point3_t pt = pc(t) + 0.01 * point3_t(pc.derivate(t, 1)).cross(point3_t::UnitZ()).normalized();
+    query.closest_point(pt, previous, res);
+    if (std::fabs(res.time - t) > 1e-3 || std::fabs(res.distance - 0.01) > 1e-4) {
+      error = true;
+      std::cout << "ClosestPointTest: wrong tracked point at time " << t << " : " << res.time << std::endl;
+    }
+    previous = res.time;
+  }
+  const bezier3_t bc(params.begin(), params.end(), 0., 2.);
+  const closest_point_query<bezier3_t> single(bc);
+  if (std::fabs(single.distance(bc(1.3) + point3_t(0., 0., 1e-3)) - 1e-3) > 1e-3 ||
+      !QuasiEqual(single.distance(point3_t(0., 0., -1.)), 1.)) {
+    error = true;
+    std::cout << "ClosestPointTest: wrong distance to the bezier curve" << std::endl;
+  }
+}
+
+void ArcLengthTest(bool& error) {
+  // straight line with a varying speed : the arc length is the distance to the first point
+  t_pointX_t line;
+  line.push_back(point3_t(0., 0., 0.));
+  line.push_back(point3_t(0.5, 1., 0.));
+  line.push_back(point3_t(2., 4., 0.));
+  line.push_back(point3_t(2.5, 5., 0.));
+  const bezier_t bc_line(line.begin(), line.end(), 1., 3.);
+  const arc_length_table<> table_line(bc_line);
+  if (std::fabs(table_line.length() - std::sqrt(31.25)) > 1e-8) {
+    error = true;
+    std::cout << "ArcLengthTest: wrong length of the line " << table_line.length() << std::endl;
+  }
+  for (int i = 0; i <= 100; ++i) {
+    const double t = 1. + 2. * i / 100.;
+    const double s = (bc_line(t) - bc_line(1.)).norm();
+    if (std::fabs(table_line.s_of_t(t) - s) > 1e-7 ||
+        std::fabs(bc_line(table_line.t_of_s(s))[0] - bc_line(t)[0]) > 1e-7) {
+      error = true;
+      std::cout << "ArcLengthTest: wrong arc length at time " << t << " : " << table_line.s_of_t(t) << " ; " << s
+                << std::endl;
+    }
+  }
+  // arbitrary curve, compared to a dense sampling
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  const bezier_t bc(params.begin(), params.end(), 0., 2.);
+  const arc_length_table<> table(bc);
+  const int num_samples = 200000;
+  double s = 0.;
+  for (int i = 0; i < num_samples; ++i) {
+    s += (bc(2. * (i + 1) / num_samples) - bc(2. * i / num_samples)).norm();
+    if (i % 20000 == 19999 && std::fabs(table.s_of_t(2. * (i + 1) / num_samples) - s) > 1e-6) {
+      error = true;
+      std::cout << "ArcLengthTest: wrong arc length " << table.s_of_t(2. * (i + 1) / num_samples) << " ; " << s
+                << std::endl;
+    }
+  }
+  const Eigen::VectorXd times = table.equidistant_times(11);
+  Eigen::VectorXd lengths;
+  table.s_of_t(times, lengths);
+  if (!lengths.isApprox(Eigen::VectorXd::LinSpaced(11, 0., table.length()), 1e-10) || std::fabs(times[0]) > 1e-12 ||
+      std::fabs(times[10] - 2.) > 1e-12) {
+    error = true;
+    std::cout << "ArcLengthTest: wrong equidistant times " << times.transpose() << " ; " << lengths.transpose()
+              << std::endl;
+  }
+  // the table also applies to the other curves
+  const polynomial_t pol(params.begin(), params.end(), 0., 1.);
+  const arc_length_table<> table_pol(pol);
+  if (std::fabs(table_pol.t_of_s(table_pol.s_of_t(0.37)) - 0.37) > 1e-10) {
+    error = true;
+    std::cout << "ArcLengthTest: wrong inverse of the arc length of the polynomial" << std::endl;
+  }
+}
+
+void TimeOptimalRetimingTest(bool& error) {
+  typedef time_optimal_retiming<bezier_t> retiming_t;
+  // straight line uniformly parametrized, from rest to rest : bang-coast-bang profile of duration L / v + v / a
+  t_pointX_t line;
+  for (int i = 0; i < 4; ++i) line.push_back(point3_t(4. * i / 3., 0., 0.));
+  const bezier_t bc_line(line.begin(), line.end(), 0., 1.);
+  const retiming_t retiming_line(bc_line, point3_t(1., 1., 1.), point3_t(1., 1., 1.));
+  if (std::fabs(retiming_line.duration() - 5.) > 0.05) {
+    error = true;
+    std::cout << "TimeOptimalRetimingTest: wrong duration of the line " << retiming_line.duration() << std::endl;
+  }
+  // arbitrary path with different limits on each axis
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  const bezier_t bc(params.begin(), params.end(), 0., 2.);
+  const point3_t max_vel(1., 2., 0.5), max_acc(2., 1., 3.);
+  const retiming_t retiming(bc, max_vel, max_acc);
+  const retiming_t::piecewise_curve_t trajectory = retiming.compute_curve();
+  ComparePoints(bc(0.), trajectory(0.), "TimeOptimalRetimingTest: wrong initial point", error);
+  ComparePoints(bc(2.), trajectory(trajectory.max()), "TimeOptimalRetimingTest: wrong final point", error);
+  ComparePoints(point3_t::Zero(), trajectory.derivate(trajectory.max(), 1),
+                "TimeOptimalRetimingTest: wrong final velocity", error);
+  if (std::fabs(trajectory.max() - retiming.duration()) > 1e-10) {
+    error = true;
+    std::cout << "TimeOptimalRetimingTest: wrong duration of the trajectory" << std::endl;
+  }
+  double saturation = 0.;
+  for (int i = 0; i <= 1000; ++i) {
+    const pointX_t v = trajectory.derivate(trajectory.max() * i / 1000., 1);
+    saturation = std::max(saturation, (v.cwiseAbs().array() / max_vel.array()).maxCoeff());
+  }
+  // the velocity limits are respected, and reached since the path is long
+  if (saturation > 1.01 || saturation < 0.9) {
+    error = true;
+    std::cout << "TimeOptimalRetimingTest: wrong velocity of the trajectory " << saturation << std::endl;
+  }
+  for (long i = 0; i < retiming.accelerations().size(); ++i) {
+    const pointX_t acc = bc.derivate(retiming.grid()[i], 1) * retiming.accelerations()[i] +
+                         bc.derivate(retiming.grid()[i], 2) * retiming.squared_velocities()[i];
+    if (((acc.cwiseAbs() - max_acc).array() > 1e-6).any()) {
+      error = true;
+      std::cout << "TimeOptimalRetimingTest: acceleration limits violated at " << retiming.grid()[i] << std::endl;
+      break;
+    }
+  }
+  try {
+    retiming_t(bc_line, point3_t(1., 1., 1.), point3_t(1., 1., 1.), 100, 0., 10.);
+    error = true;
+    std::cout << "TimeOptimalRetimingTest: the final velocity exceeds the limits, an exception should be raised"
+              << std::endl;
+  } catch (std::runtime_error&) {
+  }
+}
+
+void CrossingTimesTest(bool& error) {
+  // first component (t - 0.5)(t - 1.2)(t - 2.7), second component (t - 1)^2 touching 0
+  t_pointX_t coeffs;
+  coeffs.push_back(point3_t(-1.62, 1., 0.));
+  coeffs.push_back(point3_t(5.19, -2., 0.));
+  coeffs.push_back(point3_t(-4.4, 1., 0.));
+  coeffs.push_back(point3_t(1., 0., 0.));
+  const polynomial_t pol(coeffs.begin(), coeffs.end(), 0., 3.);
+  std::vector<double> times;
+  crossing_times(pol, 0, 0., times);
+  if (times.size() != 3 || std::fabs(times[0] - 0.5) > 1e-9 || std::fabs(times[1] - 1.2) > 1e-9 ||
+      std::fabs(times[2] - 2.7) > 1e-9) {
+    error = true;
+    std::cout << "CrossingTimesTest: wrong roots of the polynomial" << std::endl;
+  }
+  times.clear();
+  crossing_times(pol, 1, 0., times);
+  if (times.size() != 1 || std::fabs(times[0] - 1.) > 1e-6) {
+    error = true;
+    std::cout << "CrossingTimesTest: the double root of the polynomial is not found" << std::endl;
+  }
+  times.clear();
+  crossing_times(pol, 2, 0., times);
+  crossing_times(pol, 1, -1., times);
+  if (!times.empty()) {
+    error = true;
+    std::cout << "CrossingTimesTest: no crossing expected" << std::endl;
+  }
+  // same curve as a bezier curve
+  const bezier_t bc = bezier_from_curve<bezier_t>(pol);
+  times.clear();
+  crossing_times(bc, 0, 0., times);
+  if (times.size() != 3 || std::fabs(times[0] - 0.5) > 1e-9 || std::fabs(times[1] - 1.2) > 1e-9 ||
+      std::fabs(times[2] - 2.7) > 1e-9) {
+    error = true;
+    std::cout << "CrossingTimesTest: wrong roots of the bezier curve" << std::endl;
+  }
+  // piecewise curve, compared to the sign changes of a dense sampling
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  params.front() = pol(3.);
+  const bezier_t bc1(params.begin(), params.end(), 3., 5.);
+  piecewise_t pc(boost::make_shared<polynomial_t>(pol));
+  pc.add_curve(bc1);
+  pc.add_curve(polynomial_t(bc1(5.), point3_t(1., 1., 1.), point3_t(3., 1., 2.), point3_t(0., 0., 0.), 5., 6.));
+  t_pair_point_tangent_t hermite_points;
+  hermite_points.push_back(pair_point_tangent_t(pc(6.), point3_t(0., 0., 0.)));
+  hermite_points.push_back(pair_point_tangent_t(point3_t(0., 1., -1.), point3_t(-1., 2., 0.5)));
+  hermite_points.push_back(pair_point_tangent_t(point3_t(1., -0.5, 0.6), point3_t(1., 0., -2.)));
+  std::vector<double> hermite_times;
+  hermite_times.push_back(6.);
+  hermite_times.push_back(6.5);
+  hermite_times.push_back(8.);
+  pc.add_curve(cubic_hermite_spline_t(hermite_points.begin(), hermite_points.end(), hermite_times));
+  for (std::size_t k = 0; k < 3; ++k) {
+    const double value = 0.3;
+    times.clear();
+    crossing_times(pc, k, value, times);
+    std::size_t num_changes = 0;
+    for (int i = 0; i < 80000; ++i) {
+      const double t0 = 8. * i / 80000., t1 = 8. * (i + 1) / 80000.;
+      if ((pc(t0)[k] - value) * (pc(t1)[k] - value) < 0) ++num_changes;
+    }
+    bool valid = times.size() == num_changes;
+    for (std::size_t i = 0; i < times.size(); ++i) valid = valid && std::fabs(pc(times[i])[k] - value) < 1e-8;
+    for (std::size_t i = 1; i < times.size(); ++i) valid = valid && times[i] > times[i - 1];
+    if (!valid) {
+      error = true;
+      std::cout << "CrossingTimesTest: wrong crossings of the piecewise curve along the axis " << k << " : "
+                << times.size() << " ; " << num_changes << std::endl;
+    }
+  }
+  // the crossing is in the second interval of a cubic hermite spline
+  hermite_points.clear();
+  hermite_times.clear();
+  for (int i = 0; i < 3; ++i) {
+    hermite_points.push_back(pair_point_tangent_t(point3_t(0., i, 0.), point3_t(0., 1., 0.)));
+    hermite_times.push_back(i);
+  }
+  const piecewise_t pc_hermite(
+      boost::make_shared<cubic_hermite_spline_t>(hermite_points.begin(), hermite_points.end(), hermite_times));
+  times.clear();
+  crossing_times(pc_hermite, 1, 1.5, times);
+  if (times.size() != 1 || std::fabs(times[0] - 1.5) > 1e-9) {
+    error = true;
+    std::cout << "CrossingTimesTest: wrong crossing of the cubic hermite spline" << std::endl;
+  }
+  // the other segments can not be solved exactly
+  const piecewise_t pc_bspline(
+      boost::make_shared<bspline_curve<double, double, true, pointX_t> >(params.begin(), params.end(), 3, 0., 1.));
+  try {
+    crossing_times(pc_bspline, 0, 0.3, times);
+    error = true;
+    std::cout << "CrossingTimesTest: an unsupported segment should raise an invalid_argument error" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+template <typename Curve>
+void CheckExtrema(const Curve& curve, const std::string& name, bool& error) {
+  const limits_summary<> limits(curve, 2);
+  for (std::size_t order = 0; order <= 2; ++order) {
+    bounding_box<> sampled;
+    for (int i = 0; i <= 20000; ++i) {
+      const double t = std::min(curve.min() + (curve.max() - curve.min()) * i / 20000., curve.max());
+      sampled.extend(order == 0 ? curve(t) : curve.derivate(t, order));
+    }
+    const bounding_box<>& box = limits.bounds(order);
+    if (!box.contains(sampled, 1e-9) || !sampled.isApprox(box, 2e-2) || !box.isApprox(extrema(curve, order))) {
+      error = true;
+      std::cout << "ExtremaTest: wrong extrema of the " << name << " at order " << order << " : "
+                << box.min_.transpose() << " ; " << box.max_.transpose() << " sampled : " << sampled.min_.transpose()
+                << " ; " << sampled.max_.transpose() << std::endl;
+    }
+  }
+}
+
+void ExtremaTest(bool& error) {
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  const bezier_t bc(params.begin(), params.end(), 1., 3.);
+  CheckExtrema(bc, "bezier curve", error);
+  const polynomial_t pol(params.begin(), params.end(), 0., 1.5);
+  CheckExtrema(pol, "polynomial", error);
+  t_pair_point_tangent_t control_points;
+  std::vector<double> time_control_points;
+  for (std::size_t i = 0; i + 1 < params.size(); ++i) {
+    control_points.push_back(pair_point_tangent_t(params[i], params[i + 1] - params[i]));
+    time_control_points.push_back((double)i * 0.7);
+  }
+  const cubic_hermite_spline_t chs(control_points.begin(), control_points.end(), time_control_points);
+  CheckExtrema(chs, "cubic hermite spline", error);
+  piecewise_t pc(boost::make_shared<bezier_t>(bc));
+  pc.add_curve(polynomial_t(bc(3.), point3_t(1., 1., 1.), point3_t(3., 1., 2.), point3_t(0., 0., 0.), 3., 4.));
+  CheckExtrema(pc, "piecewise curve", error);
+  const limits_summary<> limits(pc);
+  if (!limits.satisfies(1, limits.max_abs(1)) || limits.satisfies(1, limits.max_abs(1) * 0.99) ||
+      !limits.satisfies(0, limits.bounds(0).min_, limits.bounds(0).max_) || limits.max_order() != 2) {
+    error = true;
+    std::cout << "ExtremaTest: wrong limits check" << std::endl;
+  }
+}
+
+void LeastSquaresFittingTest(bool& error) {
+  typedef least_squares_fitter<pointX_t, double> fitter_t;
+  // the samples of a cubic bezier curve are fitted exactly by two C2 cubic segments
+  t_pointX_t params = ControlPolygon<t_pointX_t>(4);
+  const bezier_t bc(params.begin(), params.end(), 0., 2.);
+  problem_definition<pointX_t, double> pDef(3);
+  pDef.degree = 3;
+  pDef.totalTime = 2.;
+  pDef.splitTimes_ = Eigen::VectorXd::Constant(1, 0.8);
+  std::vector<double> times;
+  t_pointX_t points;
+  for (int i = 0; i <= 100000; ++i) {
+    times.push_back(2. * i / 100000.);
+    points.push_back(bc(times.back()));
+  }
+  fitter_t fitter(pDef, 2), sequential(pDef, 2), merged(pDef, 2);
+  fitter.add_samples(times, points, 4);
+  fitter_t half(pDef, 2);
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    sequential.add_sample(times[i], points[i]);
+    if (i % 2 == 0)
+      merged.add_sample(times[i], points[i]);
+    else
+      half.add_sample(times[i], points[i]);
+  }
+  merged.merge(half);
+  const fitter_t::piecewise_curve_t pc = fitter.solve();
+  const fitter_t::piecewise_curve_t pc_sequential = sequential.solve(), pc_merged = merged.solve();
+  if (fitter.num_samples() != times.size() || merged.num_samples() != times.size() || pc.num_curves() != 2) {
+    error = true;
+    std::cout << "LeastSquaresFittingTest: wrong number of samples or segments" << std::endl;
+  }
+  for (int i = 0; i <= 10; ++i) {
+    ComparePoints(bc(0.2 * i), pc(0.2 * i), "LeastSquaresFittingTest: wrong fit of the bezier curve", error, 1e-8);
+    ComparePoints(pc(0.2 * i), pc_sequential(0.2 * i), "LeastSquaresFittingTest: wrong sequential fit", error, 1e-8);
+    ComparePoints(pc(0.2 * i), pc_merged(0.2 * i), "LeastSquaresFittingTest: wrong merged fit", error, 1e-8);
+  }
+  // approximation of a sine by C1 quintic segments with constraints on the ends
+  pDef.degree = 5;
+  pDef.totalTime = 3.;
+  pDef.splitTimes_ = Eigen::Vector2d(1., 2.);
+  pDef.flag = constraint_flag(INIT_POS | INIT_VEL | END_POS | END_ACC);
+  pDef.init_pos = point3_t(0., 1., 0.);
+  pDef.init_vel = point3_t(1., 0., 0.5);
+  pDef.end_pos = point3_t(0.1, -1., 1.);
+  pDef.end_acc = point3_t(0., 1., 0.);
+  fitter_t sine(pDef, 1), weighted(pDef, 1);
+  std::vector<double> weights;
+  times.clear();
+  points.clear();
+  for (int i = 0; i <= 30000; ++i) {
+    const double t = 3. * i / 30000.;
+    sine.add_sample(t, point3_t(std::sin(t), std::cos(t), t / 3.), 1. + t);
+    times.push_back(t);
+    points.push_back(point3_t(std::sin(t), std::cos(t), t / 3.));
+    weights.push_back(1. + t);
+  }
+  weighted.add_samples(times, points, weights, 3);
+  fitter_t::piecewise_curve_t pc_sine = sine.solve(), pc_weighted = weighted.solve();
+  for (int i = 0; i <= 10; ++i)
+    ComparePoints(pc_sine(0.3 * i), pc_weighted(0.3 * i), "LeastSquaresFittingTest: wrong weighted fit", error, 1e-8);
+  ComparePoints(pDef.init_pos, pc_sine(0.), "LeastSquaresFittingTest: wrong initial position", error, 1e-8);
+  ComparePoints(pDef.init_vel, pc_sine.derivate(0., 1), "LeastSquaresFittingTest: wrong initial velocity", error,
+                1e-8);
+  ComparePoints(pDef.end_pos, pc_sine(3.), "LeastSquaresFittingTest: wrong final position", error, 1e-8);
+  ComparePoints(pDef.end_acc, pc_sine.derivate(3., 2), "LeastSquaresFittingTest: wrong final acceleration", error,
+                1e-8);
+  if (!pc_sine.is_continuous(1) || std::fabs(pc_sine(1.5)[0] - std::sin(1.5)) > 0.05) {
+    error = true;
+    std::cout << "LeastSquaresFittingTest: wrong approximation of the sine" << std::endl;
+  }
+  try {
+    fitter_t(pDef, 1).solve();
+    error = true;
+    std::cout << "LeastSquaresFittingTest: no samples were added, an exception should be raised" << std::endl;
+  } catch (std::runtime_error&) {
+  }
+}
+
+void SimplificationTest(bool& error) {
+  t_pointX_t params = ControlPolygon<t_pointX_t>(4);
+  const bezier_t bc(params.begin(), params.end(), 0., 2.);
+  // a cubic curve split in many segments is simplified in a single segment
+  const bezier_t::piecewise_curve_t split = bc.split(Eigen::VectorXd::LinSpaced(49, 0.04, 1.96));
+  const simplification_result<bezier_t> single = simplify<bezier_t>(split);
+  if (single.curve.num_curves() != 1 || single.position_error > 1e-10) {
+    error = true;
+    std::cout << "SimplificationTest: the cubic curve should be simplified in one segment, "
+              << single.curve.num_curves() << " ; " << single.position_error << std::endl;
+  }
+  // quintic curve approximated by cubic segments
+  params.push_back(point3_t(1., -2., 0.5));
+  params.push_back(point3_t(-2., 1., 3.));
+  const bezier_t bc5(params.begin(), params.end(), 1., 4.);
+  simplification_settings<> settings;
+  settings.tolerance = 1e-3;
+  settings.velocity_tolerance = 1e-2;
+  simplification_result<bezier_t> res = simplify<bezier_t>(bc5, settings);
+  double position_error = 0., velocity_error = 0.;
+  for (int i = 0; i <= 3000; ++i) {
+    const double t = 1. + 3. * i / 3000.;
+    position_error = std::max(position_error, (res.curve(t) - bc5(t)).norm());
+    velocity_error = std::max(velocity_error, (res.curve.derivate(t, 1) - bc5.derivate(t, 1)).norm());
+  }
+  if (res.position_error > settings.tolerance || res.velocity_error > settings.velocity_tolerance ||
+      position_error > 1.5 * settings.tolerance || velocity_error > 1.5 * settings.velocity_tolerance ||
+      res.curve.num_curves() < 2 || res.curve.num_curves() > 30 || !res.curve.is_continuous(1) ||
+      std::fabs(res.curve.min() - 1.) > 1e-12 || std::fabs(res.curve.max() - 4.) > 1e-12) {
+    error = true;
+    std::cout << "SimplificationTest: wrong simplification of the quintic curve, " << res.curve.num_curves()
+              << " segments, error " << position_error << " ; " << velocity_error << std::endl;
+  }
+  // a lower tolerance gives more segments
+  settings.velocity_tolerance = std::numeric_limits<double>::infinity();
+  settings.continuity = 0;
+  const simplification_result<bezier_t> coarse = simplify<bezier_t>(bc5, settings);
+  settings.tolerance = 1e-5;
+  simplification_result<bezier_t> fine = simplify<bezier_t>(bc5, settings);
+  if (fine.curve.num_curves() <= coarse.curve.num_curves() || fine.position_error > 1e-5 ||
+      coarse.velocity_error != 0. || !fine.curve.is_continuous(0)) {
+    error = true;
+    std::cout << "SimplificationTest: wrong number of segments for the tolerances" << std::endl;
+  }
+  // t (t - 1) (t - 2) (t - 3) is null on the 4 samples of [0, 3], the deviation is found between them
+  t_pointX_t coeffs;
+  coeffs.push_back(point3_t(0., 0., 0.));
+  coeffs.push_back(point3_t(-6., 0., 0.));
+  coeffs.push_back(point3_t(11., 0., 0.));
+  coeffs.push_back(point3_t(-6., 0., 0.));
+  coeffs.push_back(point3_t(1., 0., 0.));
+  const polynomial_t pol(coeffs.begin(), coeffs.end(), 0., 3.);
+  settings = simplification_settings<>();
+  settings.degree = 1;
+  settings.samples = 4;
+  settings.tolerance = 0.1;
+  double staggered_error, staggered_velocity_error;
+  internal::fit_segment<bezier_t>(pol, 0., 3., settings, staggered_error, staggered_velocity_error);
+  const simplification_result<bezier_t> staggered = simplify<bezier_t>(pol, settings);
+  position_error = 0.;
+  for (int i = 0; i <= 3000; ++i)
+    position_error = std::max(position_error, (staggered.curve(i / 1000.) - pol(i / 1000.)).norm());
+  if (staggered_error < 0.9 || position_error > 2 * settings.tolerance) {
+    error = true;
+    std::cout << "SimplificationTest: the deviation between the samples is not checked, error " << staggered_error
+              << " ; " << position_error << std::endl;
+  }
+}
+
+void BSplineTest(bool& error) {
+  typedef bspline_curve<double, double, true, pointX_t> bspline_t;
+  t_pointX_t params = ControlPolygon<t_pointX_t>(7);
+  // uniform knots evaluated with the basis matrix, compared to de Boor on slightly perturbed knots
+  const bspline_t uniform(params.begin(), params.end(), 3, 1., 3.);
+  std::vector<double> knots = uniform.knots();
+  knots.front() -= 1e-9;
+  knots.back() += 1e-9;
+  const bspline_t perturbed(params.begin(), params.end(), knots, 3);
+  if (!uniform.is_uniform() || perturbed.is_uniform() || uniform.degree() != 3 || uniform.dim() != 3 ||
+      std::fabs(uniform.min() - 1.) > 1e-12 || std::fabs(uniform.max() - 3.) > 1e-12) {
+    error = true;
+    std::cout << "BSplineTest: wrong construction of the uniform curve" << std::endl;
+  }
+  const bspline_t d1 = uniform.compute_derivate(1), d2 = uniform.compute_derivate(2);
+  for (int i = 0; i <= 40; ++i) {
+    const double t = 1. + 2. * i / 40.;
+    for (std::size_t order = 0; order <= 4; ++order)
+      ComparePoints(perturbed.derivate(t, order), uniform.derivate(t, order),
+                    "BSplineTest: the basis matrix and de Boor differ ", error, 1e-6);
+    ComparePoints(uniform.derivate(t, 1), d1(t), "BSplineTest: wrong first derivative ", error, 1e-9);
+    ComparePoints(uniform.derivate(t, 2), d2(t), "BSplineTest: wrong second derivative ", error, 1e-9);
+    ComparePoints(perturbed.derivate(t, 2), perturbed.compute_derivate(2)(t), "BSplineTest: wrong derivative ",
+                  error, 1e-9);
+  }
+  // a clamped curve interpolates its first and last control points
+  const bspline_t clamped = bspline_t::clamped(params.begin(), params.end(), 3, 0., 2.);
+  ComparePoints(params.front(), clamped(0.), "BSplineTest: the clamped curve does not start at P0 ", error);
+  ComparePoints(params.back(), clamped(2.), "BSplineTest: the clamped curve does not end at Pn ", error);
+  ComparePoints((params[1] - params[0]) * 3. / 0.5, clamped.derivate(0., 1),
+                "BSplineTest: wrong initial velocity of the clamped curve ", error);
+  // knot insertion and conversion keep the curve unchanged
+  bspline_t inserted(clamped);
+  inserted.insert_knot(0.3);
+  inserted.insert_knot(0.3);
+  inserted.insert_knot(1.5);
+  bspline_t::piecewise_bezier_t pc_clamped = clamped.convert_to_piecewise_bezier();
+  bspline_t::piecewise_bezier_t pc_uniform = uniform.convert_to_piecewise_bezier();
+  if (inserted.control_points().size() != params.size() + 3 || pc_clamped.num_curves() != 4 ||
+      pc_uniform.num_curves() != 4 || !pc_clamped.is_continuous(2) || !pc_uniform.is_continuous(2)) {
+    error = true;
+    std::cout << "BSplineTest: wrong number of control points or segments" << std::endl;
+  }
+  for (int i = 0; i <= 40; ++i) {
+    const double t = 2. * i / 40.;
+    ComparePoints(clamped(t), inserted(t), "BSplineTest: the knot insertion changed the curve ", error, 1e-9);
+    ComparePoints(clamped.derivate(t, 1), inserted.derivate(t, 1),
+                  "BSplineTest: the knot insertion changed the derivative ", error, 1e-9);
+    ComparePoints(clamped(t), pc_clamped(t), "BSplineTest: wrong conversion of the clamped curve ", error, 1e-9);
+    ComparePoints(uniform(1. + t), pc_uniform(1. + t), "BSplineTest: wrong conversion of the uniform curve ", error,
+                  1e-9);
+  }
+  // degree 0, piecewise constant curve
+  const bspline_t constant(params.begin(), params.begin() + 3, 0, 0., 3.);
+  ComparePoints(params[1], constant(1.5), "BSplineTest: wrong piecewise constant curve ", error);
+  ComparePoints(params[2], constant(3.), "BSplineTest: wrong end of the piecewise constant curve ", error);
+  if (constant.convert_to_piecewise_bezier().num_curves() != 3) {
+    error = true;
+    std::cout << "BSplineTest: wrong conversion of the piecewise constant curve" << std::endl;
+  }
+  // errors
+  try {
+    bspline_t(params.begin(), params.end(), knots, 2);
+    error = true;
+    std::cout << "BSplineTest: the number of knots should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  try {
+    inserted.insert_knot(3.);
+    error = true;
+    std::cout << "BSplineTest: the inserted knot should be in the time range" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+void ControlPointEditTest(bool& error) {
+  t_pointX_t params = ControlPolygon<t_pointX_t>(6);
+  // the cached bounds are extended or recomputed
+  bezier_t bc(params.begin(), params.end(), 0., 3.);
+  bc.bounds();
+  params[2] = point3_t(0.5, 0.5, 0.5);
+  bc.set_control_point(2, params[2]);
+  params[1] = point3_t(5., -3., 6.);
+  bc.set_control_point(1, params[1]);
+  const bezier_t expected(params.begin(), params.end(), 0., 3.);
+  if (!bc.isApprox(expected) || !bc.bounds().isApprox(expected.bounds())) {
+    error = true;
+    std::cout << "ControlPointEditTest: wrong curve or bounds after the modification of the control points"
+              << std::endl;
+  }
+  bc.set_control_point(1, point3_t(0.1, 0.1, 0.1));
+  bc.set_control_point(2, point3_t(0.2, 0.2, 0.2));
+  params[1] = point3_t(0.1, 0.1, 0.1);
+  params[2] = point3_t(0.2, 0.2, 0.2);
+  if (!bc.bounds().isApprox(bezier_t(params.begin(), params.end(), 0., 3.).bounds())) {
+    error = true;
+    std::cout << "ControlPointEditTest: the bounds should be computed again" << std::endl;
+  }
+  polynomial_t pol = polynomial_from_curve<polynomial_t>(expected);
+  pol.set_coefficient(3, point3_t(1., 2., 3.));
+  Eigen::MatrixXd coefficients = polynomial_from_curve<polynomial_t>(expected).coeff();
+  coefficients.col(3) = point3_t(1., 2., 3.);
+  if (!pol.isApprox(polynomial_t(coefficients, 0., 3.))) {
+    error = true;
+    std::cout << "ControlPointEditTest: wrong coefficients of the polynomial" << std::endl;
+  }
+  // piecewise curves of quintic segments, continuous up to order 2 after the modification of a segment
+  bezier_t::piecewise_curve_t pc = expected.split(Eigen::Vector2d(1., 2.));
+  const bezier_t::piecewise_curve_t copy(pc);
+  pc.set_control_point(1, 1, point3_t(4., 4., 4.), 2);
+  pc.set_control_point(1, 4, point3_t(-4., 0., 1.), 2);
+  bool continuous = pc.is_continuous(0) && pc.is_continuous(1) && pc.is_continuous(2);
+  for (std::size_t order = 0; order <= 2; ++order) {
+    ComparePoints(expected.derivate(0., order), pc.derivate(0., order),
+                  "ControlPointEditTest: the start of the curve should not change ", error);
+    ComparePoints(expected.derivate(3., order), pc.derivate(3., order),
+                  "ControlPointEditTest: the end of the curve should not change ", error);
+  }
+  ComparePoints(point3_t(4., 4., 4.), pc.curve_at_index(1)->waypoints()[1],
+                "ControlPointEditTest: the control point is not set ", error);
+  ComparePoints(expected(1.5), copy(1.5), "ControlPointEditTest: the copy of the curve should not change ", error);
+  piecewise_t pc_pol;
+  for (std::size_t i = 0; i < copy.num_curves(); ++i)
+    pc_pol.add_curve(polynomial_from_curve<polynomial_t>(*copy.curve_at_index(i)));
+  pc_pol.set_coefficient(1, 2, point3_t(3., -2., 1.), 1);
+  continuous = continuous && pc_pol.is_continuous(0) && pc_pol.is_continuous(1) && !pc_pol.is_continuous(2);
+  pc_pol.set_coefficient(1, 5, point3_t(1., 1., 1.), 2);
+  continuous = continuous && pc_pol.is_continuous(2);
+  for (std::size_t order = 0; order <= 2; ++order)
+    ComparePoints(copy.derivate(0., order), pc_pol.derivate(0., order),
+                  "ControlPointEditTest: the start of the first polynomial should not change ", error);
+  if (!continuous) {
+    error = true;
+    std::cout << "ControlPointEditTest: the continuity is not enforced" << std::endl;
+  }
+  // errors
+  try {
+    pc_pol.set_control_point(1, 1, point3_t(4., 4., 4.));
+    error = true;
+    std::cout << "ControlPointEditTest: the type of the segment should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  try {
+    pc.set_control_point(1, 1, point3_t(4., 4., 4.), 3);
+    error = true;
+    std::cout << "ControlPointEditTest: the degree of the neighbours should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
+void FlatBinaryTest(bool& error) {
+  using namespace curves::serialization;
+  t_pointX_t params = ControlPolygon<t_pointX_t>(5);
+  const bezier_t bc(params.begin(), params.end(), 0., 2., 0.5);
+  const polynomial_t pol(bc(2.), bc.derivate(2., 1), point3_t(1., 1., 1.), point3_t(0., 2., 0.), 2., 3.);
+  t_pair_point_tangent_t control_points;
+  control_points.push_back(pair_point_tangent_t(point3_t(1., 1., 1.), point3_t(0., 2., 0.)));
+  control_points.push_back(pair_point_tangent_t(point3_t(0., 1., 4.), point3_t(1., 0., -1.)));
+  std::vector<double> time_control_points;
+  time_control_points.push_back(3.);
+  time_control_points.push_back(4.5);
+  piecewise_t pc;
+  pc.add_curve(bc);
+  pc.add_curve(pol);
+  pc.add_curve(cubic_hermite_spline_t(control_points.begin(), control_points.end(), time_control_points));
+  // evaluation in place in a buffer and in a memory mapped file
+  const std::vector<char> buffer = to_flat_binary(pc);
+  const flat_curve_view view(&buffer[0], buffer.size());
+  save_flat_binary(pc, "fileTest.flat");
+  const flat_curve_file file("fileTest.flat");
+  if (view.num_segments() != 3 || view.dim() != 3 || view.version() != FLAT_BINARY_VERSION ||
+      view.segment_basis(0) != FLAT_BEZIER || view.segment_basis(2) != FLAT_POLYNOMIAL ||
+      view.segment_degree(0) != 4 || view.segment_degree(1) != 3 || file.view().num_segments() != 3 ||
+      std::fabs(view.min()) > 1e-12 || std::fabs(view.max() - 4.5) > 1e-12 ||
+      std::fabs(view.segment_max(1) - 3.) > 1e-12) {
+    error = true;
+    std::cout << "FlatBinaryTest: wrong header of the flat binary format" << std::endl;
+  }
+  // cubic_hermite_spline returns null second and third derivatives at its end time
+  for (int i = 0; i < 45; ++i) {
+    const double t = 0.1 * i;
+    for (std::size_t order = 0; order <= 5; ++order) {
+      ComparePoints(pc.derivate(t, order), view.derivate(t, order), "FlatBinaryTest: wrong evaluation of the view ",
+                    error, 1e-9);
+      ComparePoints(pc.derivate(t, order), file.view().derivate(t, order),
+                    "FlatBinaryTest: wrong evaluation of the mapped file ", error, 1e-9);
+    }
+  }
+  // conversions to and from the boost archives
+  piecewise_t converted = view.to_piecewise<piecewise_t>();
+  convert_flat_to_binary<piecewise_t>("fileTest.flat", "fileTest");
+  piecewise_t loaded;
+  loaded.loadFromBinary<piecewise_t>("fileTest");
+  convert_binary_to_flat<piecewise_t>("fileTest", "fileTest.flat");
+  const flat_curve_file reconverted("fileTest.flat");
+  for (int i = 0; i <= 45; ++i) {
+    const double t = 0.1 * i;
+    ComparePoints(pc(t), converted(t), "FlatBinaryTest: wrong conversion to a piecewise curve ", error, 1e-9);
+    ComparePoints(pc(t), loaded(t), "FlatBinaryTest: wrong conversion to a binary archive ", error, 1e-9);
+    ComparePoints(pc(t), reconverted.view()(t), "FlatBinaryTest: wrong conversion from a binary archive ", error, 1e-9);
+  }
+  // errors
+  std::vector<char> wrong(buffer);
+  wrong[0] = 'X';
+  try {
+    flat_curve_view(&wrong[0], wrong.size());
+    error = true;
+    std::cout << "FlatBinaryTest: the magic number should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  try {
+    flat_curve_view(&buffer[0], buffer.size() - 8);
+    error = true;
+    std::cout << "FlatBinaryTest: the size of the buffer should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  // dim * num_columns * 8 overflows
+  wrong = buffer;
+  reinterpret_cast<flat_header*>(&wrong[0])->num_columns = (boost::uint64_t)1 << 62;
+  try {
+    flat_curve_view(&wrong[0], wrong.size());
+    error = true;
+    std::cout << "FlatBinaryTest: the number of columns should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  // the records of the segments are checked when they are used
+  wrong = buffer;
+  const std::size_t segments_offset = reinterpret_cast<const flat_header*>(&wrong[0])->segments_offset;
+  flat_segment* records = reinterpret_cast<flat_segment*>(&wrong[segments_offset]);
+  records[0].degree = 1000;
+  records[1].basis = 7;
+  const flat_curve_view corrupted(&wrong[0], wrong.size());
+  try {
+    corrupted(0.5);
+    error = true;
+    std::cout << "FlatBinaryTest: the degree of the segment should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  try {
+    corrupted.segment_basis(1);
+    error = true;
+    std::cout << "FlatBinaryTest: the basis of the segment should be checked" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+  ComparePoints(pc(4.), corrupted(4.), "FlatBinaryTest: wrong evaluation of a valid segment ", error, 1e-9);
+  // each interval of a cubic hermite spline is stored as a polynomial
+  control_points.clear();
+  control_points.push_back(pair_point_tangent_t(point3_t(0., 0., 0.), point3_t(1., 0., 0.)));
+  control_points.push_back(pair_point_tangent_t(point3_t(1., 1., 0.), point3_t(0., 1., 2.)));
+  control_points.push_back(pair_point_tangent_t(point3_t(0., 2., 0.), point3_t(-1., 0., 0.)));
+  time_control_points.clear();
+  time_control_points.push_back(0.);
+  time_control_points.push_back(1.);
+  time_control_points.push_back(2.);
+  const piecewise_t pc_hermite(boost::make_shared<cubic_hermite_spline_t>(control_points.begin(),
+                                                                          control_points.end(), time_control_points));
+  const std::vector<char> hermite_buffer = to_flat_binary(pc_hermite);
+  const flat_curve_view hermite_view(&hermite_buffer[0], hermite_buffer.size());
+  if (hermite_view.num_segments() != 2) {
+    error = true;
+    std::cout << "FlatBinaryTest: each interval of the cubic hermite spline should be a segment" << std::endl;
+  }
+  for (int i = 0; i <= 20; ++i) {
+    const double t = 0.1 * i;
+    ComparePoints(pc_hermite(t), hermite_view(t), "FlatBinaryTest: wrong evaluation of the cubic hermite spline ",
+                  error, 1e-9);
+    ComparePoints(pc_hermite.derivate(t, 1), hermite_view.derivate(t, 1),
+                  "FlatBinaryTest: wrong velocity of the cubic hermite spline ", error, 1e-9);
+  }
+  // the other segments can not be stored exactly
+  const piecewise_t pc_bspline(
+      boost::make_shared<bspline_curve<double, double, true, pointX_t> >(params.begin(), params.end(), 3, 0., 1.));
+  try {
+    to_flat_binary(pc_bspline);
+    error = true;
+    std::cout << "FlatBinaryTest: an unsupported segment should raise an invalid_argument error" << std::endl;
+  } catch (std::invalid_argument&) {
+  }
+}
+
 void testOperatorEqual(bool& error) {
   // test with a C2 polynomial :
   pointX_t zeros = point3_t(0., 0., 0.);
@@ -2697,7 +4383,9 @@ int main(int /*argc*/, char** /*argv[]*/) {
   EffectorSplineRotationNoRotationTest(error);
   EffectorSplineRotationRotationTest(error);
   TestReparametrization(error);
+  RotationSplineDerivateTest(error);
   EffectorSplineRotationWayPointRotationTest(error);
+  EffectorSplineBatchTest(error);
   BezierCurveTest(error);
   BezierDerivativeCurveTest(error);
   BezierDerivativeCurveConstraintTest(error);
@@ -2716,12 +4404,37 @@ int main(int /*argc*/, char** /*argv[]*/) {
   so3LinearTest(error);
   SO3serializationTest(error);
   se3CurveTest(error);
+  se3CurveEvaluationTest(error);
+  se3CurveTypedTest(error);
   Se3serializationTest(error);
+  linearVariableFusedOperationsTest(error);
   BezierLinearProblemsetup_control_pointsNoConstraint(error);
   BezierLinearProblemsetup_control_pointsVarCombinatorialInit(error);
   BezierLinearProblemsetup_control_pointsVarCombinatorialEnd(error);
   BezierLinearProblemsetup_control_pointsVarCombinatorialMix(error);
   BezierLinearProblemsetupLoadProblem(error);
+  BezierLinearProblemSparseTest(error);
+  BezierLinearProblemSplitTest(error);
+  BezierProductTest(error);
+  IntegralCostCacheTest(error);
+  SparseQuadraticProblemTest(error);
+  QPSolverTest(error);
+  QPSolverBenchmark(error);
+  RecedingHorizonProblemTest(error);
+  BatchGenerateProblemsTest(error);
+  ProblemDerivativesTest(error);
+  SplineOptimizerTest(error);
+  BoundingBoxTest(error);
+  ClosestPointTest(error);
+  ArcLengthTest(error);
+  TimeOptimalRetimingTest(error);
+  LeastSquaresFittingTest(error);
+  CrossingTimesTest(error);
+  ExtremaTest(error);
+  SimplificationTest(error);
+  BSplineTest(error);
+  ControlPointEditTest(error);
+  FlatBinaryTest(error);
   testOperatorEqual(error);
 
   if (error) {